@@ -92,11 +92,16 @@
 #include "mxconstants.h"
 #include "stm32f746xx.h"
 extern uint32_t SystemCoreClock;
+void configureTimerForRuntimestats();
+uint32_t timeBaseGetRunTimeCounter();
+void systemInfoTaskSwitchedIn(uint32_t taskNumber);
+void systemInfoTaskSwitchedOut(uint32_t taskNumber);
+#include "traceRecorder.h"
 #endif
 
 #define configUSE_PREEMPTION                     1
 #define configUSE_IDLE_HOOK                      0
-#define configUSE_TICK_HOOK                      0
+#define configUSE_TICK_HOOK                      1
 #define configCPU_CLOCK_HZ                       ( SystemCoreClock )
 #define configTICK_RATE_HZ                       ((TickType_t)1000)
 #define configMAX_PRIORITIES                     ( 7 )
@@ -110,7 +115,7 @@ extern uint32_t SystemCoreClock;
 #define configGENERATE_RUN_TIME_STATS     		 1
 #define configUSE_STATS_FORMATTING_FUNCTIONS	 1
 #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() configureTimerForRuntimestats()
-#define portGET_RUN_TIME_COUNTER_VALUE()	     getTimVal()
+#define portGET_RUN_TIME_COUNTER_VALUE()	     timeBaseGetRunTimeCounter()
 
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES                    0
@@ -169,6 +174,29 @@ extern uint32_t SystemCoreClock;
 
 /* USER CODE BEGIN Defines */
 /* Section where parameter definitions can be added (for instance, to override default ones in FreeRTOS.h) */
+/* Context switches and run time counted for the task profiler and written to the trace (pxCurrentTCB is visible in tasks.c) */
+#define traceTASK_SWITCHED_IN() do { \
+	systemInfoTaskSwitchedIn(pxCurrentTCB->uxTCBNumber); \
+	traceRecorderWrite(TRACE_EVENT_TASK_SWITCHED_IN, pxCurrentTCB->uxTCBNumber, pxCurrentTCB); \
+} while (0)
+#define traceTASK_SWITCHED_OUT() do { \
+	systemInfoTaskSwitchedOut(pxCurrentTCB->uxTCBNumber); \
+	traceRecorderWrite(TRACE_EVENT_TASK_SWITCHED_OUT, pxCurrentTCB->uxTCBNumber, pxCurrentTCB); \
+} while (0)
+/* Names of tasks and registered queues sent with the trace */
+#define traceTASK_CREATE(pxNewTCB) traceRecorderRegisterObject(TRACE_OBJECT_TASK, pxNewTCB, pxNewTCB->uxTCBNumber, pxNewTCB->pcTaskName)
+#define traceQUEUE_REGISTRY_ADD(xQueue, pcQueueName) traceRecorderRegisterObject(TRACE_OBJECT_QUEUE, xQueue, ((Queue_t*) xQueue)->ucQueueType, pcQueueName)
+/* Queue, semaphore and mutex operations (Queue_t is visible in queue.c) */
+#define traceQUEUE_SEND(pxQueue) traceRecorderWrite(TRACE_EVENT_QUEUE_SEND, pxQueue->ucQueueType, pxQueue)
+#define traceQUEUE_SEND_FAILED(pxQueue) traceRecorderWrite(TRACE_EVENT_QUEUE_SEND_FAILED, pxQueue->ucQueueType, pxQueue)
+#define traceQUEUE_SEND_FROM_ISR(pxQueue) traceRecorderWrite(TRACE_EVENT_QUEUE_SEND, pxQueue->ucQueueType, pxQueue)
+#define traceQUEUE_SEND_FROM_ISR_FAILED(pxQueue) traceRecorderWrite(TRACE_EVENT_QUEUE_SEND_FAILED, pxQueue->ucQueueType, pxQueue)
+#define traceQUEUE_RECEIVE(pxQueue) traceRecorderWrite(TRACE_EVENT_QUEUE_RECEIVE, pxQueue->ucQueueType, pxQueue)
+#define traceQUEUE_RECEIVE_FAILED(pxQueue) traceRecorderWrite(TRACE_EVENT_QUEUE_RECEIVE_FAILED, pxQueue->ucQueueType, pxQueue)
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue) traceRecorderWrite(TRACE_EVENT_QUEUE_RECEIVE, pxQueue->ucQueueType, pxQueue)
+#define traceQUEUE_RECEIVE_FROM_ISR_FAILED(pxQueue) traceRecorderWrite(TRACE_EVENT_QUEUE_RECEIVE_FAILED, pxQueue->ucQueueType, pxQueue)
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue) traceRecorderWrite(TRACE_EVENT_QUEUE_BLOCK_SEND, pxQueue->ucQueueType, pxQueue)
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue) traceRecorderWrite(TRACE_EVENT_QUEUE_BLOCK_RECEIVE, pxQueue->ucQueueType, pxQueue)
 /* USER CODE END Defines */
 
 #endif /* FREERTOS_CONFIG_H */
@@ -12,6 +12,7 @@
 #include "stdlib.h"
 #include "lcdLogger.h"
 #include "arm_math.h"
+#include "timeBase.h"
 
 /**
  * @def AUDIO_RECORDER_INPUT_MICROPHONE
@@ -50,6 +51,12 @@
  */
 #define AUDIO_RECORDER_VOLUME_0DB ((uint32_t)80)
 
+/**
+ * @def AUDIO_RECORDER_SAI_STOP_TIMEOUT
+ * @brief Maximum time of waiting for the SAI blocks to stop at the end of frame [us]
+ */
+#define AUDIO_RECORDER_SAI_STOP_TIMEOUT 1000
+
 /**
  * @def audioRecorder_FullBufferFilled
  * @brief The name of full buffer filled callback (function).
@@ -70,6 +77,7 @@ typedef struct {
 	uint16_t soundBuffer[SOUND_MAIL_MAX_BUFFER_SIZE];
 	uint32_t soundBufferSize;
 	uint32_t frequency;
+	uint64_t timestamp;
 } SoundMailStr;
 
 
@@ -83,8 +91,22 @@ typedef struct {
 	uint32_t size;
 	uint32_t frequency;
 	uint32_t iterator;
+	uint32_t filled;
+	uint64_t timestamp;
 } SoundBufferStr;
 
+/**
+ * @brief Statistics of the sampling rate changes done without the codec restart
+ */
+typedef struct {
+	uint32_t switches;
+	uint32_t failures;
+	uint32_t lastGapUs;
+	uint32_t maxGapUs;
+	uint32_t discardedBuffers;
+	uint32_t bufferFlushes;
+} AudioRateSwitchStatsStr;
+
 /**
  * @brief Signal window type
  */
@@ -100,6 +122,10 @@ uint8_t audioRecorderInit(uint16_t inputDevice, uint8_t volume, uint32_t audioFr
 uint8_t audioRecorderStartRecording(uint16_t* audioBuffer, uint32_t audioBufferSize);
 uint8_t audioRecorderSetVolume(uint8_t volume);
 uint8_t audioRecorderSetSamplingFrequency(uint32_t frequency);
+uint8_t audioRecorderSwitchSamplingFrequency(uint32_t frequency);
+uint32_t audioRecorderGetSamplingFrequency();
+uint8_t audioRecorderIsRateBoundary();
+void audioRecorderGetRateSwitchStats(AudioRateSwitchStatsStr* stats);
 
 void audioRecordingUpdateSoundBuffer(SoundBufferStr* soundBuffer, SoundMailStr* soundMail);
 void audioRecordingSoundMailFill(SoundMailStr* soundStructure, uint16_t* audioBuffer, uint32_t audioBufferSize, uint32_t frequency);
@@ -0,0 +1,104 @@
+/*
+ * bandAnalysis.h
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#ifndef BANDANALYSIS_H_
+#define BANDANALYSIS_H_
+
+#include "stdint.h"
+#include "math.h"
+#include "arm_math.h"
+
+/**
+ * @def BAND_THIRD_OCTAVE_COUNT
+ * @brief Number of 1/3-octave bands (25 Hz - 20 kHz)
+ */
+#define BAND_THIRD_OCTAVE_COUNT 30
+
+/**
+ * @def BAND_OCTAVE_COUNT
+ * @brief Number of octave bands (31.5 Hz - 16 kHz, each one holds three 1/3-octave bands)
+ */
+#define BAND_OCTAVE_COUNT 10
+
+/**
+ * @def BAND_FIRST_INDEX
+ * @brief Band index x of the lowest 1/3-octave band (IEC 61260 midband frequency 1000 * G^(x/3) Hz)
+ */
+#define BAND_FIRST_INDEX -16
+
+/**
+ * @def BAND_OCTAVE_RATIO
+ * @brief Octave frequency ratio G (base 10 system of IEC 61260)
+ */
+#define BAND_OCTAVE_RATIO 1.99526231f
+
+/**
+ * @def BAND_REFERENCE_FREQUENCY
+ * @brief Reference frequency of the band system [Hz]
+ */
+#define BAND_REFERENCE_FREQUENCY 1000.0f
+
+/**
+ * @def BAND_MIN_LEVEL
+ * @brief Level of empty bands and bands above Nyquist frequency [dB]
+ */
+#define BAND_MIN_LEVEL -200.0f
+
+/**
+ * @brief Frequency weighting of the band levels
+ */
+typedef enum {
+	BAND_WEIGHTING_Z = 0,
+	BAND_WEIGHTING_A = 1,
+	BAND_WEIGHTING_C = 2
+} BandWeightingType;
+
+/**
+ * @brief Bins of one band. Edge bins are partly inside the band, so their power is scaled
+ * by the part of the bin width which lies in the band.
+ */
+typedef struct {
+	uint32_t firstBin;
+	uint32_t lastBin;
+	float32_t firstWeight;
+	float32_t lastWeight;
+} BandBinsStr;
+
+/**
+ * @brief Bin to band tables prepared for one spectrum size and resolution
+ * (A and C weightings are power factors at the exact midband frequencies)
+ */
+typedef struct {
+	uint32_t vectorSize;
+	float32_t frequencyResolution;
+	uint32_t bandCount;
+	BandBinsStr bands[BAND_THIRD_OCTAVE_COUNT];
+	float32_t weightingA[BAND_THIRD_OCTAVE_COUNT];
+	float32_t weightingC[BAND_THIRD_OCTAVE_COUNT];
+} BandTableStr;
+
+/**
+ * @brief Band levels of one spectrum [dB of squared magnitude]. Only the first bandCount
+ * 1/3-octave bands and octaveCount octave bands are below Nyquist frequency, the other ones
+ * hold \ref BAND_MIN_LEVEL. The structure is sent by UDP streaming as it is.
+ */
+typedef struct {
+	uint32_t bandCount;
+	uint32_t octaveCount;
+	float32_t thirdOctave[BAND_THIRD_OCTAVE_COUNT];
+	float32_t octave[BAND_OCTAVE_COUNT];
+	float32_t levelZ;
+	float32_t levelA;
+	float32_t levelC;
+} BandLevelsStr;
+
+/* Functions */
+void bandAnalysisProcess(const float32_t* power, uint32_t size, float32_t frequencyResolution, BandLevelsStr* levels);
+float32_t bandAnalysisGetMidFrequency(uint32_t band);
+float32_t bandAnalysisGetOctaveMidFrequency(uint32_t band);
+void bandAnalysisApplyWeighting(BandLevelsStr* levels, BandWeightingType weighting);
+
+#endif /* BANDANALYSIS_H_ */
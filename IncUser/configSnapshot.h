@@ -0,0 +1,48 @@
+/*
+ * configSnapshot.h
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#ifndef CONFIGSNAPSHOT_H_
+#define CONFIGSNAPSHOT_H_
+
+#include "stdint.h"
+#include "string.h"
+#include "cmsis_os.h"
+#include "stm32f746xx.h"
+#include "jsonConfiguration.h"
+
+/**
+ * @def CONFIG_SNAPSHOT_GRACE_DELAY
+ * @brief Delay of the writer waiting for readers of the old version [ms]
+ */
+#define CONFIG_SNAPSHOT_GRACE_DELAY 1
+
+/**
+ * @brief One version of the configuration
+ */
+typedef struct {
+	StmConfig config;
+	uint32_t version;
+	volatile uint32_t readers;
+} StmConfigVersionStr;
+
+/**
+ * @brief Double-buffered configuration. Readers take the current version without locking,
+ * the writer prepares the next version in the spare buffer and publishes it with one pointer swap.
+ */
+typedef struct {
+	StmConfigVersionStr versions[2];
+	StmConfigVersionStr* volatile current;
+} StmConfigSnapshotStr;
+
+/* Functions */
+void configSnapshotInit(StmConfigSnapshotStr* snapshot, const StmConfig* config);
+const StmConfigVersionStr* configSnapshotAcquire(StmConfigSnapshotStr* snapshot);
+void configSnapshotRelease(const StmConfigVersionStr* version);
+uint32_t configSnapshotRead(StmConfigSnapshotStr* snapshot, StmConfig* config);
+uint32_t configSnapshotGetVersion(StmConfigSnapshotStr* snapshot);
+uint32_t configSnapshotUpdate(StmConfigSnapshotStr* snapshot, StmConfig* newConfig);
+
+#endif /* CONFIGSNAPSHOT_H_ */
@@ -0,0 +1,112 @@
+/*
+ * configStorage.h
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#ifndef CONFIGSTORAGE_H_
+#define CONFIGSTORAGE_H_
+
+#include "stdint.h"
+#include "stddef.h"
+#include "string.h"
+#include "lcdLogger.h"
+#include "flashDriver.h"
+#include "jsonConfiguration.h"
+
+/**
+ * @def CONFIG_STORAGE_FIRST_SECTOR
+ * @brief First of two flash sectors used as the configuration log (32 KB sectors 1 and 2, the
+ * linker script leaves a hole for them between the vector table and the code)
+ */
+#define CONFIG_STORAGE_FIRST_SECTOR 1
+
+/**
+ * @def CONFIG_STORAGE_FIRST_ADDRESS
+ * @brief Address of the first configuration log sector
+ */
+#define CONFIG_STORAGE_FIRST_ADDRESS 0x08008000U
+
+/**
+ * @def CONFIG_STORAGE_SECTOR_SIZE
+ * @brief Size of one configuration log sector [bytes]
+ */
+#define CONFIG_STORAGE_SECTOR_SIZE 0x8000U
+
+/**
+ * @def CONFIG_STORAGE_SECTOR_COUNT
+ * @brief Number of sectors used alternately by the log (the standby one is erased in advance
+ * by \ref configStorageProcess)
+ */
+#define CONFIG_STORAGE_SECTOR_COUNT 2
+
+/**
+ * @def CONFIG_STORAGE_RECORD_SIZE
+ * @brief Size of one record slot in the log [bytes]
+ */
+#define CONFIG_STORAGE_RECORD_SIZE 128
+
+/**
+ * @def CONFIG_STORAGE_RECORDS_PER_SECTOR
+ * @brief Number of record slots in one sector
+ */
+#define CONFIG_STORAGE_RECORDS_PER_SECTOR (CONFIG_STORAGE_SECTOR_SIZE / CONFIG_STORAGE_RECORD_SIZE)
+
+/**
+ * @def CONFIG_STORAGE_PAYLOAD_SIZE
+ * @brief Maximum size of the stored configuration [bytes]
+ */
+#define CONFIG_STORAGE_PAYLOAD_SIZE (CONFIG_STORAGE_RECORD_SIZE - 4 * sizeof(uint32_t))
+
+/**
+ * @def CONFIG_STORAGE_MAGIC
+ * @brief Marker of the configuration record ("STMC")
+ */
+#define CONFIG_STORAGE_MAGIC 0x434D5453U
+
+/**
+ * @def CONFIG_STORAGE_FORMAT
+ * @brief Layout version of the stored \ref StmConfig (records with other format are ignored).
+ * Fields appended to \ref StmConfig do not change it (they keep the default values when older
+ * record is loaded), it must be changed if any field is removed, moved or resized.
+ */
+#define CONFIG_STORAGE_FORMAT 1
+
+/**
+ * @def CONFIG_STORAGE_MAX_ATTEMPTS
+ * @brief How many slots are tried if programming of the record fails
+ */
+#define CONFIG_STORAGE_MAX_ATTEMPTS 3
+
+/**
+ * @brief One record of the configuration log (the whole slot is protected by CRC32)
+ */
+typedef struct {
+	uint32_t magic;
+	uint32_t sequence;
+	uint16_t format;
+	uint16_t length;
+	uint8_t payload[CONFIG_STORAGE_PAYLOAD_SIZE];
+	uint32_t crc;
+} ConfigStorageRecordStr;
+
+/**
+ * @brief Position of the newest record and the next free slot of the log
+ */
+typedef struct {
+	uint32_t sequence;
+	uint32_t sector;
+	uint32_t nextSlot;
+	uint32_t writes;
+	uint32_t erases;
+	uint32_t failures;
+	uint8_t standbyErased;
+} ConfigStorageStateStr;
+
+/* Functions */
+uint8_t configStorageLoad(StmConfig* config);
+uint8_t configStorageSave(const StmConfig* config);
+void configStorageProcess();
+void configStorageGetState(ConfigStorageStateStr* state);
+
+#endif /* CONFIGSTORAGE_H_ */
@@ -15,6 +15,8 @@
 #include "soundProcessing.h"
 #include "lwip.h"
 #include "jsonConfiguration.h"
+#include "httpResponse.h"
+#include "cmsis_os.h"
 
 /*
  * Static IP address of STM device if the LWIP cannot find the DHCP server
@@ -59,15 +61,6 @@
  */
 #define ETHERNET_AMP_BUFFER_SIZE 256
 
-/**
- * HTTP request types
- */
- typedef enum {
-	 NOT_SUPPORTED_REQUEST = 0,
-	 GET_REQUEST,
-	 PUT_REQUEST
- } HttpRequestType;
-
  /**
   * UDP streaming port
   */
@@ -78,18 +71,48 @@
   */
  #define UDP_STREAMING_IP "192.168.1.10"
 
+/**
+ * @def UDP_STREAMING_STATS_WINDOW
+ * @brief Time window of the streaming throughput measurement [ms]
+ */
+#define UDP_STREAMING_STATS_WINDOW 1000
+
+/**
+ * @brief Address the UDP streaming socket is "connected" to
+ */
+typedef struct {
+	char ip[20];
+	uint32_t port;
+	uint8_t connected;
+} UdpConnectionStr;
+
+/**
+ * @brief UDP streaming statistics (datagram throughput)
+ */
+typedef struct {
+	uint32_t sentDatagrams;
+	uint32_t failedDatagrams;
+	uint32_t sentBytes;
+	uint32_t windowStart;
+	uint32_t windowDatagrams;
+	uint32_t datagramsPerSecond;
+	uint32_t maxDatagramsPerSecond;
+} UdpStreamingStatsStr;
+
 /* Functions */
 void printAddress(const struct netif* gnetif, uint8_t addressType);
 uint32_t isEthernetCableConnected();
-err_t sendSpectrum(SpectrumStr* ampStr, struct netconn *client);
+err_t sendSpectrum(SpectrumStr* ampStr, struct netconn *client, struct netbuf* netBuf);
+err_t sendBands(SpectrumStr* ampStr, struct netconn *client, struct netbuf* netBuf);
+err_t sendFeatures(SpectrumStr* ampStr, struct netconn *client, struct netbuf* netBuf);
 uint8_t isNetconnStatusOk(err_t status);
 err_t udpSend(struct netconn *client, void* buf, uint32_t buffSize);
-HttpRequestType getRequestType(char* fullMsg);
+err_t udpSendNetbuf(struct netconn *client, struct netbuf* netBuf, void* buf, uint32_t buffSize);
+err_t udpConnectIfChanged(struct netconn *client, UdpConnectionStr* connection, const char* ip, uint32_t port);
+void udpStreamingStatsInit(UdpStreamingStatsStr* stats);
+void udpStreamingStatsUpdate(UdpStreamingStatsStr* stats, err_t status, uint32_t length);
+void udpStreamingStatsToString(UdpStreamingStatsStr* stats, char* str, uint32_t len);
 err_t sendConfiguration(StmConfig* config, struct netconn* client, char* requestParameters);
-err_t sendHttpResponse(struct netconn* client, char* httpStatus, char* requestParameters, char* content);
 err_t sendString(struct netconn* client, const char* array);
-void getDataFromBuffer(char* strBuffer, struct netbuf* buf);
-uint8_t isConfigRequest(char* buf);
-uint8_t isSystemRequest(char* buf);
 
 #endif /* ETHERNETLIB_H_ */
@@ -0,0 +1,36 @@
+/*
+ * flashDriver.h
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#ifndef FLASHDRIVER_H_
+#define FLASHDRIVER_H_
+
+#include "stdint.h"
+#include "stm32f746xx.h"
+
+/**
+ * @def FLASH_DRIVER_KEY1
+ * @brief First key of the flash control register unlock sequence
+ */
+#define FLASH_DRIVER_KEY1 0x45670123U
+
+/**
+ * @def FLASH_DRIVER_KEY2
+ * @brief Second key of the flash control register unlock sequence
+ */
+#define FLASH_DRIVER_KEY2 0xCDEF89ABU
+
+/**
+ * @def FLASH_DRIVER_ERROR_FLAGS
+ * @brief Status register flags reporting failed erase or programming
+ */
+#define FLASH_DRIVER_ERROR_FLAGS (FLASH_SR_OPERR | FLASH_SR_WRPERR | FLASH_SR_PGAERR | FLASH_SR_PGPERR | FLASH_SR_ERSERR)
+
+/* Functions */
+uint8_t flashDriverEraseSector(uint32_t sector);
+uint8_t flashDriverProgram(uint32_t address, const uint32_t* data,
+		uint32_t words);
+
+#endif /* FLASHDRIVER_H_ */
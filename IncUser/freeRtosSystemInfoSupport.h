@@ -12,27 +12,59 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "mcuConfig.h"
-#include "cJSON.h"
 #include "string.h"
+#include "stdio.h"
+#include "lcdLogger.h"
+#include "jsonWriter.h"
+#include "timeBase.h"
 
 /**
- * Task usage structure
+ * @def SYSTEM_INFO_MAX_TASKS
+ * @brief Maximum number of tasks reported by \ref getTaskUsageDetails
+ */
+#define SYSTEM_INFO_MAX_TASKS 20
+
+/**
+ * @def SYSTEM_INFO_MAX_TASK_NUMBER
+ * @brief Context switches and run time are counted for tasks with lower FreeRTOS task number (numbers are not reused)
+ */
+#define SYSTEM_INFO_MAX_TASK_NUMBER 32
+
+/**
+ * @brief Header of the binary task profile (followed by taskCount \ref SystemInfoTaskStr records).
+ * Times are in microseconds.
+ */
+typedef struct {
+	uint64_t totalRunTime;
+	uint64_t windowRunTime;
+	uint32_t taskCount;
+	uint32_t reserved;
+} SystemInfoHeaderStr;
+
+/**
+ * @brief Profile of one task. The window values are counted since the previous profile,
+ * times are in microseconds.
  */
 typedef struct {
-	char taskName[20];
-	uint32_t memory;
-	char usage[10];
-} TaskUsage;
+	char name[configMAX_TASK_NAME_LEN];
+	uint64_t runTime;
+	uint64_t windowRunTime;
+	uint32_t taskNumber;
+	uint32_t contextSwitches;
+	uint32_t windowContextSwitches;
+	uint16_t usage;
+	uint16_t stackHighWaterMark;
+	uint8_t state;
+	uint8_t currentPriority;
+	uint8_t basePriority;
+	uint8_t reserved[5];
+} SystemInfoTaskStr;
 
 /* Functions */
-void getTaskUsageDetails(char* jsonData);
-uint32_t getTimVal();
-void parseTaskUsage(char* detailsStr, char* jsonData);
-void ignoreWhitespace(uint32_t* iterator, char* str);
-uint32_t countNumberOfLines(char* str);
-uint8_t isDigit(char character);
-uint8_t isWhitespace(char character);
-uint8_t isPercent(char character);
-uint8_t isLessThan(char character);
+uint32_t systemInfoCollect(SystemInfoHeaderStr* header, SystemInfoTaskStr* tasks);
+uint8_t getTaskUsageDetails(JsonWriterStr* writer, SystemInfoTaskStr* taskProfiles);
+void systemInfoTaskSwitchedIn(uint32_t taskNumber);
+void systemInfoTaskSwitchedOut(uint32_t taskNumber);
+void configureTimerForRuntimestats();
 
 #endif /* FREERTOSSYSTEMINFOSUPPORT_H_ */
@@ -0,0 +1,137 @@
+/*
+ * httpRequestParser.h
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#ifndef HTTPREQUESTPARSER_H_
+#define HTTPREQUESTPARSER_H_
+
+#include "stdint.h"
+#include "string.h"
+#include "lwip.h"
+
+/**
+ * @def HTTP_REQUEST_MAX_METHOD_LENGTH
+ * @brief Maximum length of the HTTP method token
+ */
+#define HTTP_REQUEST_MAX_METHOD_LENGTH 8
+
+/**
+ * @def HTTP_REQUEST_MAX_PATH_LENGTH
+ * @brief Maximum length of the request path (without query)
+ */
+#define HTTP_REQUEST_MAX_PATH_LENGTH 32
+
+/**
+ * @def HTTP_REQUEST_MAX_QUERY_LENGTH
+ * @brief Maximum length of the request query string (text after '?')
+ */
+#define HTTP_REQUEST_MAX_QUERY_LENGTH 64
+
+/**
+ * @def HTTP_REQUEST_MAX_HEADER_NAME_LENGTH
+ * @brief Maximum length of the header name which is still recognized
+ */
+#define HTTP_REQUEST_MAX_HEADER_NAME_LENGTH 32
+
+/**
+ * @def HTTP_REQUEST_MAX_HEADER_VALUE_LENGTH
+ * @brief Maximum length of the header value (longer values of the known headers
+ * are rejected with 431, other headers are skipped)
+ */
+#define HTTP_REQUEST_MAX_HEADER_VALUE_LENGTH 64
+
+/**
+ * @def HTTP_REQUEST_MAX_HEADER_SIZE
+ * @brief Maximum size of the request line and all headers together
+ */
+#define HTTP_REQUEST_MAX_HEADER_SIZE 2048
+
+/**
+ * @def HTTP_REQUEST_MAX_BODY_SIZE
+ * @brief Maximum size of the request body (Content-Length)
+ */
+#define HTTP_REQUEST_MAX_BODY_SIZE 512
+
+/**
+ * @def HTTP_REQUEST_MAX_WEBSOCKET_KEY_LENGTH
+ * @brief Maximum length of the Sec-WebSocket-Key header value
+ */
+#define HTTP_REQUEST_MAX_WEBSOCKET_KEY_LENGTH 32
+
+/**
+ * HTTP request types
+ */
+typedef enum {
+	NOT_SUPPORTED_REQUEST = 0,
+	GET_REQUEST,
+	PUT_REQUEST
+} HttpRequestType;
+
+/**
+ * @brief HTTP parser state
+ */
+typedef enum {
+	HTTP_PARSER_METHOD = 0,
+	HTTP_PARSER_PATH,
+	HTTP_PARSER_QUERY,
+	HTTP_PARSER_VERSION,
+	HTTP_PARSER_HEADER_NAME,
+	HTTP_PARSER_HEADER_VALUE,
+	HTTP_PARSER_BODY,
+	HTTP_PARSER_DONE,
+	HTTP_PARSER_ERROR
+} HttpParserState;
+
+/**
+ * @brief Result of feeding data to the parser
+ */
+typedef enum {
+	HTTP_PARSE_INCOMPLETE = 0,
+	HTTP_PARSE_DONE,
+	HTTP_PARSE_ERROR
+} HttpParseStatus;
+
+/**
+ * @brief Parser error (valid if the parser is in \ref HTTP_PARSER_ERROR state)
+ */
+typedef enum {
+	HTTP_PARSE_ERROR_NONE = 0,
+	HTTP_PARSE_ERROR_BAD_REQUEST,
+	HTTP_PARSE_ERROR_URI_TOO_LONG,
+	HTTP_PARSE_ERROR_HEADER_TOO_LARGE,
+	HTTP_PARSE_ERROR_BODY_TOO_LARGE
+} HttpParseError;
+
+/**
+ * @brief Incrementally parsed HTTP/1.x request
+ */
+typedef struct {
+	HttpParserState state;
+	HttpParseError error;
+	HttpRequestType method;
+	char methodStr[HTTP_REQUEST_MAX_METHOD_LENGTH + 1];
+	char path[HTTP_REQUEST_MAX_PATH_LENGTH + 1];
+	char query[HTTP_REQUEST_MAX_QUERY_LENGTH + 1];
+	char headerName[HTTP_REQUEST_MAX_HEADER_NAME_LENGTH + 1];
+	char headerValue[HTTP_REQUEST_MAX_HEADER_VALUE_LENGTH + 1];
+	uint8_t headerValueTruncated;
+	uint32_t tokenLength;
+	uint32_t headerSize;
+	uint32_t contentLength;
+	uint32_t bodyLength;
+	char body[HTTP_REQUEST_MAX_BODY_SIZE + 1];
+	uint8_t webSocketUpgrade;
+	char webSocketKey[HTTP_REQUEST_MAX_WEBSOCKET_KEY_LENGTH + 1];
+	uint8_t connectionDetached;
+} HttpRequestStr;
+
+/* Functions */
+void httpRequestParserInit(HttpRequestStr* request);
+HttpParseStatus httpRequestParserFeed(HttpRequestStr* request, const char* data, uint32_t length);
+HttpParseStatus httpRequestParserFeedNetbuf(HttpRequestStr* request, struct netbuf* buf);
+uint8_t httpRequestGetQueryParam(HttpRequestStr* request, const char* name, char* value, uint32_t len);
+uint8_t httpRequestGetQueryUint(HttpRequestStr* request, const char* name, uint32_t* value);
+
+#endif /* HTTPREQUESTPARSER_H_ */
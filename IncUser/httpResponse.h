@@ -0,0 +1,63 @@
+/*
+ * httpResponse.h
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#ifndef HTTPRESPONSE_H_
+#define HTTPRESPONSE_H_
+
+#include "stdint.h"
+#include "stdio.h"
+#include "string.h"
+#include "lwip.h"
+
+/**
+ * @def HTTP_RESPONSE_MAX_HEADER_SIZE
+ * @brief Size of the buffer for status line and headers
+ */
+#define HTTP_RESPONSE_MAX_HEADER_SIZE 256
+
+/**
+ * @def HTTP_RESPONSE_CHUNKED
+ * @brief Content length value which selects chunked transfer encoding
+ */
+#define HTTP_RESPONSE_CHUNKED 0xFFFFFFFF
+
+/**
+ * @def HTTP_RESPONSE_NO_BODY
+ * @brief Content length value for responses which never have a body (e.g. 101 Switching Protocols)
+ */
+#define HTTP_RESPONSE_NO_BODY 0xFFFFFFFE
+
+/**
+ * @brief Lifetime of the content passed to \ref httpResponseWrite
+ */
+typedef enum {
+	/* content is placed on the stack or may change - lwIP copies it to its send buffer */
+	HTTP_CONTENT_VOLATILE = NETCONN_COPY,
+	/* content lives in flash or static memory - lwIP sends it by reference */
+	HTTP_CONTENT_STATIC = NETCONN_NOCOPY
+} HttpContentMemory;
+
+/**
+ * @brief HTTP response which is sent as a sequence of segments (header, body parts)
+ */
+typedef struct {
+	struct netconn* client;
+	char header[HTTP_RESPONSE_MAX_HEADER_SIZE];
+	uint32_t headerLength;
+	uint32_t contentLength;
+	uint8_t headerSent;
+	err_t status;
+} HttpResponseStr;
+
+/* Functions */
+void httpResponseInit(HttpResponseStr* response, struct netconn* client, const char* httpStatus);
+void httpResponseAddHeader(HttpResponseStr* response, const char* name, const char* value);
+void httpResponseAddRawHeaders(HttpResponseStr* response, const char* headers);
+void httpResponseSetContentLength(HttpResponseStr* response, uint32_t contentLength);
+err_t httpResponseWrite(HttpResponseStr* response, const void* data, uint32_t length, HttpContentMemory memory);
+err_t httpResponseEnd(HttpResponseStr* response);
+
+#endif /* HTTPRESPONSE_H_ */
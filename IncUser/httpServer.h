@@ -0,0 +1,69 @@
+/*
+ * httpServer.h
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#ifndef HTTPSERVER_H_
+#define HTTPSERVER_H_
+
+#include "stdint.h"
+#include "lwip.h"
+#include "lcdLogger.h"
+#include "ethernetLib.h"
+#include "httpRequestParser.h"
+#include "httpResponse.h"
+#include "spectrumSnapshot.h"
+#include "webSocketServer.h"
+#include "jsonConfiguration.h"
+#include "configSnapshot.h"
+#include "configStorage.h"
+#include "freeRtosSystemInfoSupport.h"
+#include "jsonWriter.h"
+#include "pipelineStats.h"
+#include "traceRecorder.h"
+#include "syslogSink.h"
+#include "levelMeter.h"
+
+/**
+ * @def HTTP_REQUEST_TIMEOUT
+ * @brief Maximum time of receiving the whole request [ms] (slow clients are disconnected)
+ */
+#define HTTP_REQUEST_TIMEOUT 3000
+
+/**
+ * @def HTTP_SPECTRUM_JSON_CHUNK_SIZE
+ * @brief Size of the text buffer used to format JSON spectrum (one chunk of the response)
+ */
+#define HTTP_SPECTRUM_JSON_CHUNK_SIZE 256
+
+/**
+ * @def HTTP_JSON_WRITER_BUFFER_SIZE
+ * @brief Size of the text buffer used by JSON writer (one chunk of the response)
+ */
+#define HTTP_JSON_WRITER_BUFFER_SIZE 128
+
+/**
+ * @brief HTTP route handler
+ * @param request: pointer to parsed \ref HttpRequestStr structure
+ * @param client: pointer to \ref netconn structure (represents endpoint client)
+ * @retval ERR_OK if there are no errors
+ */
+typedef err_t (*HttpRouteHandler)(HttpRequestStr* request,
+		struct netconn* client);
+
+/**
+ * @brief HTTP route (method and path mapped to the handler)
+ */
+typedef struct {
+	HttpRequestType method;
+	const char* path;
+	HttpRouteHandler handler;
+} HttpRouteStr;
+
+/* Functions */
+HttpParseStatus httpServerReceiveRequest(HttpRequestStr* request, struct netconn* client);
+uint8_t httpServerRespond(HttpRequestStr* request, struct netconn* client);
+err_t httpServerDispatch(HttpRequestStr* request, struct netconn* client);
+
+#endif /* HTTPSERVER_H_ */
@@ -12,8 +12,10 @@
 #include "stdint.h"
 #include "arm_math.h"
 #include "lcdLogger.h"
-#include "cJSON.h"
+#include "jsonSchemaParser.h"
+#include "jsonWriter.h"
 #include "audioRecording.h"
+#include "levelMeter.h"
 
 #define IP_ADDR_GET(ipaddr,index) (int)(((u32_t)(ipaddr.addr)>>((u32_t)(8*index)))&((u32_t)0xff))
 
@@ -21,7 +23,37 @@
 #define FALSE 0
 
 /**
- * @brief Structure represents device configuration
+ * @brief LCD view type
+ */
+typedef enum {
+	LCD_VIEW_UNDEFINED = 0,
+	LCD_VIEW_SPECTRUM = 1,
+	LCD_VIEW_WATERFALL = 2
+} LcdViewType;
+
+/**
+ * @brief Content of UDP streaming
+ */
+typedef enum {
+	STREAM_CONTENT_UNDEFINED = 0,
+	STREAM_CONTENT_SPECTRUM = 1,
+	STREAM_CONTENT_BANDS = 2,
+	STREAM_CONTENT_MFCC = 3
+} StreamContentType;
+
+/**
+ * @brief Scale of the published spectrum bins
+ */
+typedef enum {
+	SPECTRUM_SCALE_UNDEFINED = 0,
+	SPECTRUM_SCALE_LINEAR = 1,
+	SPECTRUM_SCALE_POWER = 2,
+	SPECTRUM_SCALE_DB = 3
+} SpectrumScaleType;
+
+/**
+ * @brief Structure represents device configuration. It is stored in flash as raw bytes,
+ * so new fields are only appended (see \ref CONFIG_STORAGE_FORMAT).
  */
 typedef struct {
 	uint8_t amplitudeSamplingDelay;
@@ -29,11 +61,21 @@ typedef struct {
 	uint32_t clientPort;
 	uint32_t windowType;
 	char clientIp[20];
+	uint32_t lcdView;
+	char syslogIp[20];
+	uint32_t syslogPort;
+	uint32_t streamContent;
+	uint32_t leqPeriod;
+	uint32_t spectrumScale;
 } StmConfig;
 
+/* Configuration schema */
+extern const JsonSchemaFieldStr stmConfigSchema[];
+extern const uint32_t stmConfigSchemaSize;
+
 /* Functions */
-void parseJSON(char* jsonData, StmConfig* config);
-void stmConfigToString(StmConfig* config, char* str, uint32_t len);
+uint8_t parseJSON(char* jsonData, StmConfig* config, JsonSchemaResultStr* result);
+uint8_t stmConfigToString(StmConfig* config, char* str, uint32_t len);
 void copyConfig(StmConfig* destination, StmConfig* source);
 void makeChanges(StmConfig* newConfig, StmConfig* oldConfig);
 
@@ -0,0 +1,92 @@
+/*
+ * jsonSchemaParser.h
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#ifndef JSONSCHEMAPARSER_H_
+#define JSONSCHEMAPARSER_H_
+
+#include "stdint.h"
+#include "stddef.h"
+#include "stdio.h"
+#include "string.h"
+
+/**
+ * @def JSON_SCHEMA_MAX_KEY_LENGTH
+ * @brief Maximum length of the object key (longer keys are treated as unknown)
+ */
+#define JSON_SCHEMA_MAX_KEY_LENGTH 32
+
+/**
+ * @def JSON_SCHEMA_MAX_STRING_LENGTH
+ * @brief Maximum length of the string value which is used to find the enum value
+ */
+#define JSON_SCHEMA_MAX_STRING_LENGTH 32
+
+/**
+ * @def JSON_SCHEMA_MAX_DEPTH
+ * @brief Maximum nesting of skipped (unknown) values
+ */
+#define JSON_SCHEMA_MAX_DEPTH 8
+
+/**
+ * @def JSON_SCHEMA_MAX_FIELDS
+ * @brief Maximum number of fields in one schema (one bit per field in \ref JsonSchemaResultStr)
+ */
+#define JSON_SCHEMA_MAX_FIELDS 32
+
+/**
+ * @brief Type of the value stored in the destination structure
+ */
+typedef enum {
+	/* unsigned integer (destination size 1, 2 or 4 bytes) checked against min/max */
+	JSON_SCHEMA_UINT,
+	/* string copied to char array (destination size is the array size) */
+	JSON_SCHEMA_STRING,
+	/* IPv4 address in dotted decimal notation copied to char array */
+	JSON_SCHEMA_IPV4,
+	/* string mapped to uint32_t value using enum table */
+	JSON_SCHEMA_ENUM,
+	/* unsigned integer equal to one of the values of enum table (names are not used in JSON) */
+	JSON_SCHEMA_UINT_SET
+} JsonSchemaFieldType;
+
+/**
+ * @brief Enum value name
+ */
+typedef struct {
+	const char* name;
+	uint32_t value;
+} JsonSchemaEnumStr;
+
+/**
+ * @brief Description of one field: JSON key mapped to the member of destination structure
+ */
+typedef struct {
+	const char* name;
+	JsonSchemaFieldType type;
+	uint32_t offset;
+	uint32_t size;
+	uint32_t min;
+	uint32_t max;
+	const JsonSchemaEnumStr* enumValues;
+	uint32_t enumCount;
+} JsonSchemaFieldStr;
+
+/**
+ * @brief Parsing result (bit n represents n-th schema field)
+ */
+typedef struct {
+	uint32_t foundFields;
+	uint32_t rejectedFields;
+	uint32_t unknownFields;
+	uint8_t syntaxError;
+	uint32_t errorPosition;
+} JsonSchemaResultStr;
+
+/* Functions */
+uint8_t jsonSchemaParse(const char* json, const JsonSchemaFieldStr* schema, uint32_t fieldCount, void* destination, JsonSchemaResultStr* result);
+uint32_t jsonSchemaCopyValid(const JsonSchemaFieldStr* schema, uint32_t fieldCount, void* destination, const void* source);
+
+#endif /* JSONSCHEMAPARSER_H_ */
@@ -0,0 +1,59 @@
+/*
+ * jsonWriter.h
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#ifndef JSONWRITER_H_
+#define JSONWRITER_H_
+
+#include "stdint.h"
+#include "stdio.h"
+#include "string.h"
+#include "httpResponse.h"
+#include "jsonSchemaParser.h"
+
+/**
+ * @def JSON_WRITER_MAX_DEPTH
+ * @brief Maximum nesting of objects and arrays
+ */
+#define JSON_WRITER_MAX_DEPTH 8
+
+/**
+ * @brief Streaming JSON writer. It writes to the bounded buffer (the overflow is detected)
+ * or, if the response is given, it sends the buffer as the next part of HTTP response
+ * every time it becomes full.
+ */
+typedef struct {
+	char* buffer;
+	uint32_t size;
+	uint32_t length;
+	HttpResponseStr* response;
+	uint8_t overflow;
+	uint8_t depth;
+	uint8_t hasElements[JSON_WRITER_MAX_DEPTH];
+	uint8_t afterKey;
+} JsonWriterStr;
+
+/* Functions */
+void jsonWriterInit(JsonWriterStr* writer, char* buffer, uint32_t size);
+void jsonWriterInitResponse(JsonWriterStr* writer, char* buffer, uint32_t size, HttpResponseStr* response);
+void jsonWriterBeginObject(JsonWriterStr* writer);
+void jsonWriterEndObject(JsonWriterStr* writer);
+void jsonWriterBeginArray(JsonWriterStr* writer);
+void jsonWriterEndArray(JsonWriterStr* writer);
+void jsonWriterKey(JsonWriterStr* writer, const char* key);
+void jsonWriterString(JsonWriterStr* writer, const char* value);
+void jsonWriterUint(JsonWriterStr* writer, uint32_t value);
+void jsonWriterUint64(JsonWriterStr* writer, uint64_t value);
+void jsonWriterInt(JsonWriterStr* writer, int32_t value);
+void jsonWriterFloat(JsonWriterStr* writer, float value);
+void jsonWriterAddString(JsonWriterStr* writer, const char* key, const char* value);
+void jsonWriterAddUint(JsonWriterStr* writer, const char* key, uint32_t value);
+void jsonWriterAddUint64(JsonWriterStr* writer, const char* key, uint64_t value);
+void jsonWriterAddFloat(JsonWriterStr* writer, const char* key, float value);
+void jsonWriterSchemaObject(JsonWriterStr* writer, const JsonSchemaFieldStr* schema, uint32_t fieldCount, const void* source);
+void jsonWriterSchemaResult(JsonWriterStr* writer, const JsonSchemaFieldStr* schema, uint32_t fieldCount, const JsonSchemaResultStr* result);
+uint8_t jsonWriterFinish(JsonWriterStr* writer);
+
+#endif /* JSONWRITER_H_ */
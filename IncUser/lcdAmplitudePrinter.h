@@ -9,6 +9,8 @@
 #define LCDAMPLITUDEPRINTER_H_
 
 #include "soundProcessing.h"
+#include "spectrumSnapshot.h"
+#include "lcdFrameBuffer.h"
 #include "stm32746g_discovery_lcd.h"
 #include "lcdLogger.h"
 
@@ -24,7 +26,26 @@
  */
 #define LCD_HEIGHT 272
 
+/**
+ * @def LCD_AMP_PRINTER_BAR_COLOR
+ * @brief Color of spectrum bars
+ */
+#define LCD_AMP_PRINTER_BAR_COLOR LCD_COLOR_BLACK
+
+/**
+ * @def LCD_AMP_PRINTER_BACKGROUND_COLOR
+ * @brief Color above spectrum bars
+ */
+#define LCD_AMP_PRINTER_BACKGROUND_COLOR LCD_COLOR_WHITE
+
+/**
+ * @def LCD_AMP_PRINTER_UNKNOWN_BAR
+ * @brief Value of the drawn bar top which forces drawing of the whole column
+ */
+#define LCD_AMP_PRINTER_UNKNOWN_BAR 0xFFFF
+
 /* Functions */
-void lcdAmpPrinterPrint(SpectrumStr* amp);
+void lcdAmpPrinterInit();
+uint8_t lcdAmpPrinterPrint(SpectrumSnapshotStr* snapshot, uint32_t bufferIndex);
 
 #endif /* LCDAMPLITUDEPRINTER_H_ */
@@ -0,0 +1,86 @@
+/*
+ * lcdFrameBuffer.h
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#ifndef LCDFRAMEBUFFER_H_
+#define LCDFRAMEBUFFER_H_
+
+#include "stdint.h"
+#include "stm32746g_discovery_lcd.h"
+#include "cmsis_os.h"
+
+/**
+ * @def LCD_FRAME_BUFFER_COUNT
+ * @brief Number of framebuffers (one is shown, the other one is drawn)
+ */
+#define LCD_FRAME_BUFFER_COUNT 2
+
+/**
+ * @def LCD_FRAME_BUFFER_OVERLAY
+ * @brief Index of the overlay framebuffer (layer 1 with the log text, it is not flipped)
+ */
+#define LCD_FRAME_BUFFER_OVERLAY LCD_FRAME_BUFFER_COUNT
+
+/**
+ * @def LCD_FRAME_BUFFER_WIDTH
+ * @brief Framebuffer width [pixels]
+ */
+#define LCD_FRAME_BUFFER_WIDTH 480
+
+/**
+ * @def LCD_FRAME_BUFFER_HEIGHT
+ * @brief Framebuffer height [pixels]
+ */
+#define LCD_FRAME_BUFFER_HEIGHT 272
+
+/**
+ * @def LCD_FRAME_BUFFER_PIXEL_SIZE
+ * @brief Size of the framebuffer pixel [bytes] (ARGB8888 layer set by \ref lcdInit)
+ */
+#define LCD_FRAME_BUFFER_PIXEL_SIZE 4
+
+/**
+ * @def LCD_FRAME_BUFFER_SPACING
+ * @brief Distance between framebuffers in SDRAM [bytes] (480x272 ARGB8888 takes 510 KB)
+ */
+#define LCD_FRAME_BUFFER_SPACING 0x80000
+
+/**
+ * @def LCD_FRAME_BUFFER_SWAP_SIGNAL
+ * @brief Signal sent to the drawing task when the swap was done
+ */
+#define LCD_FRAME_BUFFER_SWAP_SIGNAL 0x0002
+
+/**
+ * @def LCD_FRAME_BUFFER_SWAP_TIMEOUT
+ * @brief Maximum wait for the vertical blanking [ms] (3 frames at 60 Hz)
+ */
+#define LCD_FRAME_BUFFER_SWAP_TIMEOUT 50
+
+/**
+ * @def LCD_FRAME_BUFFER_IRQ_PRIORITY
+ * @brief LTDC interrupt priority (it has to be lower than configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY to set signals)
+ */
+#define LCD_FRAME_BUFFER_IRQ_PRIORITY 6
+
+/**
+ * @def LCD_FRAME_BUFFER_NO_SWAP
+ * @brief Value of the pending buffer index when no swap was requested
+ */
+#define LCD_FRAME_BUFFER_NO_SWAP 0xFF
+
+/* Functions */
+void lcdFrameBufferInit();
+uint32_t lcdFrameBufferGetAddress(uint32_t index);
+uint32_t lcdFrameBufferGetFrontIndex();
+uint32_t lcdFrameBufferGetBackIndex();
+uint8_t lcdFrameBufferSwap();
+void lcdFrameBufferFillRect(uint32_t index, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t color);
+void lcdFrameBufferCopyRows(uint32_t sourceIndex, uint32_t sourceRow, uint32_t destinationIndex, uint32_t destinationRow, uint32_t rows);
+void lcdFrameBufferWaitForDma2d();
+void lcdFrameBufferLockDma2d();
+void lcdFrameBufferUnlockDma2d();
+
+#endif /* LCDFRAMEBUFFER_H_ */
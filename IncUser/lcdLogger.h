@@ -10,7 +10,12 @@
 
 #include "stm32746g_discovery_lcd.h"
 #include "stdlib.h"
+#include "stdarg.h"
+#include "stdio.h"
+#include "string.h"
 #include "arm_math.h"
+#include "timeBase.h"
+#include "lcdFrameBuffer.h"
 #include "jsonConfiguration.h"
 
 /**
@@ -23,6 +28,37 @@
  */
 #define LOG_MAX_MESSAGE_LENGTH 50
 
+/**
+ * @def LOG_QUEUE_SIZE
+ * @brief Number of records waiting for the logger task (power of 2)
+ */
+#define LOG_QUEUE_SIZE 32
+
+/**
+ * @def LOG_HISTORY_SIZE
+ * @brief Number of the newest records kept in RAM for GET /log and the syslog sink (power of 2)
+ */
+#define LOG_HISTORY_SIZE 64
+
+/**
+ * @def LOG_LEVEL
+ * @brief The least important \ref LogSeverity which is logged (less important records are filtered out)
+ */
+#define LOG_LEVEL LOG_SEVERITY_INFO
+
+/**
+ * @def LOG_RATE_PERIOD
+ * @brief Period of the rate limiter [ms]
+ */
+#define LOG_RATE_PERIOD 1000
+
+/**
+ * @def LOG_RATE_LIMIT
+ * @brief Maximum number of records of one severity in \ref LOG_RATE_PERIOD
+ * (the other ones are dropped, so a flood from an interrupt does not hide other messages)
+ */
+#define LOG_RATE_LIMIT 32
+
 /**
  * @def LOG_FONT
  */
@@ -30,18 +66,90 @@
 
 /**
  * @def LOG_BACKGROUND_COLOR
+ * @brief Color of the framebuffers under the log layer (the spectrum printers draw there)
  */
 #define LOG_BACKGROUND_COLOR LCD_COLOR_WHITE
 
+/**
+ * @def LOG_LAYER_BACKGROUND_COLOR
+ * @brief Background of the log text (transparent, the framebuffer under the log layer is visible)
+ */
+#define LOG_LAYER_BACKGROUND_COLOR 0x00FFFFFF
+
 /**
  * @def LOG_FONT_COLOR
  */
 #define LOG_FONT_COLOR LCD_COLOR_BLACK
 
+/**
+ * @def LOG_WARNING_COLOR
+ */
+#define LOG_WARNING_COLOR LCD_COLOR_ORANGE
+
+/**
+ * @def LOG_ERROR_COLOR
+ */
+#define LOG_ERROR_COLOR LCD_COLOR_RED
+
+/**
+ * @brief Severity of the log record (values of RFC 5424 syslog severities)
+ */
+typedef enum {
+	LOG_SEVERITY_ERROR = 3,
+	LOG_SEVERITY_WARNING = 4,
+	LOG_SEVERITY_INFO = 6,
+	LOG_SEVERITY_DEBUG = 7
+} LogSeverity;
+
+/**
+ * @def LOG_SEVERITY_COUNT
+ * @brief Number of severity values (size of arrays indexed by \ref LogSeverity)
+ */
+#define LOG_SEVERITY_COUNT 8
+
+/**
+ * @brief Formatted log record (the slot is owned by the writer until ready is set,
+ * timestamp is \ref timeBaseGetCycles value)
+ */
+typedef struct {
+	volatile uint32_t ready;
+	uint32_t severity;
+	uint64_t timestamp;
+	char text[LOG_MAX_MESSAGE_LENGTH];
+} LogRecordStr;
+
+/**
+ * @brief Displayed record kept in the history (sequence is 0 while the entry is written)
+ */
+typedef struct {
+	volatile uint32_t sequence;
+	uint32_t severity;
+	uint64_t timestamp;
+	char text[LOG_MAX_MESSAGE_LENGTH];
+} LogEntryStr;
+
+/**
+ * @brief Counters of the log queue
+ */
+typedef struct {
+	uint32_t written;
+	uint32_t dropped;
+	uint32_t rateLimited;
+	uint32_t filtered;
+} LogStatsStr;
+
 /* Functions */
 void lcdInit();
+void logWrite(LogSeverity severity, const char* format, ...);
+void logProcess();
+void logGetStats(LogStatsStr* stats);
+uint32_t logGetFirstSequence();
+uint32_t logGetLastSequence();
+uint8_t logGetEntry(uint32_t sequence, LogEntryStr* entry);
+const char* logGetSeverityName(uint32_t severity);
 void logMsg(char* msg);
-void logErr(char* mag);
+void logWarn(char* msg);
+void logErr(char* msg);
 void logMsgVal(char* msg, int val);
 void logErrVal(char* msg, int val);
 void logMsgValFt(char* msg, float val);
@@ -0,0 +1,36 @@
+/*
+ * lcdWaterfallPrinter.h
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#ifndef LCDWATERFALLPRINTER_H_
+#define LCDWATERFALLPRINTER_H_
+
+#include "soundProcessing.h"
+#include "spectrumSnapshot.h"
+#include "lcdFrameBuffer.h"
+
+/**
+ * @def LCD_WATERFALL_LUT_SIZE
+ * @brief Number of colors in the level to color table
+ */
+#define LCD_WATERFALL_LUT_SIZE 256
+
+/**
+ * @def LCD_WATERFALL_RANGE_DB
+ * @brief Range of levels shown below the strongest amplitude [dB] (weaker bins are black)
+ */
+#define LCD_WATERFALL_RANGE_DB 80.0f
+
+/**
+ * @def LCD_WATERFALL_BACKGROUND_COLOR
+ * @brief Color of the columns without spectrum bins
+ */
+#define LCD_WATERFALL_BACKGROUND_COLOR LCD_COLOR_BLACK
+
+/* Functions */
+void lcdWaterfallInit();
+uint8_t lcdWaterfallPrint(SpectrumSnapshotStr* snapshot, uint32_t bufferIndex);
+
+#endif /* LCDWATERFALLPRINTER_H_ */
@@ -0,0 +1,120 @@
+/*
+ * levelMeter.h
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#ifndef LEVELMETER_H_
+#define LEVELMETER_H_
+
+#include "stdint.h"
+#include "string.h"
+#include "math.h"
+#include "arm_math.h"
+#include "cmsis_os.h"
+
+/**
+ * @def LEVEL_METER_FAST_TIME
+ * @brief Time constant of the fast exponential integration [s]
+ */
+#define LEVEL_METER_FAST_TIME 0.125f
+
+/**
+ * @def LEVEL_METER_SLOW_TIME
+ * @brief Time constant of the slow exponential integration [s]
+ */
+#define LEVEL_METER_SLOW_TIME 1.0f
+
+/**
+ * @def LEVEL_METER_PEAK_HOLD_TIME
+ * @brief How long the highest peak is held [ms]
+ */
+#define LEVEL_METER_PEAK_HOLD_TIME 2000
+
+/**
+ * @def LEVEL_METER_DEFAULT_LEQ_PERIOD
+ * @brief Default Leq integration period [ms]
+ */
+#define LEVEL_METER_DEFAULT_LEQ_PERIOD 1000
+
+/**
+ * @def LEVEL_METER_MIN_LEQ_PERIOD
+ * @brief Minimum Leq integration period accepted in configuration [ms]
+ */
+#define LEVEL_METER_MIN_LEQ_PERIOD 100
+
+/**
+ * @def LEVEL_METER_MAX_LEQ_PERIOD
+ * @brief Maximum Leq integration period accepted in configuration [ms] (the energy sum
+ * of one hour at 96 kHz fits in 64 bits)
+ */
+#define LEVEL_METER_MAX_LEQ_PERIOD 3600000
+
+/**
+ * @def LEVEL_METER_MAX_RETRIES
+ * @brief How many times the reader tries to copy the levels before it gives up
+ */
+#define LEVEL_METER_MAX_RETRIES 8
+
+/**
+ * @def LEVEL_METER_MIN_LEVEL
+ * @brief Level of silence [dBFS]
+ */
+#define LEVEL_METER_MIN_LEVEL -200.0f
+
+/**
+ * @def LEVEL_METER_FULL_SCALE_POWER
+ * @brief Power of the full scale square wave in the 34.30 format of arm_power_q15
+ */
+#define LEVEL_METER_FULL_SCALE_POWER 1073741824.0f
+
+/**
+ * @brief State of the level meter (powers relative to full scale). It is written only
+ * by the sampling task, the sequence is odd while it is changed.
+ */
+typedef struct {
+	volatile uint32_t sequence;
+	uint32_t frequency;
+	uint32_t blockSize;
+	float32_t fastFactor;
+	float32_t slowFactor;
+	float32_t blockPower;
+	float32_t blockPeak;
+	float32_t fastPower;
+	float32_t slowPower;
+	float32_t holdPeak;
+	uint32_t holdSamples;
+	uint32_t leqPeriod;
+	uint64_t leqTarget;
+	uint64_t leqSamples;
+	q63_t leqEnergy;
+	float32_t leqPower;
+	uint32_t leqWindows;
+	uint32_t blocks;
+	uint32_t clippedBlocks;
+} LevelMeterStr;
+
+/**
+ * @brief Levels of the recorded signal [dBFS]
+ */
+typedef struct {
+	float32_t rms;
+	float32_t peak;
+	float32_t peakHold;
+	float32_t fast;
+	float32_t slow;
+	float32_t leq;
+	float32_t leqCurrent;
+	uint32_t leqPeriod;
+	uint32_t leqWindows;
+	uint32_t blocks;
+	uint32_t clippedBlocks;
+} LevelMeterReadingStr;
+
+/* Functions */
+void levelMeterInit(uint32_t leqPeriod);
+void levelMeterSetLeqPeriod(uint32_t leqPeriod);
+void levelMeterProcess(const uint16_t* samples, uint32_t count, uint32_t frequency);
+uint8_t levelMeterRead(LevelMeterReadingStr* reading);
+
+#endif /* LEVELMETER_H_ */
@@ -66,12 +66,41 @@
  */
 #define NO_SYS                  0
 
+/* ---------- Memory profiles ---------- */
+/* LWIP_MEMORY_PROFILE selects the memory options for the deployment
+ (can be overridden from the compiler command line, e.g.
+ -DLWIP_MEMORY_PROFILE=LWIP_MEMORY_PROFILE_LOW_MEMORY):
+ - LWIP_MEMORY_PROFILE_LOW_MEMORY: UDP streaming and HTTP configuration only
+ (the original settings),
+ - LWIP_MEMORY_PROFILE_STREAMING: UDP streaming together with HTTP spectrum
+ downloads and WebSocket clients (TCP data is copied to the lwIP heap). */
+#define LWIP_MEMORY_PROFILE_LOW_MEMORY  0
+#define LWIP_MEMORY_PROFILE_STREAMING   1
+
+#ifndef LWIP_MEMORY_PROFILE
+#define LWIP_MEMORY_PROFILE             LWIP_MEMORY_PROFILE_STREAMING
+#endif
+
 /* ---------- Memory options ---------- */
 /* MEM_ALIGNMENT: should be set to the alignment of the CPU for which
  lwIP is compiled. 4 byte alignment -> define MEM_ALIGNMENT to 4, 2
  byte alignment -> define MEM_ALIGNMENT to 2. */
 #define MEM_ALIGNMENT           4
 
+#if LWIP_MEMORY_PROFILE == LWIP_MEMORY_PROFILE_STREAMING
+/* MEM_SIZE: the size of the heap memory. It holds the UDP/IP headers of
+ every datagram and the copied TCP data (send buffers of HTTP and
+ WebSocket clients). */
+#define MEM_SIZE                (16*1024)
+
+/* MEMP_NUM_PBUF: the number of memp struct pbufs. The UDP streaming
+ sends the spectrum by reference (one PBUF_REF per datagram). */
+#define MEMP_NUM_PBUF           24
+
+/* PBUF_POOL_SIZE: the number of buffers in the pbuf pool (received
+ frames only). */
+#define PBUF_POOL_SIZE          8
+#else
 /* MEM_SIZE: the size of the heap memory. If the application will send
  a lot of data that needs to be copied, this should be set high. */
 #define MEM_SIZE                (5*1024)
@@ -80,6 +109,11 @@
  sends a lot of data out of ROM (or other static memory), this
  should be set high. */
 #define MEMP_NUM_PBUF           100
+
+/* PBUF_POOL_SIZE: the number of buffers in the pbuf pool. */
+#define PBUF_POOL_SIZE          10
+#endif
+
 /* MEMP_NUM_UDP_PCB: the number of UDP protocol control blocks. One
  per active UDP "connection". */
 #define MEMP_NUM_UDP_PCB        6
@@ -95,11 +129,11 @@
 /* MEMP_NUM_SYS_TIMEOUT: the number of simulateously active
  timeouts. */
 #define MEMP_NUM_SYS_TIMEOUT    10
+/* MEMP_NUM_NETCONN: the number of struct netconns (HTTP server, HTTP
+ client, UDP streaming and WebSocket clients). */
+#define MEMP_NUM_NETCONN        8
 
 /* ---------- Pbuf options ---------- */
-/* PBUF_POOL_SIZE: the number of buffers in the pbuf pool. */
-#define PBUF_POOL_SIZE          10
-
 /* PBUF_POOL_BUFSIZE: the size of each pbuf in the pbuf pool. */
 #define PBUF_POOL_BUFSIZE       1524
 
@@ -229,16 +263,30 @@
 
 #define TCPIP_THREAD_NAME              "TCP/IP"
 #define TCPIP_THREAD_STACKSIZE          1000
-#define TCPIP_MBOX_SIZE                 5
-#define DEFAULT_UDP_RECVMBOX_SIZE       2000
-#define DEFAULT_TCP_RECVMBOX_SIZE       2000
-#define DEFAULT_ACCEPTMBOX_SIZE         2000
+/* Every mbox is a FreeRTOS queue allocated from the FreeRTOS heap (4 bytes
+ per entry), so the receive mboxes are kept small. */
+#define TCPIP_MBOX_SIZE                 16
+#define DEFAULT_UDP_RECVMBOX_SIZE       4
+#define DEFAULT_TCP_RECVMBOX_SIZE       8
+#define DEFAULT_ACCEPTMBOX_SIZE         4
 #define DEFAULT_THREAD_STACKSIZE        500
 #define TCPIP_THREAD_PRIO               (configMAX_PRIORITIES - 2)
-#define LWIP_COMPAT_MUTEX               1
+#define LWIP_COMPAT_MUTEX               0
+
+/* LWIP_TCPIP_CORE_LOCKING==1: netconn functions call the stack directly
+ under the core mutex instead of passing a message to tcpip_thread and
+ waiting for the answer (the streaming task sends without a context switch).
+ To compare, build it with -DLWIP_TCPIP_CORE_LOCKING=0 and =1, set
+ AmplitudeSamplingDelay to 1 (the minimum, PUT /config) and read the "Send"
+ stage of GET /latency (time of one UDP send) and "DatagramsPerSecond" of
+ GET /network. */
+#ifndef LWIP_TCPIP_CORE_LOCKING
+#define LWIP_TCPIP_CORE_LOCKING         1
+#endif
 
 #define LWIP_NETIF_HOSTNAME STM32F7GDISCOVERY
 #define LWIP_SO_RCVTIMEO 1
+#define LWIP_SO_SNDTIMEO 1
 
 #endif /* __LWIPOPTS_H__ */
 
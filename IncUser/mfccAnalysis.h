@@ -0,0 +1,80 @@
+/*
+ * mfccAnalysis.h
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#ifndef MFCCANALYSIS_H_
+#define MFCCANALYSIS_H_
+
+#include "stdint.h"
+#include "string.h"
+#include "math.h"
+#include "arm_math.h"
+#include "audioRecording.h"
+
+/**
+ * @def MFCC_FILTER_COUNT
+ * @brief Number of triangular mel filters
+ */
+#define MFCC_FILTER_COUNT 26
+
+/**
+ * @def MFCC_COEFFICIENT_COUNT
+ * @brief Number of cepstral coefficients (the first one is the log energy)
+ */
+#define MFCC_COEFFICIENT_COUNT 13
+
+/**
+ * @def MFCC_MIN_FREQUENCY
+ * @brief Lower edge of the first filter [Hz]
+ */
+#define MFCC_MIN_FREQUENCY 20.0f
+
+/**
+ * @def MFCC_MAX_FREQUENCY
+ * @brief Upper edge of the last filter [Hz] (Nyquist frequency if it is lower)
+ */
+#define MFCC_MAX_FREQUENCY 8000.0f
+
+/**
+ * @def MFCC_LOG_FLOOR
+ * @brief Smallest filter energy used in log compression
+ */
+#define MFCC_LOG_FLOOR 1e-10f
+
+/**
+ * @def MFCC_MAX_BINS
+ * @brief Maximum number of bins up to Nyquist frequency
+ */
+#define MFCC_MAX_BINS (MAIN_SOUND_BUFFER_MAX_BUFFER_SIZE / 4 + 1)
+
+/**
+ * @brief Mel filterbank prepared for one spectrum size and resolution. Each bin lies on the
+ * rising edge of one filter and the falling edge of the previous one, so only the rising
+ * weight of every bin is stored. Bins from segmentStart[i] to segmentStart[i + 1] rise
+ * in filter i.
+ */
+typedef struct {
+	uint32_t vectorSize;
+	float32_t frequencyResolution;
+	uint32_t segmentStart[MFCC_FILTER_COUNT + 2];
+	float32_t weights[MFCC_MAX_BINS];
+	float32_t dct[MFCC_COEFFICIENT_COUNT][MFCC_FILTER_COUNT];
+} MfccTableStr;
+
+/**
+ * @brief Features of one spectrum (natural log of the mel filter energies and MFCCs).
+ * The structure is sent by UDP streaming as it is.
+ */
+typedef struct {
+	float32_t lowFrequency;
+	float32_t highFrequency;
+	float32_t logEnergies[MFCC_FILTER_COUNT];
+	float32_t coefficients[MFCC_COEFFICIENT_COUNT];
+} MfccFeaturesStr;
+
+/* Functions */
+void mfccAnalysisProcess(const float32_t* power, uint32_t size, float32_t frequencyResolution, MfccFeaturesStr* features);
+
+#endif /* MFCCANALYSIS_H_ */
@@ -0,0 +1,65 @@
+/*
+ * peakAnalysis.h
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#ifndef PEAKANALYSIS_H_
+#define PEAKANALYSIS_H_
+
+#include "stdint.h"
+#include "math.h"
+#include "arm_math.h"
+#include "audioRecording.h"
+
+/**
+ * @def PEAK_ANALYSIS_MAX_PEAKS
+ * @brief Number of the strongest peaks found in the spectrum
+ */
+#define PEAK_ANALYSIS_MAX_PEAKS 8
+
+/**
+ * @def PEAK_ANALYSIS_MAX_HARMONICS
+ * @brief Number of analysed harmonics (including the fundamental)
+ */
+#define PEAK_ANALYSIS_MAX_HARMONICS 10
+
+/**
+ * @def PEAK_ANALYSIS_MIN_POWER
+ * @brief Power used instead of zero in dB calculations
+ */
+#define PEAK_ANALYSIS_MIN_POWER 1e-20f
+
+/**
+ * @def PEAK_ANALYSIS_MIN_DELTA
+ * @brief Smaller offsets from the bin center do not change the amplitude of rectangular lobe
+ */
+#define PEAK_ANALYSIS_MIN_DELTA 1e-4f
+
+/**
+ * @brief Spectrum peak refined between bins
+ */
+typedef struct {
+	float32_t frequency;
+	float32_t amplitude;
+} PeakStr;
+
+/**
+ * @brief Result of the peak and harmonic analysis. Peaks are sorted from the strongest one,
+ * harmonics[0] is the fundamental (the strongest peak). THD is the ratio of the harmonic
+ * and fundamental RMS values, SNR and SINAD are in dB.
+ */
+typedef struct {
+	uint32_t peakCount;
+	PeakStr peaks[PEAK_ANALYSIS_MAX_PEAKS];
+	uint32_t harmonicCount;
+	PeakStr harmonics[PEAK_ANALYSIS_MAX_HARMONICS];
+	float32_t thd;
+	float32_t snr;
+	float32_t sinad;
+} PeakAnalysisStr;
+
+/* Functions */
+void peakAnalysisProcess(const float32_t* power, uint32_t size, float32_t frequencyResolution, WindowType windowType, PeakAnalysisStr* analysis);
+
+#endif /* PEAKANALYSIS_H_ */
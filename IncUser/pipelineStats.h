@@ -0,0 +1,82 @@
+/*
+ * pipelineStats.h
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#ifndef PIPELINESTATS_H_
+#define PIPELINESTATS_H_
+
+#include "stdint.h"
+#include "string.h"
+#include "timeBase.h"
+#include "jsonWriter.h"
+
+/**
+ * @def PIPELINE_STATS_SUB_BUCKETS_BITS
+ * @brief Every power of two range is split into 2^bits buckets (the bucket width is at most 25% of its value)
+ */
+#define PIPELINE_STATS_SUB_BUCKETS_BITS 2
+
+/**
+ * @def PIPELINE_STATS_SUB_BUCKETS
+ * @brief Number of buckets in every power of two range
+ */
+#define PIPELINE_STATS_SUB_BUCKETS (1 << PIPELINE_STATS_SUB_BUCKETS_BITS)
+
+/**
+ * @def PIPELINE_STATS_BUCKETS
+ * @brief Number of histogram buckets (values up to 2^21 us = 2.1 s, longer ones are counted in the last bucket)
+ */
+#define PIPELINE_STATS_BUCKETS 80
+
+/**
+ * @brief Measured stages of the spectrum pipeline
+ */
+typedef enum {
+	PIPELINE_STAGE_CAPTURE = 0,
+	PIPELINE_STAGE_COPY,
+	PIPELINE_STAGE_WINDOW,
+	PIPELINE_STAGE_FFT,
+	PIPELINE_STAGE_MAGNITUDE,
+	PIPELINE_STAGE_ANALYSIS,
+	PIPELINE_STAGE_BANDS,
+	PIPELINE_STAGE_FEATURES,
+	PIPELINE_STAGE_SCALE,
+	PIPELINE_STAGE_PUBLISH,
+	PIPELINE_STAGE_SEND,
+	PIPELINE_STAGE_CAPTURE_TO_PUBLISH,
+	PIPELINE_STAGE_CAPTURE_TO_SEND,
+	PIPELINE_STAGE_COUNT
+} PipelineStage;
+
+/**
+ * @brief Latency histogram of one stage (updated only by the task which runs the stage)
+ */
+typedef struct {
+	uint32_t buckets[PIPELINE_STATS_BUCKETS];
+	uint32_t count;
+	uint32_t max;
+	uint64_t sum;
+} PipelineHistogramStr;
+
+/**
+ * @brief Latency summary of one stage [us]
+ */
+typedef struct {
+	uint32_t count;
+	uint32_t mean;
+	uint32_t p50;
+	uint32_t p99;
+	uint32_t max;
+} PipelineStageSummaryStr;
+
+/* Functions */
+void pipelineStatsReset();
+void pipelineStatsRecord(PipelineStage stage, uint32_t latency);
+uint64_t pipelineStatsRecordSince(PipelineStage stage, uint64_t startCycles);
+void pipelineStatsRecordAge(PipelineStage stage, uint64_t timestamp);
+void pipelineStatsGetSummary(PipelineStage stage, PipelineStageSummaryStr* summary);
+void pipelineStatsToJson(JsonWriterStr* writer);
+
+#endif /* PIPELINESTATS_H_ */
@@ -12,6 +12,9 @@
 #include "audioRecording.h"
 #include "arm_math.h"
 #include "arm_const_structs.h"
+#include "peakAnalysis.h"
+#include "bandAnalysis.h"
+#include "mfccAnalysis.h"
 
 /**
  * @def AMPLITUDE_STR_MAX_BUFFER_SIZE
@@ -20,12 +23,36 @@
 #define AMPLITUDE_STR_MAX_BUFFER_SIZE MAIN_SOUND_BUFFER_MAX_BUFFER_SIZE/2+1
 
 /**
- * @brief SpectrumStr structure (amplitude data)
+ * @def SOUND_PROCESSING_MIN_POWER
+ * @brief Smallest bin power converted to dB
+ */
+#define SOUND_PROCESSING_MIN_POWER 1e-20f
+
+/**
+ * @def SOUND_PROCESSING_MIN_MAGNITUDE
+ * @brief Smallest bin magnitude converted to dB (square root of \ref SOUND_PROCESSING_MIN_POWER)
+ */
+#define SOUND_PROCESSING_MIN_MAGNITUDE 1e-10f
+
+/**
+ * @def SOUND_PROCESSING_MIN_DB
+ * @brief Level of the bins below \ref SOUND_PROCESSING_MIN_POWER [dB]
+ */
+#define SOUND_PROCESSING_MIN_DB -200.0f
+
+/**
+ * @brief SpectrumStr structure (amplitude data in \ref SpectrumScaleType scale, timestamp of the
+ * newest sample [us], peaks found in the amplitude data, band levels and MFCC features)
  */
 typedef struct {
 	float32_t amplitudeVector[AMPLITUDE_STR_MAX_BUFFER_SIZE];
 	uint32_t vectorSize;
+	uint32_t scale;
 	float32_t frequencyResolution;
+	uint64_t timestamp;
+	PeakAnalysisStr analysis;
+	BandLevelsStr bands;
+	MfccFeaturesStr features;
 } SpectrumStr;
 
 /**
@@ -38,6 +65,14 @@ typedef struct {
 
 /* Functions */
 void soundProcessingGetAmplitudeInstance(arm_cfft_instance_f32* cfft_instance, SpectrumStr* amplitudeStr, float32_t* sourceBuffer);
+void soundProcessingTransform(arm_cfft_instance_f32* cfft_instance, float32_t* sourceBuffer);
+void soundProcessingGetMagnitude(arm_cfft_instance_f32* cfft_instance, SpectrumStr* amplitudeStr, float32_t* sourceBuffer);
+void soundProcessingGetPower(arm_cfft_instance_f32* cfft_instance, SpectrumStr* amplitudeStr, float32_t* sourceBuffer);
+void soundProcessingApplyScale(SpectrumStr* amplitudeStr, SpectrumScaleType scale);
+void soundProcessingToMagnitude(float32_t* values, uint32_t count, SpectrumScaleType scale);
+void soundProcessingToDb(float32_t* values, uint32_t count, SpectrumScaleType scale);
+float32_t soundProcessingLog2(float32_t value);
+const char* soundProcessingGetScaleName(SpectrumScaleType scale);
 void soundProcessingAmplitudeInit(SpectrumStr* amplitudeStr, SoundBufferStr* soundBuffer, float32_t* destinationBuffer);
 SingleFreqStr soundProcessingGetStrongestFrequency(SpectrumStr* amplitudeStr, uint32_t from, uint32_t to);
 void soundProcessingGetCfftInstance(arm_cfft_instance_f32* instance, uint32_t length);
@@ -0,0 +1,58 @@
+/*
+ * spectrumSnapshot.h
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#ifndef SPECTRUMSNAPSHOT_H_
+#define SPECTRUMSNAPSHOT_H_
+
+#include "stm32f746xx.h"
+#include "stdint.h"
+#include "stddef.h"
+#include "string.h"
+#include "arm_math.h"
+#include "cmsis_os.h"
+#include "soundProcessing.h"
+
+/**
+ * @def SPECTRUM_SNAPSHOT_MAX_RETRIES
+ * @brief How many times the reader repeats copying if the spectrum was changed during the copy
+ */
+#define SPECTRUM_SNAPSHOT_MAX_RETRIES 8
+
+/**
+ * @brief Spectrum published by one writer and read lock-free by many readers (sequence lock).
+ * The sequence is odd while the writer is changing the spectrum.
+ */
+typedef struct {
+	volatile uint32_t sequence;
+	SpectrumStr* spectrum;
+} SpectrumSnapshotStr;
+
+/**
+ * @brief Description of the spectrum part copied by \ref spectrumSnapshotRead. The 64-bit capture
+ * timestamp [us] is split into two words (the structure is sent after 4 byte WebSocket header),
+ * scale is \ref SpectrumScaleType of the bins.
+ */
+typedef struct {
+	uint32_t frameNumber;
+	uint32_t vectorSize;
+	float32_t frequencyResolution;
+	uint32_t from;
+	uint32_t decimation;
+	uint32_t count;
+	uint32_t timestampLow;
+	uint32_t timestampHigh;
+	uint32_t scale;
+} SpectrumSnapshotInfoStr;
+
+/* Functions */
+void spectrumSnapshotInit(SpectrumSnapshotStr* snapshot, SpectrumStr* spectrum);
+void spectrumSnapshotPublish(SpectrumSnapshotStr* snapshot, SpectrumStr* source);
+uint8_t spectrumSnapshotRead(SpectrumSnapshotStr* snapshot, float32_t* destination, uint32_t from, uint32_t to, uint32_t decimation, SpectrumSnapshotInfoStr* info);
+uint8_t spectrumSnapshotReadAnalysis(SpectrumSnapshotStr* snapshot, PeakAnalysisStr* analysis, uint32_t* frameNumber);
+uint8_t spectrumSnapshotReadBands(SpectrumSnapshotStr* snapshot, BandLevelsStr* bands, uint32_t* frameNumber);
+uint8_t spectrumSnapshotReadFeatures(SpectrumSnapshotStr* snapshot, MfccFeaturesStr* features, uint32_t* frameNumber);
+
+#endif /* SPECTRUMSNAPSHOT_H_ */
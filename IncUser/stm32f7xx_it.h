@@ -46,6 +46,7 @@
 #include "cmsis_os.h"
 #include "ethernetif.h"
 #include "lcdLogger.h"
+#include "traceRecorder.h"
 /* Exported types ------------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
@@ -55,6 +56,7 @@ void SysTick_Handler(void);
 void TIM1_UP_TIM10_IRQHandler(void);
 void TIM1_TRG_COM_TIM11_IRQHandler(void);
 void ETH_IRQHandler(void);
+void LTDC_IRQHandler(void);
 void HardFault_Handler(void);
 void UsageFault_Handler(void);
 void BusFault_Handler(void);
@@ -0,0 +1,77 @@
+/*
+ * syslogSink.h
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#ifndef SYSLOGSINK_H_
+#define SYSLOGSINK_H_
+
+#include "stdint.h"
+#include "stdio.h"
+#include "string.h"
+#include "lwip.h"
+#include "lcdLogger.h"
+#include "ethernetLib.h"
+#include "timeBase.h"
+
+/**
+ * @def SYSLOG_DEFAULT_PORT
+ * @brief Default UDP port of the syslog collector
+ */
+#define SYSLOG_DEFAULT_PORT 514
+
+/**
+ * @def SYSLOG_DISABLED_IP
+ * @brief Collector address which turns the sink off (default)
+ */
+#define SYSLOG_DISABLED_IP "0.0.0.0"
+
+/**
+ * @def SYSLOG_FACILITY
+ * @brief Syslog facility of all records (16 - local0)
+ */
+#define SYSLOG_FACILITY 16
+
+/**
+ * @def SYSLOG_APP_NAME
+ * @brief APP-NAME field of the records
+ */
+#define SYSLOG_APP_NAME "stm32spectrum"
+
+/**
+ * @def SYSLOG_DATAGRAM_SIZE
+ * @brief Maximum size of one datagram [bytes] (it fits into one Ethernet frame)
+ */
+#define SYSLOG_DATAGRAM_SIZE 1024
+
+/**
+ * @def SYSLOG_MESSAGE_SIZE
+ * @brief Maximum size of one formatted record [bytes]
+ */
+#define SYSLOG_MESSAGE_SIZE 192
+
+/**
+ * @def SYSLOG_BATCH_TIME
+ * @brief Maximum time the record waits for other records in the datagram [ms]
+ */
+#define SYSLOG_BATCH_TIME 500
+
+/**
+ * @brief Counters of the syslog sink
+ */
+typedef struct {
+	uint32_t sentRecords;
+	uint32_t sentDatagrams;
+	uint32_t failedDatagrams;
+	uint32_t lostRecords;
+} SyslogSinkStatsStr;
+
+/* Functions */
+void syslogSinkInit(const char* hostname);
+uint8_t syslogSinkIsReady();
+uint8_t syslogSinkCollect(const char* ip, uint32_t port);
+err_t syslogSinkSend(const char* ip, uint32_t port);
+void syslogSinkGetStats(SyslogSinkStatsStr* stats);
+
+#endif /* SYSLOGSINK_H_ */
@@ -0,0 +1,33 @@
+/*
+ * timeBase.h
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+#include "stdint.h"
+#include "stm32f746xx.h"
+
+/**
+ * @def TIME_BASE_DWT_UNLOCK_KEY
+ * @brief Key written to DWT lock access register (Cortex-M7 keeps DWT locked after reset)
+ */
+#define TIME_BASE_DWT_UNLOCK_KEY 0xC5ACCE55
+
+/**
+ * @def TIME_BASE_RUN_TIME_SHIFT
+ * @brief CPU cycles are divided by 2^shift to get the FreeRTOS run time counter
+ * (843.75 kHz at 216 MHz, the 32-bit counter wraps every 84 minutes)
+ */
+#define TIME_BASE_RUN_TIME_SHIFT 8
+
+/* Functions */
+void timeBaseInit();
+uint64_t timeBaseGetCycles();
+uint64_t timeBaseGetUs();
+uint64_t timeBaseCyclesToUs(uint64_t cycles);
+uint32_t timeBaseGetRunTimeCounter();
+
+#endif /* TIMEBASE_H_ */
@@ -0,0 +1,124 @@
+/*
+ * traceRecorder.h
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#ifndef TRACERECORDER_H_
+#define TRACERECORDER_H_
+
+#include "stdint.h"
+#include "string.h"
+#include "stm32f746xx.h"
+
+/**
+ * @def TRACE_RECORDER_EVENTS
+ * @brief Number of events held by the ring (power of two, the oldest events are overwritten)
+ */
+#define TRACE_RECORDER_EVENTS 2048
+
+/**
+ * @def TRACE_RECORDER_MAX_OBJECTS
+ * @brief Number of named objects (tasks and registered queues) sent with the trace
+ */
+#define TRACE_RECORDER_MAX_OBJECTS 32
+
+/**
+ * @def TRACE_RECORDER_NAME_LENGTH
+ * @brief Length of the object name sent with the trace (including '\0')
+ */
+#define TRACE_RECORDER_NAME_LENGTH 16
+
+/**
+ * @def TRACE_RECORDER_MAGIC
+ * @brief Marker of the trace download ("STMT")
+ */
+#define TRACE_RECORDER_MAGIC 0x544D5453U
+
+/**
+ * @def TRACE_RECORDER_FORMAT
+ * @brief Layout version of the trace download
+ */
+#define TRACE_RECORDER_FORMAT 1
+
+/**
+ * @brief Types of trace events (id and object of \ref TraceEventStr are described for every type)
+ */
+typedef enum {
+	TRACE_EVENT_NONE = 0,
+	TRACE_EVENT_TASK_SWITCHED_IN, /* id: task number, object: TCB */
+	TRACE_EVENT_TASK_SWITCHED_OUT, /* id: task number, object: TCB */
+	TRACE_EVENT_ISR_ENTER, /* id: exception number (IRQ number + 16) */
+	TRACE_EVENT_ISR_EXIT, /* id: exception number (IRQ number + 16) */
+	TRACE_EVENT_QUEUE_SEND, /* id: queue type (1 = mutex), object: queue (also mutex give) */
+	TRACE_EVENT_QUEUE_SEND_FAILED,
+	TRACE_EVENT_QUEUE_RECEIVE, /* also mutex take */
+	TRACE_EVENT_QUEUE_RECEIVE_FAILED,
+	TRACE_EVENT_QUEUE_BLOCK_SEND, /* the task waits for space in the queue */
+	TRACE_EVENT_QUEUE_BLOCK_RECEIVE /* the task waits for data or mutex */
+} TraceEventType;
+
+/**
+ * @brief Kinds of named objects
+ */
+typedef enum {
+	TRACE_OBJECT_TASK = 0, TRACE_OBJECT_QUEUE
+} TraceObjectKind;
+
+/**
+ * @brief One event of the ring (timestamp is the lower part of \ref timeBaseGetCycles)
+ */
+typedef struct {
+	uint32_t timestamp;
+	uint8_t type;
+	uint8_t reserved;
+	uint16_t id;
+	uint32_t object;
+} TraceEventStr;
+
+/**
+ * @brief Named object (task or queue registered by vQueueAddToRegistry), id is the task number or queue type
+ */
+typedef struct {
+	uint32_t object;
+	uint16_t id;
+	uint8_t kind;
+	uint8_t reserved;
+	char name[TRACE_RECORDER_NAME_LENGTH];
+} TraceObjectStr;
+
+/**
+ * @brief Registered object (copied to \ref TraceObjectStr when the trace is sent). The name
+ * is copied, the TCB of a deleted task is freed and reused by the next one.
+ */
+typedef struct {
+	const void* object;
+	uint16_t id;
+	uint8_t kind;
+	char name[TRACE_RECORDER_NAME_LENGTH];
+} TraceObjectEntryStr;
+
+/**
+ * @brief Header of the trace download, followed by objectCount \ref TraceObjectStr
+ * and eventCount \ref TraceEventStr (the oldest first, little endian)
+ */
+typedef struct {
+	uint32_t magic;
+	uint16_t format;
+	uint16_t eventSize;
+	uint32_t cpuFrequency;
+	uint32_t objectCount;
+	uint32_t eventCount;
+	uint32_t lostEvents;
+} TraceHeaderStr;
+
+/* Functions */
+void traceRecorderWrite(uint32_t type, uint32_t id, const void* object);
+void traceRecorderIsrEnter();
+void traceRecorderIsrExit();
+void traceRecorderRegisterObject(uint32_t kind, const void* object, uint32_t id, const char* name);
+void traceRecorderPause(TraceHeaderStr* header, TraceObjectStr* objects);
+uint32_t traceRecorderGetEvents(uint32_t part, const TraceEventStr** events);
+void traceRecorderResume(uint8_t clear);
+
+#endif /* TRACERECORDER_H_ */
@@ -9,14 +9,24 @@
 #define USRTASKS_H_
 
 #include "lcdLogger.h"
+#include "syslogSink.h"
 #include "ethernetLib.h"
 #include "audioRecording.h"
+#include "levelMeter.h"
 #include "soundProcessing.h"
+#include "spectrumSnapshot.h"
+#include "lcdAmplitudePrinter.h"
+#include "lcdWaterfallPrinter.h"
 #include "mcuConfig.h"
 #include "jsonConfiguration.h"
+#include "configSnapshot.h"
+#include "configStorage.h"
+#include "httpServer.h"
+#include "webSocketServer.h"
 
 #include "usrTaskSupport.h"
 #include "freeRtosSystemInfoSupport.h"
+#include "pipelineStats.h"
 
 #include "cmsis_os.h"
 #include "lwip.h"
@@ -35,21 +45,27 @@ void samplingTask(void const * argument);
 void ethernetTask(void const * argument);
 void streamingTask(void const * argument);
 void httpConfigTask(void const * argument);
+void webSocketTask(void const * argument);
 void initTask(void const * argument);
+void loggerTask(void const * argument);
+void configStorageTask(void const * argument);
 
 /* Delays */
 #ifdef LCD_PRINTER_SUPPORT
-#define LCD_TASK_DELAY_TIME 100
+#define LCD_TASK_DELAY_TIME 16
 #endif
 
 #define INIT_TASK_DELAY_TIME 5000
+#define LOGGER_TASK_DELAY_TIME 50
 #define ETHERNET_TASK_DELAY_TIME 1000
 #define CONNECTION_TASK_DELAY_TIME 10
 #define HTTP_CONFIG_TASK_DELAY_TIME 100
+#define CONFIG_STORAGE_TASK_DELAY_TIME 500
 
 /* Timeouts */
 #define HTTP_HOST_ACCEPT_TIMEOUT 1
 #define HTTP_RECEIVE_TIMEOUT 1500
+#define HTTP_SEND_TIMEOUT 3000
 
 /* Other */
 #define MAXIMUM_DMA_AUDIO_MESSAGE_QUEUE_SIZE 20
@@ -57,5 +73,6 @@ void initTask(void const * argument);
 /* Signals */
 #define DHCP_FINISHED_SIGNAL 0x0001
 #define START_SOUND_PROCESSING_SIGNAL 0x0001
+#define WEBSOCKET_FRAME_READY_SIGNAL 0x0001
 
 #endif /* USRTASKS_H_ */
@@ -0,0 +1,107 @@
+/*
+ * webSocketServer.h
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#ifndef WEBSOCKETSERVER_H_
+#define WEBSOCKETSERVER_H_
+
+#include "stdint.h"
+#include "string.h"
+#include "cmsis_os.h"
+#include "lwip.h"
+#include "lwip/tcp.h"
+#include "lwip/priv/tcpip_priv.h"
+#include "lcdLogger.h"
+#include "ethernetLib.h"
+#include "spectrumSnapshot.h"
+#include "httpRequestParser.h"
+#include "usrTaskSupport.h"
+
+/**
+ * @def WEBSOCKET_MAX_CLIENTS
+ * @brief Maximum number of connected WebSocket clients
+ */
+#define WEBSOCKET_MAX_CLIENTS 2
+
+/**
+ * @def WEBSOCKET_SPECTRUM_BINS
+ * @brief Number of spectrum bins sent in one WebSocket frame (the same as in UDP streaming)
+ */
+#define WEBSOCKET_SPECTRUM_BINS ETHERNET_AMP_BUFFER_SIZE
+
+/**
+ * @def WEBSOCKET_POLL_TIME
+ * @brief Maximum time of waiting for a new spectrum before polling the clients [ms]
+ */
+#define WEBSOCKET_POLL_TIME 50
+
+/**
+ * @def WEBSOCKET_RECEIVE_TIMEOUT
+ * @brief Receive timeout used when polling the clients for control frames [ms]
+ */
+#define WEBSOCKET_RECEIVE_TIMEOUT 1
+
+/**
+ * @def WEBSOCKET_CONTROL_FRAME_MAX_SIZE
+ * @brief Maximum size of the masked control frame sent by the client (header, mask, 125 bytes)
+ */
+#define WEBSOCKET_CONTROL_FRAME_MAX_SIZE 131
+
+/**
+ * @def WEBSOCKET_ACCEPT_KEY_LENGTH
+ * @brief Length of the Sec-WebSocket-Accept value (base64 encoded SHA-1)
+ */
+#define WEBSOCKET_ACCEPT_KEY_LENGTH 28
+
+/**
+ * @def WEBSOCKET_GUID
+ * @brief GUID appended to the client key (RFC 6455)
+ */
+#define WEBSOCKET_GUID "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+/**
+ * @brief WebSocket frame opcodes
+ */
+typedef enum {
+	WEBSOCKET_OPCODE_CONTINUATION = 0x0,
+	WEBSOCKET_OPCODE_TEXT = 0x1,
+	WEBSOCKET_OPCODE_BINARY = 0x2,
+	WEBSOCKET_OPCODE_CLOSE = 0x8,
+	WEBSOCKET_OPCODE_PING = 0x9,
+	WEBSOCKET_OPCODE_PONG = 0xA
+} WebSocketOpcode;
+
+/**
+ * @brief Binary spectrum frame (WebSocket header with 16 bit length and
+ * the same payload as GET /spectrum?format=bin)
+ */
+typedef struct {
+	uint8_t header[4];
+	SpectrumSnapshotInfoStr info;
+	float32_t bins[WEBSOCKET_SPECTRUM_BINS];
+} WebSocketSpectrumFrameStr;
+
+/**
+ * @brief Connected WebSocket client. The part of a frame which did not fit into
+ * the send buffer is kept in pending[] and sent before any other frame
+ * (a frame must never be interleaved with another one).
+ */
+typedef struct {
+	struct netconn* conn;
+	uint32_t lastFrameNumber;
+	uint32_t sentFrames;
+	uint32_t droppedFrames;
+	uint32_t pendingOffset;
+	uint32_t pendingLength;
+	uint8_t pending[sizeof(WebSocketSpectrumFrameStr)];
+} WebSocketClientStr;
+
+/* Functions */
+void webSocketComputeAccept(const char* key, char* accept);
+uint8_t webSocketServerHasFreeSlot();
+uint8_t webSocketServerAddClient(struct netconn* client);
+void webSocketServerProcess(uint8_t frameReady);
+
+#endif /* WEBSOCKETSERVER_H_ */
@@ -13,6 +13,46 @@ static uint32_t audioFreqStat;
 static uint16_t* audioBufferStat;
 static uint32_t audioBufferSizeStat;
 
+/**
+ * @var SAI_HandleTypeDef haudio_out_sai
+ * @brief SAI2 block A (master, it generates the clocks also for recording)
+ */
+extern SAI_HandleTypeDef haudio_out_sai;
+
+/**
+ * @var SAI_HandleTypeDef haudio_in_sai
+ * @brief SAI2 block B (slave receiver synchronous with block A)
+ */
+extern SAI_HandleTypeDef haudio_in_sai;
+
+/**
+ * @var uint32_t rateEpoch
+ * @brief Incremented on each sampling rate change (compared by \ref audioRecorderIsRateBoundary)
+ */
+static volatile uint32_t rateEpoch = 0;
+
+/**
+ * @var uint32_t bufferEpoch
+ * @brief Rate epoch of the last DMA buffer
+ */
+static uint32_t bufferEpoch = 0;
+
+/**
+ * @var AudioRateSwitchStatsStr rateSwitchStats
+ * @brief Statistics of the sampling rate changes
+ */
+static AudioRateSwitchStatsStr rateSwitchStats;
+
+/**
+ * @brief Checks which PLLI2S configuration is used by \ref BSP_AUDIO_OUT_ClockConfig for the frequency
+ * @param frequency: audio sampling frequency
+ * @retval returns 1 for the 44.1 kHz family, 0 for the 48 kHz family
+ */
+static uint8_t isClockFamily44k(uint32_t frequency) {
+	return frequency == AUDIO_FREQUENCY_11K || frequency == AUDIO_FREQUENCY_22K
+			|| frequency == AUDIO_FREQUENCY_44K;
+}
+
 /**
  * @brief Audio recording initialization
  * @param inpuTdevice: AUDIO_RECORDER_INPUT_MICROPHONE or AUDIO_RECORDER_INPUT_LINE
@@ -51,7 +91,7 @@ uint8_t audioRecorderSetVolume(uint8_t volume) {
 }
 
 /**
- * @brief Changes audio sampling frequency
+ * @brief Changes audio sampling frequency (the codec is powered down and initialized again)
  * @param frequency: new audio sampling frequency
  * @retval AUDIO_OK - no errors
  */
@@ -71,7 +111,106 @@ uint8_t audioRecorderSetSamplingFrequency(uint32_t frequency) {
 }
 
 /**
- * @brief Fills the \p soundStructure.
+ * @brief Changes audio sampling frequency without stopping DMA and the codec. SAI blocks are
+ * stopped at the end of frame, PLLI2S (only if the 44.1/48 kHz family is changed), SAI master
+ * clock divider and codec AIF1 rate are set and SAI is started again. The gap is measured
+ * with \ref timeBaseGetCycles.
+ * @param frequency: new audio sampling frequency
+ * @retval AUDIO_OK - no errors, AUDIO_ERROR - SAI did not stop or the codec rejected the rate
+ * (\ref audioRecorderSetSamplingFrequency has to be used)
+ */
+uint8_t audioRecorderSwitchSamplingFrequency(uint32_t frequency) {
+	uint64_t start;
+	uint32_t saiClock;
+	uint32_t divider;
+	uint32_t gap;
+
+	if (frequency == audioFreqStat)
+		return AUDIO_OK;
+
+	start = timeBaseGetCycles();
+	__HAL_SAI_DISABLE(&haudio_in_sai);
+	__HAL_SAI_DISABLE(&haudio_out_sai);
+	while ((haudio_in_sai.Instance->CR1 & SAI_xCR1_SAIEN)
+			|| (haudio_out_sai.Instance->CR1 & SAI_xCR1_SAIEN)) {
+		if (timeBaseCyclesToUs(timeBaseGetCycles() - start)
+				> AUDIO_RECORDER_SAI_STOP_TIMEOUT) {
+			rateSwitchStats.failures++;
+			return AUDIO_ERROR;
+		}
+	}
+
+	if (isClockFamily44k(frequency) != isClockFamily44k(audioFreqStat))
+		BSP_AUDIO_OUT_ClockConfig(&haudio_in_sai, frequency, NULL);
+
+	// MCLK = 256 * FS = SAI_CK / (MCKDIV * 2), rounded the same way as by HAL_SAI_Init
+	saiClock = HAL_RCCEx_GetPeriphCLKFreq(RCC_PERIPHCLK_SAI2);
+	divider = (saiClock * 10) / (frequency * 2 * 256);
+	divider = divider / 10 + ((divider % 10) > 8 ? 1 : 0);
+	haudio_out_sai.Instance->CR1 = (haudio_out_sai.Instance->CR1
+			& ~SAI_xCR1_MCKDIV) | (divider << 20);
+	haudio_out_sai.Init.AudioFrequency = frequency;
+	haudio_out_sai.Init.Mckdiv = divider;
+	haudio_in_sai.Init.AudioFrequency = frequency;
+
+	// SAI is left stopped, the caller initializes the codec again
+	if (wm8994_drv.SetFrequency(AUDIO_I2C_ADDRESS, frequency) != 0) {
+		rateSwitchStats.failures++;
+		return AUDIO_ERROR;
+	}
+
+	// samples received at the old rate are not left in FIFO
+	haudio_in_sai.Instance->CR2 |= SAI_xCR2_FFLUSH;
+
+	// the new rate is visible before the first DMA buffer can be completed
+	audioFreqStat = frequency;
+	rateEpoch++;
+
+	__HAL_SAI_ENABLE(&haudio_out_sai);
+	__HAL_SAI_ENABLE(&haudio_in_sai);
+
+	gap = timeBaseCyclesToUs(timeBaseGetCycles() - start);
+	rateSwitchStats.switches++;
+	rateSwitchStats.lastGapUs = gap;
+	if (gap > rateSwitchStats.maxGapUs)
+		rateSwitchStats.maxGapUs = gap;
+	logMsgVal("Rate switch gap [us] ", gap);
+	return AUDIO_OK;
+}
+
+/**
+ * @brief Returns the current audio sampling frequency (used to tag the recorded samples)
+ * @retval audio sampling frequency
+ */
+uint32_t audioRecorderGetSamplingFrequency() {
+	return audioFreqStat;
+}
+
+/**
+ * @brief Checks if the DMA buffer completed now was recorded partly before the rate change
+ * (called once for each buffer from the DMA interrupt).
+ * @retval returns 1 if the buffer holds samples of two rates and has to be discarded
+ */
+uint8_t audioRecorderIsRateBoundary() {
+	uint32_t epoch = rateEpoch;
+
+	if (epoch == bufferEpoch)
+		return 0;
+	bufferEpoch = epoch;
+	rateSwitchStats.discardedBuffers++;
+	return 1;
+}
+
+/**
+ * @brief Copies the statistics of the sampling rate changes
+ * @param stats: output \ref AudioRateSwitchStatsStr structure
+ */
+void audioRecorderGetRateSwitchStats(AudioRateSwitchStatsStr* stats) {
+	*stats = rateSwitchStats;
+}
+
+/**
+ * @brief Fills the \p soundStructure (the samples are stamped with the current time).
  * @param soundStructure pointer to SoundStr
  * @param audioBuffer 16 bit data array
  * @param audioBufferSize buffer size
@@ -81,6 +220,7 @@ void audioRecordingSoundMailFill(SoundMailStr* soundStructure, uint16_t* audioBu
 	uint32_t iterator;
 	soundStructure->frequency = frequency;
 	soundStructure->soundBufferSize = audioBufferSize;
+	soundStructure->timestamp = timeBaseGetUs();
 
 	for (iterator = 0; iterator < audioBufferSize; iterator++) {
 		soundStructure->soundBuffer[iterator] = audioBuffer[iterator];
@@ -89,12 +229,19 @@ void audioRecordingSoundMailFill(SoundMailStr* soundStructure, uint16_t* audioBu
 
 /**
  * @brief This function updates the sound buffer using "small" sound package of sound mail.
+ * \p soundBuffer->filled counts samples recorded at the current rate.
  * @param soundBuffer: pointer to SoundBuffer (destination)
  * @param SoundMail: pointer to SoundMail (source)
  */
 void audioRecordingUpdateSoundBuffer(SoundBufferStr* soundBuffer, SoundMailStr* soundMail) {
 	uint32_t i;
-	soundBuffer->frequency = soundMail->frequency;
+
+	// samples of the previous rate are dropped, the buffer is filled again
+	if (soundBuffer->frequency != soundMail->frequency) {
+		soundBuffer->frequency = soundMail->frequency;
+		soundBuffer->filled = 0;
+		rateSwitchStats.bufferFlushes++;
+	}
 
 	for (i = 0; i < soundMail->soundBufferSize; i++) {
 		soundBuffer->iterator++;
@@ -103,5 +250,10 @@ void audioRecordingUpdateSoundBuffer(SoundBufferStr* soundBuffer, SoundMailStr*
 		soundBuffer->soundBuffer[soundBuffer->iterator] =
 				soundMail->soundBuffer[i];
 	}
+
+	soundBuffer->timestamp = soundMail->timestamp;
+	soundBuffer->filled += soundMail->soundBufferSize;
+	if (soundBuffer->filled > soundBuffer->size)
+		soundBuffer->filled = soundBuffer->size;
 }
 
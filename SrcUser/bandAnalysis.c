@@ -0,0 +1,216 @@
+/*
+ * bandAnalysis.c
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#include "bandAnalysis.h"
+
+/**
+ * @var BandTableStr bandTable
+ * @brief Tables of the current spectrum size (rebuilt when the sampling frequency changes,
+ * used only by the sound processing task)
+ */
+static BandTableStr bandTable;
+
+/**
+ * @brief Calculates A weighting (IEC 61672-1)
+ * @param frequency: frequency [Hz]
+ * @retval power factor
+ */
+static float32_t getWeightingA(float32_t frequency) {
+	float32_t f2 = frequency * frequency;
+	float32_t gain = 12194.0f * 12194.0f * f2 * f2
+			/ ((f2 + 20.6f * 20.6f)
+					* sqrtf((f2 + 107.7f * 107.7f) * (f2 + 737.9f * 737.9f))
+					* (f2 + 12194.0f * 12194.0f));
+
+	// +2.00 dB normalizes the gain to 0 dB at 1 kHz
+	return gain * gain * 1.58489319f;
+}
+
+/**
+ * @brief Calculates C weighting (IEC 61672-1)
+ * @param frequency: frequency [Hz]
+ * @retval power factor
+ */
+static float32_t getWeightingC(float32_t frequency) {
+	float32_t f2 = frequency * frequency;
+	float32_t gain = 12194.0f * 12194.0f * f2
+			/ ((f2 + 20.6f * 20.6f) * (f2 + 12194.0f * 12194.0f));
+
+	// +0.06 dB normalizes the gain to 0 dB at 1 kHz
+	return gain * gain * 1.01391139f;
+}
+
+/**
+ * @brief Prepares the bin to band tables. Bin k covers frequencies from (k - 0.5) to (k + 0.5)
+ * of the resolution, the DC bin is not used.
+ * @param size: number of bins (up to the sampling frequency)
+ * @param frequencyResolution: frequency resolution [Hz]
+ */
+static void buildTable(uint32_t size, float32_t frequencyResolution) {
+	BandBinsStr* bins;
+	float32_t mid;
+	float32_t low;
+	float32_t high;
+	float32_t edge = powf(BAND_OCTAVE_RATIO, 1.0f / 6.0f);
+	uint32_t band;
+
+	bandTable.vectorSize = size;
+	bandTable.frequencyResolution = frequencyResolution;
+	bandTable.bandCount = 0;
+
+	for (band = 0; band < BAND_THIRD_OCTAVE_COUNT; band++) {
+		mid = bandAnalysisGetMidFrequency(band);
+		bandTable.weightingA[band] = getWeightingA(mid);
+		bandTable.weightingC[band] = getWeightingC(mid);
+
+		// band edges in bin units
+		low = mid / edge / frequencyResolution + 0.5f;
+		high = mid * edge / frequencyResolution + 0.5f;
+		if (low < 1.0f)
+			low = 1.0f;
+		if (high > size / 2)
+			break;
+
+		bins = &bandTable.bands[band];
+		bins->firstBin = (uint32_t) low;
+		bins->lastBin = (uint32_t) high;
+		if (bins->firstBin == bins->lastBin) {
+			bins->firstWeight = high - low;
+			bins->lastWeight = 0.0f;
+		} else {
+			bins->firstWeight = (float32_t) (bins->firstBin + 1) - low;
+			bins->lastWeight = high - (float32_t) bins->lastBin;
+		}
+		bandTable.bandCount++;
+	}
+}
+
+/**
+ * @brief Computes the power of the band
+ * @param power: power spectrum (squared magnitudes)
+ * @param bins: pointer to \ref BandBinsStr
+ * @retval sum of squared magnitudes
+ */
+static float32_t getBandPower(const float32_t* power, const BandBinsStr* bins) {
+	uint32_t span = bins->lastBin - bins->firstBin;
+	float32_t sum = 0.0f;
+
+	// the bins between the edge bins are whole in the band
+	if (span > 1) {
+		arm_mean_f32((float32_t*) &power[bins->firstBin + 1], span - 1, &sum);
+		sum *= span - 1;
+	}
+
+	sum += bins->firstWeight * power[bins->firstBin];
+	if (bins->lastWeight > 0.0f)
+		sum += bins->lastWeight * power[bins->lastBin];
+	return sum;
+}
+
+/**
+ * @brief Converts the power to dB
+ * @param power: sum of squared magnitudes
+ * @retval level [dB]
+ */
+static float32_t toLevel(float32_t power) {
+	if (power <= 0.0f)
+		return BAND_MIN_LEVEL;
+	return 10.0f * log10f(power);
+}
+
+/**
+ * @brief Gets the exact midband frequency of the 1/3-octave band (IEC 61260 base 10 system)
+ * @param band: band number (0 - 25 Hz band)
+ * @retval midband frequency [Hz]
+ */
+float32_t bandAnalysisGetMidFrequency(uint32_t band) {
+	return BAND_REFERENCE_FREQUENCY
+			* powf(BAND_OCTAVE_RATIO,
+					((int32_t) band + BAND_FIRST_INDEX) / 3.0f);
+}
+
+/**
+ * @brief Gets the exact midband frequency of the octave band
+ * @param band: band number (0 - 31.5 Hz band)
+ * @retval midband frequency [Hz]
+ */
+float32_t bandAnalysisGetOctaveMidFrequency(uint32_t band) {
+	return bandAnalysisGetMidFrequency(3 * band + 1);
+}
+
+/**
+ * @brief Computes 1/3-octave, octave and A, C, Z weighted levels of the spectrum. The tables
+ * are prepared again only if the spectrum size or resolution was changed.
+ * @param power: power spectrum (squared magnitudes of bins up to the sampling frequency)
+ * @param size: number of bins
+ * @param frequencyResolution: frequency resolution [Hz]
+ * @param levels: output \ref BandLevelsStr
+ */
+void bandAnalysisProcess(const float32_t* power, uint32_t size,
+		float32_t frequencyResolution, BandLevelsStr* levels) {
+	float32_t powers[BAND_THIRD_OCTAVE_COUNT];
+	float32_t powerZ = 0.0f;
+	float32_t powerA = 0.0f;
+	float32_t powerC = 0.0f;
+	uint32_t band;
+
+	if (bandTable.vectorSize != size
+			|| bandTable.frequencyResolution != frequencyResolution)
+		buildTable(size, frequencyResolution);
+
+	for (band = 0; band < bandTable.bandCount; band++) {
+		powers[band] = getBandPower(power, &bandTable.bands[band]);
+		levels->thirdOctave[band] = toLevel(powers[band]);
+		powerZ += powers[band];
+		powerA += powers[band] * bandTable.weightingA[band];
+		powerC += powers[band] * bandTable.weightingC[band];
+	}
+	for (; band < BAND_THIRD_OCTAVE_COUNT; band++)
+		levels->thirdOctave[band] = BAND_MIN_LEVEL;
+
+	// the octave band holds three 1/3-octave bands (their edges are the same)
+	levels->octaveCount = bandTable.bandCount / 3;
+	for (band = 0; band < BAND_OCTAVE_COUNT; band++) {
+		if (band < levels->octaveCount)
+			levels->octave[band] = toLevel(
+					powers[3 * band] + powers[3 * band + 1]
+							+ powers[3 * band + 2]);
+		else
+			levels->octave[band] = BAND_MIN_LEVEL;
+	}
+
+	levels->bandCount = bandTable.bandCount;
+	levels->levelZ = toLevel(powerZ);
+	levels->levelA = toLevel(powerA);
+	levels->levelC = toLevel(powerC);
+}
+
+/**
+ * @brief Applies the frequency weighting to the 1/3-octave levels and computes the octave
+ * levels again (the levels are published without weighting)
+ * @param levels: \ref BandLevelsStr to change
+ * @param weighting: \ref BandWeightingType
+ */
+void bandAnalysisApplyWeighting(BandLevelsStr* levels,
+		BandWeightingType weighting) {
+	float32_t powers[BAND_THIRD_OCTAVE_COUNT];
+	float32_t mid;
+	uint32_t band;
+
+	if (weighting == BAND_WEIGHTING_Z)
+		return;
+
+	for (band = 0; band < levels->bandCount; band++) {
+		mid = bandAnalysisGetMidFrequency(band);
+		powers[band] = powf(10.0f, levels->thirdOctave[band] / 10.0f)
+				* (weighting == BAND_WEIGHTING_A ?
+						getWeightingA(mid) : getWeightingC(mid));
+		levels->thirdOctave[band] = toLevel(powers[band]);
+	}
+	for (band = 0; band < levels->octaveCount; band++)
+		levels->octave[band] = toLevel(
+				powers[3 * band] + powers[3 * band + 1] + powers[3 * band + 2]);
+}
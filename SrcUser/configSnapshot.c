@@ -0,0 +1,114 @@
+/*
+ * configSnapshot.c
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#include "configSnapshot.h"
+
+/**
+ * @brief Atomically adds the value to the counter (safe in tasks and interrupts)
+ * @param counter: pointer to counter
+ * @param value: added value (may be negative)
+ */
+static void atomicAdd(volatile uint32_t* counter, int32_t value) {
+	do {
+	} while (__STREXW(__LDREXW(counter) + value, counter) != 0);
+}
+
+/**
+ * @brief Initializes the snapshot with the first version of configuration
+ * @param snapshot: pointer to \ref StmConfigSnapshotStr structure
+ * @param config: pointer to initial \ref StmConfig
+ */
+void configSnapshotInit(StmConfigSnapshotStr* snapshot, const StmConfig* config) {
+	memset(snapshot, 0, sizeof(StmConfigSnapshotStr));
+	snapshot->versions[0].config = *config;
+	snapshot->versions[0].version = 1;
+	snapshot->current = &snapshot->versions[0];
+}
+
+/**
+ * @brief Takes the current configuration version without locking (it can be called from interrupt).
+ * The version stays unchanged until \ref configSnapshotRelease is called.
+ * @param snapshot: pointer to \ref StmConfigSnapshotStr structure
+ * @retval pointer to current \ref StmConfigVersionStr
+ */
+const StmConfigVersionStr* configSnapshotAcquire(StmConfigSnapshotStr* snapshot) {
+	StmConfigVersionStr* version;
+
+	for (;;) {
+		version = snapshot->current;
+		atomicAdd(&version->readers, 1);
+		__DMB();
+
+		// the version could be replaced before it was marked as used
+		if (version == snapshot->current)
+			return version;
+		atomicAdd(&version->readers, -1);
+	}
+}
+
+/**
+ * @brief Releases the version taken by \ref configSnapshotAcquire
+ * @param version: pointer to \ref StmConfigVersionStr
+ */
+void configSnapshotRelease(const StmConfigVersionStr* version) {
+	__DMB();
+	atomicAdd(&((StmConfigVersionStr*) version)->readers, -1);
+}
+
+/**
+ * @brief Copies the current configuration
+ * @param snapshot: pointer to \ref StmConfigSnapshotStr structure
+ * @param config: output \ref StmConfig
+ * @retval version number of the copied configuration
+ */
+uint32_t configSnapshotRead(StmConfigSnapshotStr* snapshot, StmConfig* config) {
+	const StmConfigVersionStr* version = configSnapshotAcquire(snapshot);
+	uint32_t versionNumber = version->version;
+
+	*config = version->config;
+	configSnapshotRelease(version);
+	return versionNumber;
+}
+
+/**
+ * @brief Gets the number of current configuration version (subsystems compare it with
+ * the version they were configured with)
+ * @param snapshot: pointer to \ref StmConfigSnapshotStr structure
+ * @retval current version number
+ */
+uint32_t configSnapshotGetVersion(StmConfigSnapshotStr* snapshot) {
+	return snapshot->current->version;
+}
+
+/**
+ * @brief Prepares the next configuration version (current one updated by \ref makeChanges)
+ * and publishes it (the storage task writes it to flash). Only one task may update the configuration.
+ * @param snapshot: pointer to \ref StmConfigSnapshotStr structure
+ * @param newConfig: pointer to changes (fields set to 0 are not changed)
+ * @retval number of published version
+ */
+uint32_t configSnapshotUpdate(StmConfigSnapshotStr* snapshot,
+		StmConfig* newConfig) {
+	StmConfigVersionStr* current = snapshot->current;
+	StmConfigVersionStr* next =
+			current == &snapshot->versions[0] ?
+					&snapshot->versions[1] : &snapshot->versions[0];
+
+	// waiting for readers which still use the previous version
+	while (next->readers != 0)
+		osDelay(CONFIG_SNAPSHOT_GRACE_DELAY);
+
+	next->config = current->config;
+	makeChanges(newConfig, &next->config);
+
+	if (memcmp(&next->config, &current->config, sizeof(StmConfig)) == 0)
+		return current->version;
+
+	next->version = current->version + 1;
+	__DMB();
+	snapshot->current = next;
+	return next->version;
+}
@@ -0,0 +1,300 @@
+/*
+ * configStorage.c
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#include "configStorage.h"
+
+/**
+ * @var ConfigStorageStateStr storageState
+ * @brief Position of the newest record (found by \ref configStorageLoad)
+ */
+static ConfigStorageStateStr storageState;
+
+/**
+ * @var const uint32_t crcTable[]
+ * @brief CRC32 (reflected 0xEDB88320 polynomial) values of 4-bit indexes
+ */
+static const uint32_t crcTable[16] = { 0x00000000, 0x1DB71064, 0x3B6E20C8,
+		0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C, 0xEDB88320,
+		0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278,
+		0xBDBDF21C };
+
+/**
+ * @brief Computes CRC32 of the data
+ * @param data: pointer to data
+ * @param length: data length [bytes]
+ * @retval CRC32 value
+ */
+static uint32_t crc32(const uint8_t* data, uint32_t length) {
+	uint32_t crc = 0xFFFFFFFF;
+
+	while (length-- > 0) {
+		crc ^= *data++;
+		crc = (crc >> 4) ^ crcTable[crc & 0x0F];
+		crc = (crc >> 4) ^ crcTable[crc & 0x0F];
+	}
+	return ~crc;
+}
+
+/**
+ * @brief Gets the address of the record slot
+ * @param sector: index of the log sector
+ * @param slot: index of the slot in the sector
+ * @retval pointer to \ref ConfigStorageRecordStr in flash
+ */
+static const ConfigStorageRecordStr* getRecord(uint32_t sector, uint32_t slot) {
+	return (const ConfigStorageRecordStr*) (uintptr_t) (CONFIG_STORAGE_FIRST_ADDRESS
+			+ sector * CONFIG_STORAGE_SECTOR_SIZE
+			+ slot * CONFIG_STORAGE_RECORD_SIZE);
+}
+
+/**
+ * @brief Checks if the slot was never programmed
+ * @param record: pointer to \ref ConfigStorageRecordStr in flash
+ * @retval returns 1 if all words of the slot are erased
+ */
+static uint8_t isSlotEmpty(const ConfigStorageRecordStr* record) {
+	const uint32_t* word = (const uint32_t*) record;
+	uint32_t i;
+
+	for (i = 0; i < CONFIG_STORAGE_RECORD_SIZE / sizeof(uint32_t); i++) {
+		if (word[i] != 0xFFFFFFFF)
+			return 0;
+	}
+	return 1;
+}
+
+/**
+ * @brief Checks if the whole sector is erased
+ * @param sector: index of the log sector
+ * @retval returns 1 if all words of the sector are erased
+ */
+static uint8_t isSectorErased(uint32_t sector) {
+	const uint32_t* word = (const uint32_t*) getRecord(sector, 0);
+	uint32_t i;
+
+	for (i = 0; i < CONFIG_STORAGE_SECTOR_SIZE / sizeof(uint32_t); i++) {
+		if (word[i] != 0xFFFFFFFF)
+			return 0;
+	}
+	return 1;
+}
+
+/**
+ * @brief Checks if the record is complete (interrupted writes fail the CRC check)
+ * @param record: pointer to \ref ConfigStorageRecordStr
+ * @retval returns 1 if the record can be loaded
+ */
+static uint8_t isRecordValid(const ConfigStorageRecordStr* record) {
+	return record->magic == CONFIG_STORAGE_MAGIC
+			&& record->format == CONFIG_STORAGE_FORMAT
+			&& record->length <= CONFIG_STORAGE_PAYLOAD_SIZE
+			&& record->crc
+					== crc32((const uint8_t*) record,
+							offsetof(ConfigStorageRecordStr, crc));
+}
+
+/**
+ * @brief Finds the first empty slot of the sector. Slots are programmed in order,
+ * so the used slots (also the interrupted ones) are always before the empty slots.
+ * @param sector: index of the log sector
+ * @retval index of the first empty slot (\ref CONFIG_STORAGE_RECORDS_PER_SECTOR if the sector is full)
+ */
+static uint32_t findFirstEmptySlot(uint32_t sector) {
+	uint32_t low = 0;
+	uint32_t high = CONFIG_STORAGE_RECORDS_PER_SECTOR;
+	uint32_t middle;
+
+	while (low < high) {
+		middle = (low + high) / 2;
+		if (isSlotEmpty(getRecord(sector, middle)))
+			high = middle;
+		else
+			low = middle + 1;
+	}
+	return low;
+}
+
+/**
+ * @brief Finds the newest record of the sector (the last one which is valid)
+ * @param sector: index of the log sector
+ * @param firstEmpty: index of the first empty slot of the sector
+ * @retval pointer to \ref ConfigStorageRecordStr in flash (NULL if there is no valid record)
+ */
+static const ConfigStorageRecordStr* findNewestRecord(uint32_t sector,
+		uint32_t firstEmpty) {
+	const ConfigStorageRecordStr* record;
+	uint32_t slot;
+
+	for (slot = firstEmpty; slot > 0; slot--) {
+		record = getRecord(sector, slot - 1);
+		if (isRecordValid(record))
+			return record;
+	}
+	return NULL;
+}
+
+/**
+ * @brief Programs the record to the next free slot. The standby sector is used if the
+ * active one is full (the newest record stays in the old sector until the new one is written).
+ * It is erased here only if \ref configStorageProcess did not erase it in advance.
+ * @param record: pointer to prepared \ref ConfigStorageRecordStr
+ * @retval returns 1 if the record was written
+ */
+static uint8_t writeRecord(const ConfigStorageRecordStr* record) {
+	uint32_t attempt;
+	uint8_t erased;
+
+	for (attempt = 0; attempt < CONFIG_STORAGE_MAX_ATTEMPTS; attempt++) {
+		if (storageState.nextSlot >= CONFIG_STORAGE_RECORDS_PER_SECTOR) {
+			storageState.sector = (storageState.sector + 1)
+					% CONFIG_STORAGE_SECTOR_COUNT;
+			storageState.nextSlot = 0;
+
+			// the previous sector becomes the standby one
+			erased = storageState.standbyErased;
+			storageState.standbyErased = 0;
+			if (!erased) {
+				storageState.erases++;
+				if (!flashDriverEraseSector(
+				CONFIG_STORAGE_FIRST_SECTOR + storageState.sector)) {
+					storageState.failures++;
+					continue;
+				}
+			}
+		}
+
+		if (flashDriverProgram(
+				(uint32_t) (uintptr_t) getRecord(storageState.sector,
+						storageState.nextSlot++), (const uint32_t*) record,
+				sizeof(ConfigStorageRecordStr) / sizeof(uint32_t)))
+			return 1;
+		storageState.failures++;
+	}
+	return 0;
+}
+
+/**
+ * @brief Loads the newest valid configuration from the flash log (called before tasks start)
+ * @param config: configuration to update (it keeps the default values if nothing is stored)
+ * @retval returns 1 if the stored configuration was loaded
+ */
+uint8_t configStorageLoad(StmConfig* config) {
+	const ConfigStorageRecordStr* newest = NULL;
+	const ConfigStorageRecordStr* record;
+	StmConfig stored;
+	uint32_t rejectedFields;
+	uint32_t firstEmpty[CONFIG_STORAGE_SECTOR_COUNT];
+	uint32_t sector;
+
+	memset(&storageState, 0, sizeof(ConfigStorageStateStr));
+
+	for (sector = 0; sector < CONFIG_STORAGE_SECTOR_COUNT; sector++) {
+		firstEmpty[sector] = findFirstEmptySlot(sector);
+		record = findNewestRecord(sector, firstEmpty[sector]);
+		if (record != NULL
+				&& (newest == NULL || record->sequence > newest->sequence)) {
+			newest = record;
+			storageState.sequence = record->sequence;
+			storageState.sector = sector;
+		}
+	}
+	storageState.nextSlot = firstEmpty[storageState.sector];
+
+	if (newest == NULL) {
+		// unknown data in the log is erased before the first record is written
+		storageState.sector = CONFIG_STORAGE_SECTOR_COUNT - 1;
+		storageState.nextSlot = CONFIG_STORAGE_RECORDS_PER_SECTOR;
+	}
+	storageState.standbyErased = isSectorErased(
+			(storageState.sector + 1) % CONFIG_STORAGE_SECTOR_COUNT);
+
+	if (newest == NULL) {
+		logMsg("No stored configuration");
+		return 0;
+	}
+
+	// fields appended after the record was written keep the default values
+	stored = *config;
+	memcpy(&stored, newest->payload,
+			newest->length < sizeof(StmConfig) ?
+					newest->length : sizeof(StmConfig));
+
+	// stored values are checked like PUT /config (the invalid ones keep the default values)
+	rejectedFields = jsonSchemaCopyValid(stmConfigSchema, stmConfigSchemaSize,
+			config, &stored);
+	if (rejectedFields != 0)
+		logErrVal("Stored config rejected fields ", rejectedFields);
+	logMsgVal("Loaded configuration ", storageState.sequence);
+	return 1;
+}
+
+/**
+ * @brief Appends the configuration to the flash log (called by the storage task when
+ * new configuration version was published)
+ * @param config: pointer to \ref StmConfig to store
+ * @retval returns 1 if the configuration was stored
+ */
+uint8_t configStorageSave(const StmConfig* config) {
+	ConfigStorageRecordStr record;
+
+	if (sizeof(StmConfig) > CONFIG_STORAGE_PAYLOAD_SIZE) {
+		logErr("Config too big for storage");
+		return 0;
+	}
+
+	memset(&record, 0, sizeof(ConfigStorageRecordStr));
+	record.magic = CONFIG_STORAGE_MAGIC;
+	record.sequence = storageState.sequence + 1;
+	record.format = CONFIG_STORAGE_FORMAT;
+	record.length = sizeof(StmConfig);
+	memcpy(record.payload, config, sizeof(StmConfig));
+	record.crc = crc32((const uint8_t*) &record,
+			offsetof(ConfigStorageRecordStr, crc));
+
+	if (!writeRecord(&record)) {
+		logErr("Config storage write");
+		return 0;
+	}
+	storageState.sequence = record.sequence;
+	storageState.writes++;
+	return 1;
+}
+
+/**
+ * @brief Erases the standby sector in advance, so \ref configStorageSave does not wait
+ * for the erase when the active sector is full (called by the low priority storage task).
+ * The CPU is still stalled while the sector is erased (at most 500 ms for the 32 KB sector,
+ * once per \ref CONFIG_STORAGE_RECORDS_PER_SECTOR saved configurations).
+ */
+void configStorageProcess() {
+	const ConfigStorageRecordStr* newest;
+
+	if (storageState.standbyErased)
+		return;
+
+	// the standby sector holds the newest record until it is written to the active one
+	if (storageState.sequence != 0) {
+		newest = findNewestRecord(storageState.sector, storageState.nextSlot);
+		if (newest == NULL || newest->sequence != storageState.sequence)
+			return;
+	}
+
+	storageState.erases++;
+	if (flashDriverEraseSector(
+			CONFIG_STORAGE_FIRST_SECTOR
+					+ (storageState.sector + 1) % CONFIG_STORAGE_SECTOR_COUNT))
+		storageState.standbyErased = 1;
+	else
+		storageState.failures++;
+}
+
+/**
+ * @brief Copies the state of the configuration log
+ * @param state: output \ref ConfigStorageStateStr structure
+ */
+void configStorageGetState(ConfigStorageStateStr* state) {
+	*state = storageState;
+}
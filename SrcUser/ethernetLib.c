@@ -13,11 +13,6 @@
  */
 extern ETH_HandleTypeDef EthHandle;
 
-/**
- * @var char httpOkHeaderPattern[]
- * @brief Plain header of 200 HTTP response
- */
-const char httpHeaderPattern[] = "HTTP/1.0 %s\r\nContent-Length: %d%s\r\n\r\n%s";
 /**
  * @brief Used for printing the IP, netmask or gateway address
  * @param gnetif: pointer to \ref netif structure
@@ -69,14 +64,16 @@ uint32_t isEthernetCableConnected() {
  * @brief The function sends the \p ampStr by UDP to \p client.
  * @param ampStr: pointer to \ref AmplitudeStr
  * @param client: pointer to \ref netconn
+ * @param netBuf: pointer to \ref netbuf reused for every datagram
  * @retval returns \ref ERR_OK if there are no errors
  */
-err_t sendSpectrum(SpectrumStr* ampStr, struct netconn *client) {
+err_t sendSpectrum(SpectrumStr* ampStr, struct netconn *client,
+		struct netbuf* netBuf) {
 	err_t status;
 
 	if (client != NULL)
 		if (client->state != NETCONN_CLOSE) {
-			status = udpSend(client, ampStr->amplitudeVector,
+			status = udpSendNetbuf(client, netBuf, ampStr->amplitudeVector,
 			ETHERNET_AMP_BUFFER_SIZE * sizeof(float32_t));
 			if (!isNetconnStatusOk(status))
 				return status;
@@ -84,6 +81,50 @@ err_t sendSpectrum(SpectrumStr* ampStr, struct netconn *client) {
 	return ERR_OK;
 }
 
+/**
+ * @brief The function sends the band levels of \p ampStr by UDP to \p client
+ * (\ref BandLevelsStr as it is, instead of the first \ref ETHERNET_AMP_BUFFER_SIZE bins).
+ * @param ampStr: pointer to \ref SpectrumStr
+ * @param client: pointer to \ref netconn
+ * @param netBuf: pointer to \ref netbuf reused for every datagram
+ * @retval returns \ref ERR_OK if there are no errors
+ */
+err_t sendBands(SpectrumStr* ampStr, struct netconn *client,
+		struct netbuf* netBuf) {
+	err_t status;
+
+	if (client != NULL)
+		if (client->state != NETCONN_CLOSE) {
+			status = udpSendNetbuf(client, netBuf, &ampStr->bands,
+					sizeof(BandLevelsStr));
+			if (!isNetconnStatusOk(status))
+				return status;
+		}
+	return ERR_OK;
+}
+
+/**
+ * @brief The function sends the MFCC features of \p ampStr by UDP to \p client
+ * (\ref MfccFeaturesStr as it is).
+ * @param ampStr: pointer to \ref SpectrumStr
+ * @param client: pointer to \ref netconn
+ * @param netBuf: pointer to \ref netbuf reused for every datagram
+ * @retval returns \ref ERR_OK if there are no errors
+ */
+err_t sendFeatures(SpectrumStr* ampStr, struct netconn *client,
+		struct netbuf* netBuf) {
+	err_t status;
+
+	if (client != NULL)
+		if (client->state != NETCONN_CLOSE) {
+			status = udpSendNetbuf(client, netBuf, &ampStr->features,
+					sizeof(MfccFeaturesStr));
+			if (!isNetconnStatusOk(status))
+				return status;
+		}
+	return ERR_OK;
+}
+
 /**
  * @brief The functions checks the returned \ref err_t because sometimes LWIP functions returns \ref ERR_RST if the ethernet cable is disconnected.
  * @param status: error code
@@ -116,85 +157,153 @@ err_t udpSend(struct netconn *client, void* buf, uint32_t buffSize) {
 }
 
 /**
- * @brief Returns the request type
- * @param buf: pointer to \ref netbuf structure
- * @retval GET_REQUEST, PUT_REQUEST or NOT_SUPPORTED_REQUEST
- */
-HttpRequestType getRequestType(char* fullMsg) {
-	if (strstr(fullMsg, "GET") != NULL)
-		return GET_REQUEST;
-	else if (strstr(fullMsg, "PUT") != NULL)
-		return PUT_REQUEST;
-	else
-		return NOT_SUPPORTED_REQUEST;
+ * @brief Sends the buffer \p buf to \p client by UDP using already allocated \p netBuf.
+ * The data is sent by reference (it is not copied to the lwIP heap).
+ * @param client: pointer to \ref netconn
+ * @param netBuf: pointer to \ref netbuf (the previous reference is released)
+ * @param buf: pointer to the beginning of data
+ * @param buffSize: data length
+ * @retval returns \ref ERR_OK if there are no errors
+ */
+err_t udpSendNetbuf(struct netconn *client, struct netbuf* netBuf, void* buf,
+		uint32_t buffSize) {
+	err_t err;
+
+	if (netBuf == NULL)
+		return udpSend(client, buf, buffSize);
+
+	err = netbuf_ref(netBuf, buf, buffSize);
+	if (err != ERR_OK)
+		return err;
+	return netconn_send(client, netBuf);
 }
 
 /**
- * @brief Sends the device configuration to the client
- * @param config: pointer to \ref StmConfig structure
- * @param client: pointer to \ref netconn structure (represents endpoint client)
- * @param requestParameters: HTTP request parameters
- * @retval ERR_OK if there are no errors
+ * @brief "Connects" the UDP socket to the address from configuration only if it was changed
+ * @param client: pointer to \ref netconn
+ * @param connection: pointer to \ref UdpConnectionStr holding the current address
+ * @param ip: client IP address (text)
+ * @param port: client port
+ * @retval returns \ref ERR_OK if there are no errors
  */
-err_t sendConfiguration(StmConfig* config, struct netconn* client, char* requestParameters) {
-	char configContent[256];
-	stmConfigToString(config, configContent, 256);
-	return sendHttpResponse(client, "200 OK", requestParameters, configContent);
+err_t udpConnectIfChanged(struct netconn *client, UdpConnectionStr* connection,
+		const char* ip, uint32_t port) {
+	int ipTab[4];
+	ip_addr_t addr;
+	err_t err;
+
+	if (connection->connected && connection->port == port
+			&& strcmp(connection->ip, ip) == 0)
+		return ERR_OK;
+
+	sscanf(ip, "%d.%d.%d.%d", &ipTab[0], &ipTab[1], &ipTab[2], &ipTab[3]);
+	IP_ADDR4(&addr, ipTab[0], ipTab[1], ipTab[2], ipTab[3]);
+	err = netconn_connect(client, &addr, port);
+	if (err != ERR_OK) {
+		connection->connected = 0;
+		return err;
+	}
+
+	strncpy(connection->ip, ip, sizeof(connection->ip) - 1);
+	connection->ip[sizeof(connection->ip) - 1] = '\0';
+	connection->port = port;
+	connection->connected = 1;
+	return ERR_OK;
 }
 
 /**
- * @brief Sends HTTP response
- * @param client: pointer \ref netconn network structure
- * @param httpStatus: HTTP status
- * @param requestParameters: HTTP request parameters
- * @param content: HTTP content
- * @retval ERR_OK if there are no errors
+ * @brief Clears the UDP streaming statistics
+ * @param stats: pointer to \ref UdpStreamingStatsStr structure
  */
-err_t sendHttpResponse(struct netconn* client, char* httpStatus, char* requestParameters, char* content) {
-	char response[1024];
-	sprintf(response, httpHeaderPattern, httpStatus, strlen(content),
-			requestParameters, content);
-	return sendString(client, response);
+void udpStreamingStatsInit(UdpStreamingStatsStr* stats) {
+	memset(stats, 0, sizeof(UdpStreamingStatsStr));
+	stats->windowStart = osKernelSysTick();
 }
 
 /**
- * @brief Sends string by TCP
- * @param client: pointer \ref netconn network structure
- * @param array: string to send
- * @retval ERR_OK if there are no errors
+ * @brief Counts the sent datagram and updates the throughput (datagrams per second)
+ * once per \ref UDP_STREAMING_STATS_WINDOW
+ * @param stats: pointer to \ref UdpStreamingStatsStr structure
+ * @param status: status returned by send function
+ * @param length: datagram length
  */
-err_t sendString(struct netconn* client, const char* array) {
-	return netconn_write(client, array, strlen(array), NETCONN_NOCOPY);
+void udpStreamingStatsUpdate(UdpStreamingStatsStr* stats, err_t status,
+		uint32_t length) {
+	uint32_t now = osKernelSysTick();
+	uint32_t elapsed;
+
+	if (status == ERR_OK) {
+		stats->sentDatagrams++;
+		stats->sentBytes += length;
+		stats->windowDatagrams++;
+	} else {
+		stats->failedDatagrams++;
+	}
+
+	elapsed = now - stats->windowStart;
+	if (elapsed >= UDP_STREAMING_STATS_WINDOW * osKernelSysTickFrequency / 1000) {
+		stats->datagramsPerSecond = (uint32_t) ((uint64_t) stats->windowDatagrams
+				* osKernelSysTickFrequency / elapsed);
+		if (stats->datagramsPerSecond > stats->maxDatagramsPerSecond)
+			stats->maxDatagramsPerSecond = stats->datagramsPerSecond;
+		stats->windowDatagrams = 0;
+		stats->windowStart = now;
+	}
 }
 
 /**
- * @brief Extracts data from network buffer
- * @param strBuffer: output string data buffer
- * @param buf: network buffer
+ * @brief Formats the UDP streaming statistics as JSON
+ * @param stats: pointer to \ref UdpStreamingStatsStr structure
+ * @param str: output string
+ * @param len: output buffer size
  */
-void getDataFromBuffer(char* strBuffer, struct netbuf* buf)
-{
-	void* data;
-	uint16_t length;
-	netbuf_data(buf, &data, &length);
-
-	strcpy(strBuffer, (char*) data);
+void udpStreamingStatsToString(UdpStreamingStatsStr* stats, char* str,
+		uint32_t len) {
+	snprintf(str, len,
+			"{\"MemoryProfile\":%d,\"CoreLocking\":%d,\"SentDatagrams\":%lu,"
+					"\"FailedDatagrams\":%lu,\"SentBytes\":%lu,"
+					"\"DatagramsPerSecond\":%lu,\"MaxDatagramsPerSecond\":%lu}",
+			LWIP_MEMORY_PROFILE, LWIP_TCPIP_CORE_LOCKING,
+			(unsigned long) stats->sentDatagrams,
+			(unsigned long) stats->failedDatagrams,
+			(unsigned long) stats->sentBytes,
+			(unsigned long) stats->datagramsPerSecond,
+			(unsigned long) stats->maxDatagramsPerSecond);
 }
 
 /**
- * @brief Check if the request includes '/config' text
- * @param buf: pointer to \ref netbuf structure
- * @retval 1 if request includes '/config'
+ * @brief Sends the device configuration to the client
+ * @param config: pointer to \ref StmConfig structure
+ * @param client: pointer to \ref netconn structure (represents endpoint client)
+ * @param requestParameters: additional HTTP headers (each one preceded by "\r\n")
+ * @retval ERR_OK if there are no errors
  */
-uint8_t isConfigRequest(char* buf) {
-	return (strstr(buf, " /config ")!=NULL);
+err_t sendConfiguration(StmConfig* config, struct netconn* client, char* requestParameters) {
+	HttpResponseStr response;
+	JsonWriterStr writer;
+	char configContent[256];
+
+	httpResponseInit(&response, client, "200 OK");
+	httpResponseAddHeader(&response, "Content-Type", "application/json");
+	httpResponseAddHeader(&response, "Connection", "close");
+	httpResponseAddRawHeaders(&response, requestParameters);
+
+	// the JSON is sent in chunks (it grows with every configuration field)
+	jsonWriterInitResponse(&writer, configContent, sizeof(configContent),
+			&response);
+	jsonWriterSchemaObject(&writer, stmConfigSchema, stmConfigSchemaSize,
+			config);
+	if (!jsonWriterFinish(&writer))
+		logErr("Config JSON error");
+	return httpResponseEnd(&response);
 }
 
 /**
- * @brief Check if the request includes '/system' text
- * @param buf: pointer to \ref netbuf structure
- * @retval returns 1 if request includes '/system'
+ * @brief Sends string by TCP
+ * @param client: pointer \ref netconn network structure
+ * @param array: string to send
+ * @retval ERR_OK if there are no errors
  */
-uint8_t isSystemRequest(char* buf) {
-	return (strstr(buf, " /system ")!=NULL);
+err_t sendString(struct netconn* client, const char* array) {
+	return netconn_write(client, array, strlen(array), NETCONN_COPY);
 }
@@ -0,0 +1,96 @@
+/*
+ * flashDriver.c
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#include "flashDriver.h"
+
+/**
+ * @brief Unlocks the flash control register
+ */
+static void flashUnlock() {
+	if (FLASH->CR & FLASH_CR_LOCK) {
+		FLASH->KEYR = FLASH_DRIVER_KEY1;
+		FLASH->KEYR = FLASH_DRIVER_KEY2;
+	}
+}
+
+/**
+ * @brief Locks the flash control register
+ */
+static void flashLock() {
+	FLASH->CR |= FLASH_CR_LOCK;
+}
+
+/**
+ * @brief Waits for the end of the flash operation and clears its status flags
+ * @retval returns 1 if the operation succeeded
+ */
+static uint8_t flashWait() {
+	uint32_t status;
+
+	__DSB();
+	while (FLASH->SR & FLASH_SR_BSY)
+		;
+
+	status = FLASH->SR;
+	FLASH->SR = status & (FLASH_DRIVER_ERROR_FLAGS | FLASH_SR_EOP);
+	return (status & FLASH_DRIVER_ERROR_FLAGS) == 0;
+}
+
+/**
+ * @brief Erases the flash sector. The CPU is stalled while it reads the flash during the erase
+ * (x32 parallelism: typically 250 ms, at most 500 ms for 32 KB sector; 2 s / 4 s for 256 KB one).
+ * @param sector: sector number
+ * @retval returns 1 if the sector was erased
+ */
+uint8_t flashDriverEraseSector(uint32_t sector) {
+	uint8_t ok;
+
+	flashUnlock();
+	if (!flashWait()) {
+		flashLock();
+		return 0;
+	}
+
+	FLASH->CR &= ~(FLASH_CR_PSIZE | FLASH_CR_SNB);
+	FLASH->CR |= FLASH_CR_PSIZE_1 | FLASH_CR_SER | (sector * FLASH_CR_SNB_0);
+	FLASH->CR |= FLASH_CR_STRT;
+	ok = flashWait();
+
+	FLASH->CR &= ~(FLASH_CR_SER | FLASH_CR_SNB);
+	flashLock();
+	return ok;
+}
+
+/**
+ * @brief Programs the erased flash with 32-bit words and verifies them
+ * @param address: flash address (aligned to 4 bytes)
+ * @param data: words to program
+ * @param words: number of words
+ * @retval returns 1 if all words were programmed
+ */
+uint8_t flashDriverProgram(uint32_t address, const uint32_t* data,
+		uint32_t words) {
+	volatile uint32_t* destination = (volatile uint32_t*) address;
+	uint8_t ok = 1;
+	uint32_t i;
+
+	flashUnlock();
+	if (!flashWait()) {
+		flashLock();
+		return 0;
+	}
+
+	FLASH->CR &= ~FLASH_CR_PSIZE;
+	FLASH->CR |= FLASH_CR_PSIZE_1 | FLASH_CR_PG;
+	for (i = 0; i < words && ok; i++) {
+		destination[i] = data[i];
+		ok = flashWait() && destination[i] == data[i];
+	}
+
+	FLASH->CR &= ~FLASH_CR_PG;
+	flashLock();
+	return ok;
+}
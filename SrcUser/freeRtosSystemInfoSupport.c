@@ -7,161 +7,179 @@
 
 #include "freeRtosSystemInfoSupport.h"
 
-extern uint16_t tim6OverflowCount;
-
 /**
- * @brief Create task usage JSON string
- * @param jsonData: output JSON task usage string
+ * @var TaskStatus_t taskStatusArray[]
+ * @brief Task states copied from FreeRTOS (used instead of vTaskGetRunTimeStats which allocates memory)
  */
-void getTaskUsageDetails(char* jsonData) {
-	char detailsStr[256];
-	vTaskGetRunTimeStats(detailsStr);
-	parseTaskUsage(detailsStr, jsonData);
-}
+static TaskStatus_t taskStatusArray[SYSTEM_INFO_MAX_TASKS];
 
 /**
- * @brief Configures Timer 6 for task usage analysis
+ * @var uint32_t contextSwitches[]
+ * @brief Number of switches to the task (indexed by FreeRTOS task number)
  */
-void configureTimerForRuntimestats() {
-	MX_TIM11_Init();
-}
+static volatile uint32_t contextSwitches[SYSTEM_INFO_MAX_TASK_NUMBER];
 
 /**
- * @brief Gets Timer 6 value (converted to 32 bit value)
- * @retval 32 bit timer value
+ * @var uint64_t runCycles[]
+ * @brief CPU cycles used by the task (indexed by FreeRTOS task number, 64-bit values do not wrap)
  */
-uint32_t getTimVal() {
-	return ((tim6OverflowCount << 16) | TIM11->CNT);
-}
+static uint64_t runCycles[SYSTEM_INFO_MAX_TASK_NUMBER];
 
 /**
- * @brief Parses string from FreeRTOS to JSON format
- * @param detailsStr: FreeRTOS task usage string
- * @param jsonData: output JSON formatted string
+ * @var uint64_t switchedInCycles
+ * @brief Time base value when the current task was switched in
  */
-void parseTaskUsage(char* detailsStr, char* jsonData) {
-
-	cJSON *jsonCreator;
-	jsonCreator = cJSON_CreateArray();
-	cJSON *arrayObject;
+static uint64_t switchedInCycles = 0;
 
-	uint32_t length = strlen(detailsStr);
-	uint32_t iterator = 0;
-	uint32_t countIterator = 0;
-
-	char tempStr[32];
-	uint32_t tempIterator = 0;
-
-	while (iterator < length) {
-		cJSON_AddItemToArray(jsonCreator, arrayObject = cJSON_CreateObject());
-
-		ignoreWhitespace(&iterator, detailsStr);
-
-		// Parsing taskname
-		tempIterator = 0;
-		while (!isWhitespace(detailsStr[iterator]) && iterator < length) {
-			tempStr[tempIterator++] = detailsStr[iterator++];
-		}
-		tempStr[tempIterator] = '\0';
-		cJSON_AddStringToObject(arrayObject, "taskName", tempStr);
-
-		ignoreWhitespace(&iterator, detailsStr);
-
-		// Parsing memory
-		tempIterator = 0;
-		while (isDigit(detailsStr[iterator]) && iterator < length) {
-			tempStr[tempIterator++] = detailsStr[iterator++];
-		}
-		tempStr[tempIterator] = '\0';
-		uint32_t memoryUsage = atoi(tempStr);
-
-		cJSON_AddNumberToObject(arrayObject, "memory", memoryUsage);
-
-		ignoreWhitespace(&iterator, detailsStr);
-
-		// Parsing usage
-		tempIterator = 0;
-		while (!isWhitespace(detailsStr[iterator]) && iterator < length) {
-			tempStr[tempIterator++] = detailsStr[iterator++];
-		}
-		tempStr[tempIterator] = '\0';
+/**
+ * @var uint64_t previousRunTime[]
+ * @brief Task run time at the previous profile (indexed by FreeRTOS task number) [us]
+ */
+static uint64_t previousRunTime[SYSTEM_INFO_MAX_TASK_NUMBER];
 
-		cJSON_AddStringToObject(arrayObject, "usage", tempStr);
+/**
+ * @var uint32_t previousContextSwitches[]
+ * @brief Context switches at the previous profile (indexed by FreeRTOS task number)
+ */
+static uint32_t previousContextSwitches[SYSTEM_INFO_MAX_TASK_NUMBER];
 
-		ignoreWhitespace(&iterator, detailsStr);
-		countIterator++;
-	}
+/**
+ * @var uint64_t previousTotalRunTime
+ * @brief Total run time at the previous profile [us]
+ */
+static uint64_t previousTotalRunTime = 0;
 
-	char* json = cJSON_Print(jsonCreator);
-	strcpy(jsonData, json);
-	cJSON_Delete(jsonCreator);
-	free(json);
-}
+/**
+ * @var const char* taskStateNames[]
+ * @brief Names of eTaskState values
+ */
+static const char* taskStateNames[] = { "Running", "Ready", "Blocked",
+		"Suspended", "Deleted" };
 
 /**
- * @brief Iterates while character is not a whitespace
- * @param iterator: pointer to iterator
- * @param str: pointer to string
+ * @brief Counts the context switch (traceTASK_SWITCHED_IN hook called by the scheduler)
+ * @param taskNumber: FreeRTOS task number of the task which is switched in
  */
-void ignoreWhitespace(uint32_t* iterator, char* str) {
-	uint32_t length = strlen(str);
-	while (isWhitespace(str[*iterator]) && *iterator < length) {
-		*iterator = *iterator + 1;
-	}
+void systemInfoTaskSwitchedIn(uint32_t taskNumber) {
+	if (taskNumber < SYSTEM_INFO_MAX_TASK_NUMBER)
+		contextSwitches[taskNumber]++;
+	switchedInCycles = timeBaseGetCycles();
 }
 
 /**
- * @brief Counts number of lines in string
- * @param str: string object
- * @retval number of lines
+ * @brief Adds the time slice to the task run time (traceTASK_SWITCHED_OUT hook called by the scheduler)
+ * @param taskNumber: FreeRTOS task number of the task which is switched out
  */
-uint32_t countNumberOfLines(char* str) {
-	uint32_t len = strlen(str);
-	uint32_t count = 0;
-
-	for (uint32_t i = 0; i < len; i++) {
-		if (str[i] == '\n') {
-			count++;
-		}
-	}
-
-	return count;
+void systemInfoTaskSwitchedOut(uint32_t taskNumber) {
+	if (taskNumber < SYSTEM_INFO_MAX_TASK_NUMBER)
+		runCycles[taskNumber] += timeBaseGetCycles() - switchedInCycles;
 }
 
 /**
- * @brief Checks if character is a digit
- * @param character: character to check
- * @retval returns 1 if is a digit
+ * @brief FreeRTOS tick hook (the time base has to be read at least once per DWT counter wrap)
  */
-uint8_t isDigit(char character) {
-	return character >= '0' && character <= '9';
+void vApplicationTickHook() {
+	timeBaseGetCycles();
 }
 
 /**
- * @brief Checks if character is a whitespace
- * @param character: character to check
- * @retval returns 1 if is a whitespace
+ * @brief Profiles all tasks (run time, CPU usage and context switches since the previous profile,
+ * stack high water mark, state and priority)
+ * @param header: output \ref SystemInfoHeaderStr structure
+ * @param tasks: output array of \ref SYSTEM_INFO_MAX_TASKS \ref SystemInfoTaskStr structures
+ * @retval number of profiled tasks (0 if there are too many tasks)
  */
-uint8_t isWhitespace(char character) {
-	return character == ' ' || character == '\n' || character == '\r'
-			|| character == '\t';
+uint32_t systemInfoCollect(SystemInfoHeaderStr* header, SystemInfoTaskStr* tasks) {
+	UBaseType_t taskCount;
+	uint32_t number;
+	UBaseType_t i;
+
+	memset(header, 0, sizeof(SystemInfoHeaderStr));
+	taskCount = uxTaskGetSystemState(taskStatusArray, SYSTEM_INFO_MAX_TASKS,
+			NULL);
+	if (taskCount == 0) {
+		logErrVal("Too many tasks ", uxTaskGetNumberOfTasks());
+		return 0;
+	}
+
+	header->taskCount = taskCount;
+	header->totalRunTime = timeBaseGetUs();
+	header->windowRunTime = header->totalRunTime - previousTotalRunTime;
+	previousTotalRunTime = header->totalRunTime;
+
+	for (i = 0; i < taskCount; i++) {
+		memset(&tasks[i], 0, sizeof(SystemInfoTaskStr));
+		strncpy(tasks[i].name, taskStatusArray[i].pcTaskName,
+				configMAX_TASK_NAME_LEN - 1);
+		number = taskStatusArray[i].xTaskNumber;
+		tasks[i].taskNumber = number;
+		tasks[i].stackHighWaterMark = taskStatusArray[i].usStackHighWaterMark;
+		tasks[i].state = taskStatusArray[i].eCurrentState;
+		tasks[i].currentPriority = taskStatusArray[i].uxCurrentPriority;
+		tasks[i].basePriority = taskStatusArray[i].uxBasePriority;
+
+		if (number < SYSTEM_INFO_MAX_TASK_NUMBER) {
+			tasks[i].runTime = timeBaseCyclesToUs(runCycles[number]);
+			tasks[i].contextSwitches = contextSwitches[number];
+			tasks[i].windowRunTime = tasks[i].runTime - previousRunTime[number];
+			tasks[i].windowContextSwitches = tasks[i].contextSwitches
+					- previousContextSwitches[number];
+			previousRunTime[number] = tasks[i].runTime;
+			previousContextSwitches[number] = tasks[i].contextSwitches;
+		}
+
+		// usage in the window [0.01 %]
+		if (header->windowRunTime > 0)
+			tasks[i].usage = (tasks[i].windowRunTime * 10000)
+					/ header->windowRunTime;
+	}
+	return taskCount;
 }
 
 /**
- * @brief Checks if character is a percent
- * @param character: character to check
- * @retval returns 1 if is a percent
+ * @brief Writes task profile JSON array (one object for every task)
+ * @param writer: pointer to \ref JsonWriterStr structure
+ * @param taskProfiles: array of \ref SYSTEM_INFO_MAX_TASKS \ref SystemInfoTaskStr structures (working buffer)
+ * @retval returns 1 if all tasks were written
  */
-uint8_t isPercent(char character) {
-	return character == '%';
+uint8_t getTaskUsageDetails(JsonWriterStr* writer,
+		SystemInfoTaskStr* taskProfiles) {
+	SystemInfoHeaderStr header;
+	uint32_t taskCount;
+	uint32_t i;
+
+	jsonWriterBeginArray(writer);
+
+	taskCount = systemInfoCollect(&header, taskProfiles);
+	for (i = 0; i < taskCount; i++) {
+		jsonWriterBeginObject(writer);
+		jsonWriterAddString(writer, "taskName", taskProfiles[i].name);
+		jsonWriterAddUint(writer, "taskNumber", taskProfiles[i].taskNumber);
+		jsonWriterAddString(writer, "state",
+				taskProfiles[i].state <= eDeleted ?
+						taskStateNames[taskProfiles[i].state] : "Unknown");
+		jsonWriterAddUint(writer, "priority", taskProfiles[i].currentPriority);
+		jsonWriterAddUint(writer, "basePriority", taskProfiles[i].basePriority);
+		jsonWriterAddUint64(writer, "runTime", taskProfiles[i].runTime);
+		jsonWriterAddUint64(writer, "windowRunTime",
+				taskProfiles[i].windowRunTime);
+		jsonWriterAddFloat(writer, "usage", taskProfiles[i].usage / 100.0f);
+		jsonWriterAddUint(writer, "contextSwitches",
+				taskProfiles[i].contextSwitches);
+		jsonWriterAddUint(writer, "windowContextSwitches",
+				taskProfiles[i].windowContextSwitches);
+		jsonWriterAddUint(writer, "stackHighWaterMark",
+				taskProfiles[i].stackHighWaterMark);
+		jsonWriterEndObject(writer);
+	}
+
+	jsonWriterEndArray(writer);
+	return taskCount > 0;
 }
 
 /**
- * @brief Checks if character is a 'less than'
- * @param character: character to check
- * @retval returns 1 if is a 'less than'
+ * @brief Starts the time base used for task run time statistics (called by vTaskStartScheduler)
  */
-uint8_t isLessThan(char character) {
-	return character == '<';
+void configureTimerForRuntimestats() {
+	timeBaseInit();
 }
-
@@ -0,0 +1,397 @@
+/*
+ * httpRequestParser.c
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#include "httpRequestParser.h"
+
+/**
+ * @brief Compares two strings ignoring the letter case
+ * @param str1: first string
+ * @param str2: second string
+ * @retval returns 1 if strings are equal
+ */
+static uint8_t equalsIgnoreCase(const char* str1, const char* str2) {
+	while (*str1 != '\0' && *str2 != '\0') {
+		char c1 = *str1++;
+		char c2 = *str2++;
+		if (c1 >= 'A' && c1 <= 'Z')
+			c1 += 'a' - 'A';
+		if (c2 >= 'A' && c2 <= 'Z')
+			c2 += 'a' - 'A';
+		if (c1 != c2)
+			return 0;
+	}
+	return *str1 == *str2;
+}
+
+/**
+ * @brief Switches the parser to the error state
+ * @param request: pointer to \ref HttpRequestStr structure
+ * @param error: reason of the error
+ * @retval \ref HTTP_PARSE_ERROR
+ */
+static HttpParseStatus setError(HttpRequestStr* request, HttpParseError error) {
+	request->state = HTTP_PARSER_ERROR;
+	request->error = error;
+	return HTTP_PARSE_ERROR;
+}
+
+/**
+ * @brief Appends a character to the token buffer
+ * @param token: token buffer
+ * @param maxLength: maximum token length (without '\0')
+ * @param tokenLength: pointer to current token length
+ * @param character: character to append
+ * @retval returns 0 if the token is too long
+ */
+static uint8_t appendToken(char* token, uint32_t maxLength,
+		uint32_t* tokenLength, char character) {
+	if (*tokenLength >= maxLength)
+		return 0;
+	token[(*tokenLength)++] = character;
+	token[*tokenLength] = '\0';
+	return 1;
+}
+
+/**
+ * @brief Encodes the method token
+ * @param methodStr: method token
+ * @retval GET_REQUEST, PUT_REQUEST or NOT_SUPPORTED_REQUEST
+ */
+static HttpRequestType encodeMethod(const char* methodStr) {
+	if (strcmp(methodStr, "GET") == 0)
+		return GET_REQUEST;
+	else if (strcmp(methodStr, "PUT") == 0)
+		return PUT_REQUEST;
+	else
+		return NOT_SUPPORTED_REQUEST;
+}
+
+/**
+ * @brief Checks if the header is used by the server (other headers are skipped)
+ * @param name: header name
+ * @retval returns 1 if the header value is stored by \ref processHeader
+ */
+static uint8_t isKnownHeader(const char* name) {
+	return equalsIgnoreCase(name, "Content-Length")
+			|| equalsIgnoreCase(name, "Upgrade")
+			|| equalsIgnoreCase(name, "Sec-WebSocket-Key");
+}
+
+/**
+ * @brief Handles a complete header line (only the known headers are stored)
+ * @param request: pointer to \ref HttpRequestStr structure
+ * @retval returns 0 if the header value is invalid
+ */
+static uint8_t processHeader(HttpRequestStr* request) {
+	if (equalsIgnoreCase(request->headerName, "Content-Length")) {
+		uint32_t value = 0;
+		char* it = request->headerValue;
+
+		if (*it == '\0')
+			return 0;
+		while (*it != '\0') {
+			if (*it < '0' || *it > '9' || value > 100000)
+				return 0;
+			value = value * 10 + (*it++ - '0');
+		}
+		request->contentLength = value;
+	} else if (equalsIgnoreCase(request->headerName, "Upgrade")) {
+		request->webSocketUpgrade = equalsIgnoreCase(request->headerValue,
+				"websocket");
+	} else if (equalsIgnoreCase(request->headerName, "Sec-WebSocket-Key")) {
+		if (strlen(request->headerValue) > HTTP_REQUEST_MAX_WEBSOCKET_KEY_LENGTH)
+			return 0;
+		strcpy(request->webSocketKey, request->headerValue);
+	}
+	return 1;
+}
+
+/**
+ * @brief Called after the empty line which ends the header section
+ * @param request: pointer to \ref HttpRequestStr structure
+ * @retval current parse status
+ */
+static HttpParseStatus finishHeaders(HttpRequestStr* request) {
+	if (request->contentLength > HTTP_REQUEST_MAX_BODY_SIZE)
+		return setError(request, HTTP_PARSE_ERROR_BODY_TOO_LARGE);
+
+	if (request->contentLength == 0) {
+		request->state = HTTP_PARSER_DONE;
+		return HTTP_PARSE_DONE;
+	}
+
+	request->state = HTTP_PARSER_BODY;
+	return HTTP_PARSE_INCOMPLETE;
+}
+
+/**
+ * @brief Initializes the request structure before parsing a new request
+ * @param request: pointer to \ref HttpRequestStr structure
+ */
+void httpRequestParserInit(HttpRequestStr* request) {
+	request->state = HTTP_PARSER_METHOD;
+	request->error = HTTP_PARSE_ERROR_NONE;
+	request->method = NOT_SUPPORTED_REQUEST;
+	request->methodStr[0] = '\0';
+	request->path[0] = '\0';
+	request->query[0] = '\0';
+	request->headerName[0] = '\0';
+	request->headerValue[0] = '\0';
+	request->headerValueTruncated = 0;
+	request->tokenLength = 0;
+	request->headerSize = 0;
+	request->contentLength = 0;
+	request->bodyLength = 0;
+	request->body[0] = '\0';
+	request->webSocketUpgrade = 0;
+	request->webSocketKey[0] = '\0';
+	request->connectionDetached = 0;
+}
+
+/**
+ * @brief Parses the next part of the request. The data does not have to be null terminated
+ * and may end at any byte of the request (the state is held in \p request).
+ * @param request: pointer to \ref HttpRequestStr structure
+ * @param data: pointer to the received data
+ * @param length: data length
+ * @retval \ref HTTP_PARSE_DONE if the whole request (with body) was parsed
+ */
+HttpParseStatus httpRequestParserFeed(HttpRequestStr* request,
+		const char* data, uint32_t length) {
+	uint32_t i = 0;
+
+	while (i < length) {
+		char character = data[i];
+
+		if (request->state == HTTP_PARSER_BODY) {
+			// copying as much of the body as is available in this segment
+			uint32_t toCopy = request->contentLength - request->bodyLength;
+			if (toCopy > length - i)
+				toCopy = length - i;
+			memcpy(&request->body[request->bodyLength], &data[i], toCopy);
+			request->bodyLength += toCopy;
+			request->body[request->bodyLength] = '\0';
+			i += toCopy;
+
+			if (request->bodyLength == request->contentLength) {
+				request->state = HTTP_PARSER_DONE;
+				return HTTP_PARSE_DONE;
+			}
+			continue;
+		}
+
+		if (request->state == HTTP_PARSER_DONE)
+			return HTTP_PARSE_DONE;
+		if (request->state == HTTP_PARSER_ERROR)
+			return HTTP_PARSE_ERROR;
+
+		if (++request->headerSize > HTTP_REQUEST_MAX_HEADER_SIZE)
+			return setError(request, HTTP_PARSE_ERROR_HEADER_TOO_LARGE);
+		i++;
+
+		// carriage returns are ignored, lines are terminated by '\n'
+		if (character == '\r')
+			continue;
+
+		switch (request->state) {
+		case HTTP_PARSER_METHOD: {
+			if (character == ' ') {
+				if (request->tokenLength == 0)
+					return setError(request, HTTP_PARSE_ERROR_BAD_REQUEST);
+				request->method = encodeMethod(request->methodStr);
+				request->tokenLength = 0;
+				request->state = HTTP_PARSER_PATH;
+			} else if (character == '\n'
+					|| !appendToken(request->methodStr,
+					HTTP_REQUEST_MAX_METHOD_LENGTH, &request->tokenLength,
+							character)) {
+				return setError(request, HTTP_PARSE_ERROR_BAD_REQUEST);
+			}
+			break;
+		}
+		case HTTP_PARSER_PATH: {
+			if (character == ' ' || character == '?') {
+				if (request->tokenLength == 0)
+					return setError(request, HTTP_PARSE_ERROR_BAD_REQUEST);
+				request->tokenLength = 0;
+				request->state =
+						character == '?' ?
+								HTTP_PARSER_QUERY : HTTP_PARSER_VERSION;
+			} else if (character == '\n') {
+				return setError(request, HTTP_PARSE_ERROR_BAD_REQUEST);
+			} else if (!appendToken(request->path, HTTP_REQUEST_MAX_PATH_LENGTH,
+					&request->tokenLength, character)) {
+				return setError(request, HTTP_PARSE_ERROR_URI_TOO_LONG);
+			}
+			break;
+		}
+		case HTTP_PARSER_QUERY: {
+			if (character == ' ') {
+				request->tokenLength = 0;
+				request->state = HTTP_PARSER_VERSION;
+			} else if (character == '\n') {
+				return setError(request, HTTP_PARSE_ERROR_BAD_REQUEST);
+			} else if (!appendToken(request->query,
+			HTTP_REQUEST_MAX_QUERY_LENGTH, &request->tokenLength, character)) {
+				return setError(request, HTTP_PARSE_ERROR_URI_TOO_LONG);
+			}
+			break;
+		}
+		case HTTP_PARSER_VERSION: {
+			// the version is not stored, only the end of line is expected
+			if (character == '\n') {
+				request->tokenLength = 0;
+				request->headerName[0] = '\0';
+				request->state = HTTP_PARSER_HEADER_NAME;
+			}
+			break;
+		}
+		case HTTP_PARSER_HEADER_NAME: {
+			if (character == '\n') {
+				// empty line ends the header section
+				if (request->tokenLength != 0)
+					return setError(request, HTTP_PARSE_ERROR_BAD_REQUEST);
+				if (finishHeaders(request) == HTTP_PARSE_ERROR)
+					return HTTP_PARSE_ERROR;
+				if (request->state == HTTP_PARSER_DONE)
+					return HTTP_PARSE_DONE;
+			} else if (character == ':') {
+				request->tokenLength = 0;
+				request->headerValue[0] = '\0';
+				request->headerValueTruncated = 0;
+				request->state = HTTP_PARSER_HEADER_VALUE;
+			} else {
+				// too long names are truncated, they never match a known header
+				appendToken(request->headerName,
+				HTTP_REQUEST_MAX_HEADER_NAME_LENGTH, &request->tokenLength,
+						character);
+			}
+			break;
+		}
+		case HTTP_PARSER_HEADER_VALUE: {
+			if (character == '\n') {
+				// removing trailing whitespaces
+				while (request->tokenLength > 0
+						&& (request->headerValue[request->tokenLength - 1] == ' '
+								|| request->headerValue[request->tokenLength - 1]
+										== '\t')) {
+					request->headerValue[--request->tokenLength] = '\0';
+				}
+				// known headers are never used with a truncated value
+				if (request->headerValueTruncated
+						&& isKnownHeader(request->headerName))
+					return setError(request, HTTP_PARSE_ERROR_HEADER_TOO_LARGE);
+				if (!processHeader(request))
+					return setError(request, HTTP_PARSE_ERROR_BAD_REQUEST);
+				request->tokenLength = 0;
+				request->headerName[0] = '\0';
+				request->state = HTTP_PARSER_HEADER_NAME;
+			} else if ((character == ' ' || character == '\t')
+					&& request->tokenLength == 0) {
+				// skipping leading whitespaces
+			} else if (!appendToken(request->headerValue,
+			HTTP_REQUEST_MAX_HEADER_VALUE_LENGTH, &request->tokenLength,
+					character)) {
+				// values of the other headers (e.g. User-Agent) may be longer
+				request->headerValueTruncated = 1;
+			}
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	if (request->state == HTTP_PARSER_DONE)
+		return HTTP_PARSE_DONE;
+	if (request->state == HTTP_PARSER_ERROR)
+		return HTTP_PARSE_ERROR;
+	return HTTP_PARSE_INCOMPLETE;
+}
+
+/**
+ * @brief Parses all segments of the network buffer in place (without copying them to one array)
+ * @param request: pointer to \ref HttpRequestStr structure
+ * @param buf: pointer to \ref netbuf structure
+ * @retval \ref HTTP_PARSE_DONE if the whole request (with body) was parsed
+ */
+HttpParseStatus httpRequestParserFeedNetbuf(HttpRequestStr* request,
+		struct netbuf* buf) {
+	HttpParseStatus status = HTTP_PARSE_INCOMPLETE;
+	void* data;
+	uint16_t length;
+
+	netbuf_first(buf);
+	do {
+		if (netbuf_data(buf, &data, &length) != ERR_OK)
+			break;
+		status = httpRequestParserFeed(request, (const char*) data, length);
+	} while (status == HTTP_PARSE_INCOMPLETE && netbuf_next(buf) >= 0);
+
+	return status;
+}
+
+/**
+ * @brief Finds the query parameter (e.g. "from" in "/spectrum?from=10&to=20")
+ * @param request: pointer to parsed \ref HttpRequestStr structure
+ * @param name: parameter name
+ * @param value: output parameter value (null terminated)
+ * @param len: size of \p value buffer
+ * @retval returns 1 if the parameter was found
+ */
+uint8_t httpRequestGetQueryParam(HttpRequestStr* request, const char* name,
+		char* value, uint32_t len) {
+	uint32_t nameLength = strlen(name);
+	char* it = request->query;
+
+	while (*it != '\0') {
+		if (strncmp(it, name, nameLength) == 0 && it[nameLength] == '=') {
+			uint32_t i = 0;
+			it += nameLength + 1;
+			while (*it != '\0' && *it != '&' && i + 1 < len) {
+				value[i++] = *it++;
+			}
+			value[i] = '\0';
+			return 1;
+		}
+
+		// moving to the next parameter
+		while (*it != '\0' && *it != '&')
+			it++;
+		if (*it == '&')
+			it++;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Finds the query parameter and converts it to the unsigned number
+ * @param request: pointer to parsed \ref HttpRequestStr structure
+ * @param name: parameter name
+ * @param value: output value (not changed if the parameter is missing)
+ * @retval returns 0 if the parameter exists but it is not a number
+ */
+uint8_t httpRequestGetQueryUint(HttpRequestStr* request, const char* name,
+		uint32_t* value) {
+	char valueStr[12];
+	uint32_t result = 0;
+	char* it = valueStr;
+
+	if (!httpRequestGetQueryParam(request, name, valueStr, sizeof(valueStr)))
+		return 1;
+	if (*it == '\0')
+		return 0;
+
+	while (*it != '\0') {
+		if (*it < '0' || *it > '9' || result > 100000000)
+			return 0;
+		result = result * 10 + (*it++ - '0');
+	}
+
+	*value = result;
+	return 1;
+}
@@ -0,0 +1,181 @@
+/*
+ * httpResponse.c
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#include "httpResponse.h"
+
+/**
+ * @var char httpChunkEnd[]
+ * @brief Terminates every chunk of the chunked response
+ */
+static const char httpChunkEnd[] = "\r\n";
+
+/**
+ * @var char httpLastChunk[]
+ * @brief Last (empty) chunk of the chunked response
+ */
+static const char httpLastChunk[] = "0\r\n\r\n";
+
+/**
+ * @brief Appends text to the response header buffer
+ * @param response: pointer to \ref HttpResponseStr structure
+ * @param str: text to append
+ */
+static void appendHeader(HttpResponseStr* response, const char* str) {
+	uint32_t length = strlen(str);
+
+	if (response->headerLength + length >= HTTP_RESPONSE_MAX_HEADER_SIZE) {
+		response->status = ERR_BUF;
+		return;
+	}
+	memcpy(&response->header[response->headerLength], str, length + 1);
+	response->headerLength += length;
+}
+
+/**
+ * @brief Writes one segment to the client. The segments are written with NETCONN_MORE flag
+ * so lwIP joins them in the same TCP segments. The write ends after the send timeout of the
+ * connection, the rest of the response is then not sent.
+ * @param response: pointer to \ref HttpResponseStr structure
+ * @param data: pointer to data
+ * @param length: data length
+ * @param apiFlags: netconn write flags
+ * @retval ERR_OK if there are no errors
+ */
+static err_t writeSegment(HttpResponseStr* response, const void* data,
+		uint32_t length, uint8_t apiFlags) {
+	size_t written = 0;
+
+	if (response->status != ERR_OK)
+		return response->status;
+
+	// the timed out write reports only the written part
+	response->status = netconn_write_partly(response->client, data, length,
+			apiFlags, &written);
+	if (response->status == ERR_OK && written != length)
+		response->status = ERR_TIMEOUT;
+	return response->status;
+}
+
+/**
+ * @brief Finishes the header and sends it as the first segment
+ * @param response: pointer to \ref HttpResponseStr structure
+ * @retval ERR_OK if there are no errors
+ */
+static err_t sendHeader(HttpResponseStr* response) {
+	char lengthHeader[40];
+
+	if (response->headerSent)
+		return response->status;
+	response->headerSent = 1;
+
+	if (response->contentLength == HTTP_RESPONSE_CHUNKED) {
+		appendHeader(response, "\r\nTransfer-Encoding: chunked");
+	} else if (response->contentLength != HTTP_RESPONSE_NO_BODY) {
+		sprintf(lengthHeader, "\r\nContent-Length: %lu",
+				(unsigned long) response->contentLength);
+		appendHeader(response, lengthHeader);
+	}
+	appendHeader(response, "\r\n\r\n");
+
+	return writeSegment(response, response->header, response->headerLength,
+	NETCONN_COPY | NETCONN_MORE);
+}
+
+/**
+ * @brief Initializes the response (by default it uses chunked transfer encoding)
+ * @param response: pointer to \ref HttpResponseStr structure
+ * @param client: pointer to \ref netconn structure (represents endpoint client)
+ * @param httpStatus: HTTP status (e.g. "200 OK")
+ */
+void httpResponseInit(HttpResponseStr* response, struct netconn* client,
+		const char* httpStatus) {
+	response->client = client;
+	response->headerLength = 0;
+	response->contentLength = HTTP_RESPONSE_CHUNKED;
+	response->headerSent = 0;
+	response->status = ERR_OK;
+	response->header[0] = '\0';
+
+	appendHeader(response, "HTTP/1.1 ");
+	appendHeader(response, httpStatus);
+}
+
+/**
+ * @brief Adds the header to the response (must be called before the first write)
+ * @param response: pointer to \ref HttpResponseStr structure
+ * @param name: header name
+ * @param value: header value
+ */
+void httpResponseAddHeader(HttpResponseStr* response, const char* name,
+		const char* value) {
+	appendHeader(response, "\r\n");
+	appendHeader(response, name);
+	appendHeader(response, ": ");
+	appendHeader(response, value);
+}
+
+/**
+ * @brief Adds already formatted headers (each one preceded by "\r\n")
+ * @param response: pointer to \ref HttpResponseStr structure
+ * @param headers: formatted headers
+ */
+void httpResponseAddRawHeaders(HttpResponseStr* response, const char* headers) {
+	appendHeader(response, headers);
+}
+
+/**
+ * @brief Sets the content length (disables chunked transfer encoding)
+ * @param response: pointer to \ref HttpResponseStr structure
+ * @param contentLength: length of the whole content
+ */
+void httpResponseSetContentLength(HttpResponseStr* response,
+		uint32_t contentLength) {
+	response->contentLength = contentLength;
+}
+
+/**
+ * @brief Writes the next part of the content. The header is sent before the first part.
+ * The content is never copied to an intermediate buffer.
+ * @param response: pointer to \ref HttpResponseStr structure
+ * @param data: pointer to content
+ * @param length: content length
+ * @param memory: \ref HTTP_CONTENT_STATIC if \p data outlives the connection
+ * @retval ERR_OK if there are no errors
+ */
+err_t httpResponseWrite(HttpResponseStr* response, const void* data,
+		uint32_t length, HttpContentMemory memory) {
+	char chunkHeader[12];
+
+	if (sendHeader(response) != ERR_OK || length == 0)
+		return response->status;
+
+	if (response->contentLength == HTTP_RESPONSE_CHUNKED) {
+		sprintf(chunkHeader, "%lX\r\n", (unsigned long) length);
+		writeSegment(response, chunkHeader, strlen(chunkHeader),
+		NETCONN_COPY | NETCONN_MORE);
+		writeSegment(response, data, length, memory | NETCONN_MORE);
+		return writeSegment(response, httpChunkEnd, strlen(httpChunkEnd),
+		NETCONN_NOCOPY | NETCONN_MORE);
+	}
+
+	return writeSegment(response, data, length, memory | NETCONN_MORE);
+}
+
+/**
+ * @brief Finishes the response (sends the header if there was no content and the last chunk)
+ * @param response: pointer to \ref HttpResponseStr structure
+ * @retval ERR_OK if there are no errors
+ */
+err_t httpResponseEnd(HttpResponseStr* response) {
+	if (sendHeader(response) != ERR_OK)
+		return response->status;
+
+	if (response->contentLength == HTTP_RESPONSE_CHUNKED)
+		writeSegment(response, httpLastChunk, strlen(httpLastChunk),
+		NETCONN_NOCOPY);
+
+	return response->status;
+}
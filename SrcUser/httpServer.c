@@ -0,0 +1,941 @@
+/*
+ * httpServer.c
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#include "httpServer.h"
+
+/**
+ * @var StmConfigSnapshotStr configSnapshot
+ * @brief System configuration (versioned, read without locking)
+ */
+extern StmConfigSnapshotStr configSnapshot;
+
+/**
+ * @var SpectrumSnapshotStr mainSpectrumSnapshot
+ * @brief Lock-free access to the last calculated spectrum
+ */
+extern SpectrumSnapshotStr mainSpectrumSnapshot;
+
+/**
+ * @var UdpStreamingStatsStr udpStreamingStats
+ * @brief UDP streaming throughput
+ */
+extern UdpStreamingStatsStr udpStreamingStats;
+
+/**
+ * @var float32_t spectrumBins[]
+ * @brief Copy of the spectrum sent by GET /spectrum (used only by the HTTP task)
+ */
+static float32_t spectrumBins[AMPLITUDE_STR_MAX_BUFFER_SIZE];
+
+/**
+ * @var SystemInfoTaskStr taskProfiles[]
+ * @brief Task profiles sent by GET /system (used only by the HTTP task)
+ */
+static SystemInfoTaskStr taskProfiles[SYSTEM_INFO_MAX_TASKS];
+
+/**
+ * @var TraceObjectStr traceObjectNames[]
+ * @brief Names of traced objects sent by GET /trace (used only by the HTTP task)
+ */
+static TraceObjectStr traceObjectNames[TRACE_RECORDER_MAX_OBJECTS];
+
+/**
+ * @brief Sends the HTML error response (the content is sent by reference)
+ * @param client: pointer to \ref netconn structure
+ * @param httpStatus: HTTP status
+ * @param content: HTML content (string literal)
+ * @retval ERR_OK if there are no errors
+ */
+static err_t sendError(struct netconn* client, const char* httpStatus,
+		const char* content) {
+	HttpResponseStr response;
+	uint32_t length = strlen(content);
+
+	httpResponseInit(&response, client, httpStatus);
+	httpResponseAddHeader(&response, "Content-Type", "text/html");
+	httpResponseAddHeader(&response, "Connection", "close");
+	httpResponseSetContentLength(&response, length);
+	httpResponseWrite(&response, content, length, HTTP_CONTENT_STATIC);
+	return httpResponseEnd(&response);
+}
+
+/**
+ * @brief Sends the JSON response prepared in the buffer of the handler (lwIP copies the
+ * content, the buffer is gone when the handler returns)
+ * @param client: pointer to \ref netconn structure
+ * @param httpStatus: HTTP status
+ * @param content: JSON content
+ * @retval ERR_OK if there are no errors
+ */
+static err_t sendJson(struct netconn* client, const char* httpStatus,
+		const char* content) {
+	HttpResponseStr response;
+	uint32_t length = strlen(content);
+
+	httpResponseInit(&response, client, httpStatus);
+	httpResponseAddHeader(&response, "Content-Type", "application/json");
+	httpResponseAddHeader(&response, "Connection", "close");
+	httpResponseSetContentLength(&response, length);
+	httpResponseWrite(&response, content, length, HTTP_CONTENT_VOLATILE);
+	return httpResponseEnd(&response);
+}
+
+/**
+ * @brief Sends the current configuration with its version number
+ * @param client: pointer to \ref netconn structure
+ * @retval ERR_OK if there are no errors
+ */
+static err_t sendCurrentConfiguration(struct netconn* client) {
+	StmConfig config;
+	char parameters[64];
+
+	sprintf(parameters, "\r\nX-Config-Version: %lu",
+			(unsigned long) configSnapshotRead(&configSnapshot, &config));
+	return sendConfiguration(&config, client, parameters);
+}
+
+/**
+ * @brief Sends the device configuration (GET /config)
+ * @param request: pointer to \ref HttpRequestStr structure
+ * @param client: pointer to \ref netconn structure
+ * @retval ERR_OK if there are no errors
+ */
+static err_t getConfigHandler(HttpRequestStr* request, struct netconn* client) {
+	logMsg("GET config request");
+	return sendCurrentConfiguration(client);
+}
+
+/**
+ * @brief Changes the device configuration using JSON request body (PUT /config).
+ * The new configuration version is published at once (readers never see partial changes).
+ * @param request: pointer to \ref HttpRequestStr structure
+ * @param client: pointer to \ref netconn structure
+ * @retval ERR_OK if there are no errors
+ */
+static err_t putConfigHandler(HttpRequestStr* request, struct netconn* client) {
+	StmConfig tempConfig;
+	JsonSchemaResultStr result;
+	HttpResponseStr response;
+	JsonWriterStr writer;
+	char text[HTTP_JSON_WRITER_BUFFER_SIZE];
+
+	logMsg("PUT config request");
+
+	// parsing JSON data to config structure (nothing is changed if any field was rejected)
+	if (!parseJSON(request->body, &tempConfig, &result)) {
+		// the list of rejected fields can be long, so it is streamed
+		httpResponseInit(&response, client, "400 Bad Request");
+		httpResponseAddHeader(&response, "Content-Type", "application/json");
+		httpResponseAddHeader(&response, "Connection", "close");
+		jsonWriterInitResponse(&writer, text, sizeof(text), &response);
+		jsonWriterSchemaResult(&writer, stmConfigSchema, stmConfigSchemaSize,
+				&result);
+		if (!jsonWriterFinish(&writer))
+			logErr("Config result JSON error");
+		return httpResponseEnd(&response);
+	}
+	configSnapshotUpdate(&configSnapshot, &tempConfig);
+
+	return sendCurrentConfiguration(client);
+}
+
+/**
+ * @brief Sends the task profile as binary data: \ref SystemInfoHeaderStr header
+ * followed by header.taskCount \ref SystemInfoTaskStr records (little endian)
+ * @param client: pointer to \ref netconn structure
+ * @retval ERR_OK if there are no errors
+ */
+static err_t sendSystemBinary(struct netconn* client) {
+	HttpResponseStr response;
+	SystemInfoHeaderStr header;
+	uint32_t tasksLength;
+
+	systemInfoCollect(&header, taskProfiles);
+	tasksLength = header.taskCount * sizeof(SystemInfoTaskStr);
+
+	httpResponseInit(&response, client, "200 OK");
+	httpResponseAddHeader(&response, "Content-Type", "application/octet-stream");
+	httpResponseAddHeader(&response, "Connection", "close");
+	httpResponseSetContentLength(&response,
+			sizeof(SystemInfoHeaderStr) + tasksLength);
+	httpResponseWrite(&response, &header, sizeof(SystemInfoHeaderStr),
+			HTTP_CONTENT_VOLATILE);
+	httpResponseWrite(&response, taskProfiles, tasksLength,
+			HTTP_CONTENT_VOLATILE);
+	return httpResponseEnd(&response);
+}
+
+/**
+ * @brief Sends the task profile as JSON (chunked response)
+ * @param client: pointer to \ref netconn structure
+ * @retval ERR_OK if there are no errors
+ */
+static err_t sendSystemJson(struct netconn* client) {
+	HttpResponseStr response;
+	JsonWriterStr writer;
+	char text[HTTP_JSON_WRITER_BUFFER_SIZE];
+
+	httpResponseInit(&response, client, "200 OK");
+	httpResponseAddHeader(&response, "Content-Type", "application/json");
+	httpResponseAddHeader(&response, "Connection", "close");
+
+	// the JSON is sent in chunks (the task count is not limited by the buffer size)
+	jsonWriterInitResponse(&writer, text, sizeof(text), &response);
+	getTaskUsageDetails(&writer, taskProfiles);
+	if (!jsonWriterFinish(&writer))
+		logErr("System JSON error");
+	return httpResponseEnd(&response);
+}
+
+/**
+ * @brief Sends the task profile: run time, CPU usage and context switches since
+ * the previous request, stack high water mark, state and priority (GET /system?format=json|bin)
+ * @param request: pointer to \ref HttpRequestStr structure
+ * @param client: pointer to \ref netconn structure
+ * @retval ERR_OK if there are no errors
+ */
+static err_t getSystemHandler(HttpRequestStr* request, struct netconn* client) {
+	char format[8] = "json";
+
+	logMsg("GET system request");
+	httpRequestGetQueryParam(request, "format", format, sizeof(format));
+
+	if (strcmp(format, "json") == 0)
+		return sendSystemJson(client);
+	else if (strcmp(format, "bin") == 0)
+		return sendSystemBinary(client);
+	else
+		return sendError(client, "400 Bad Request", "<h1>400 Bad Request</h1>");
+}
+
+/**
+ * @brief Sends the UDP streaming throughput and lwIP profile (GET /network)
+ * @param request: pointer to \ref HttpRequestStr structure
+ * @param client: pointer to \ref netconn structure
+ * @retval ERR_OK if there are no errors
+ */
+static err_t getNetworkHandler(HttpRequestStr* request, struct netconn* client) {
+	char networkDetails[256];
+
+	logMsg("GET network request");
+	udpStreamingStatsToString(&udpStreamingStats, networkDetails,
+			sizeof(networkDetails));
+	return sendJson(client, "200 OK", networkDetails);
+}
+
+/**
+ * @brief Sends the FreeRTOS heap and configuration storage usage (GET /memory)
+ * @param request: pointer to \ref HttpRequestStr structure
+ * @param client: pointer to \ref netconn structure
+ * @retval ERR_OK if there are no errors
+ */
+static err_t getMemoryHandler(HttpRequestStr* request, struct netconn* client) {
+	ConfigStorageStateStr storageState;
+	JsonWriterStr writer;
+	char text[256];
+
+	logMsg("GET memory request");
+	configStorageGetState(&storageState);
+
+	jsonWriterInit(&writer, text, sizeof(text));
+	jsonWriterBeginObject(&writer);
+	jsonWriterAddUint(&writer, "HeapFree", xPortGetFreeHeapSize());
+	jsonWriterAddUint(&writer, "HeapMinimumEverFree",
+			xPortGetMinimumEverFreeHeapSize());
+	jsonWriterAddUint(&writer, "ConfigStorageSequence", storageState.sequence);
+	jsonWriterAddUint(&writer, "ConfigStorageWrites", storageState.writes);
+	jsonWriterAddUint(&writer, "ConfigStorageErases", storageState.erases);
+	jsonWriterAddUint(&writer, "ConfigStorageFailures", storageState.failures);
+	jsonWriterEndObject(&writer);
+	if (!jsonWriterFinish(&writer))
+		logErr("Memory JSON overflow");
+
+	return sendJson(client, "200 OK", text);
+}
+
+/**
+ * @brief Sends the sampling frequency and the statistics of its changes (GET /audio)
+ * @param request: pointer to \ref HttpRequestStr structure
+ * @param client: pointer to \ref netconn structure
+ * @retval ERR_OK if there are no errors
+ */
+static err_t getAudioHandler(HttpRequestStr* request, struct netconn* client) {
+	AudioRateSwitchStatsStr stats;
+	JsonWriterStr writer;
+	char text[256];
+
+	logMsg("GET audio request");
+	audioRecorderGetRateSwitchStats(&stats);
+
+	jsonWriterInit(&writer, text, sizeof(text));
+	jsonWriterBeginObject(&writer);
+	jsonWriterAddUint(&writer, "SamplingFrequency",
+			audioRecorderGetSamplingFrequency());
+	jsonWriterAddUint(&writer, "RateSwitches", stats.switches);
+	jsonWriterAddUint(&writer, "RateSwitchFailures", stats.failures);
+	jsonWriterAddUint(&writer, "LastGapUs", stats.lastGapUs);
+	jsonWriterAddUint(&writer, "MaxGapUs", stats.maxGapUs);
+	jsonWriterAddUint(&writer, "DiscardedBuffers", stats.discardedBuffers);
+	jsonWriterAddUint(&writer, "BufferFlushes", stats.bufferFlushes);
+	jsonWriterEndObject(&writer);
+	if (!jsonWriterFinish(&writer))
+		logErr("Audio JSON overflow");
+
+	return sendJson(client, "200 OK", text);
+}
+
+/**
+ * @brief Sends the latency summary of the spectrum pipeline stages: sample count, mean,
+ * p50, p99 and max [us] (GET /latency, ?reset=1 clears the histograms after sending)
+ * @param request: pointer to \ref HttpRequestStr structure
+ * @param client: pointer to \ref netconn structure
+ * @retval ERR_OK if there are no errors
+ */
+static err_t getLatencyHandler(HttpRequestStr* request, struct netconn* client) {
+	HttpResponseStr response;
+	JsonWriterStr writer;
+	char text[HTTP_JSON_WRITER_BUFFER_SIZE];
+	uint32_t reset = 0;
+	err_t status;
+
+	logMsg("GET latency request");
+	httpRequestGetQueryUint(request, "reset", &reset);
+
+	httpResponseInit(&response, client, "200 OK");
+	httpResponseAddHeader(&response, "Content-Type", "application/json");
+	httpResponseAddHeader(&response, "Connection", "close");
+
+	jsonWriterInitResponse(&writer, text, sizeof(text), &response);
+	pipelineStatsToJson(&writer);
+	if (!jsonWriterFinish(&writer))
+		logErr("Latency JSON error");
+	status = httpResponseEnd(&response);
+
+	if (reset)
+		pipelineStatsReset();
+	return status;
+}
+
+/**
+ * @brief Sends the binary event trace: \ref TraceHeaderStr, header.objectCount \ref TraceObjectStr
+ * and header.eventCount \ref TraceEventStr (GET /trace, ?clear=1 clears the ring after sending).
+ * The recording is paused while the ring is sent.
+ * @param request: pointer to \ref HttpRequestStr structure
+ * @param client: pointer to \ref netconn structure
+ * @retval ERR_OK if there are no errors
+ */
+static err_t getTraceHandler(HttpRequestStr* request, struct netconn* client) {
+	HttpResponseStr response;
+	TraceHeaderStr header;
+	const TraceEventStr* events;
+	uint32_t eventCount;
+	uint32_t clear = 0;
+	uint32_t part;
+	err_t status;
+
+	logMsg("GET trace request");
+	httpRequestGetQueryUint(request, "clear", &clear);
+	traceRecorderPause(&header, traceObjectNames);
+
+	httpResponseInit(&response, client, "200 OK");
+	httpResponseAddHeader(&response, "Content-Type", "application/octet-stream");
+	httpResponseAddHeader(&response, "Connection", "close");
+	httpResponseSetContentLength(&response,
+			sizeof(TraceHeaderStr) + header.objectCount * sizeof(TraceObjectStr)
+					+ header.eventCount * sizeof(TraceEventStr));
+	httpResponseWrite(&response, &header, sizeof(TraceHeaderStr),
+			HTTP_CONTENT_VOLATILE);
+	httpResponseWrite(&response, traceObjectNames,
+			header.objectCount * sizeof(TraceObjectStr), HTTP_CONTENT_VOLATILE);
+	for (part = 0; part < 2; part++) {
+		eventCount = traceRecorderGetEvents(part, &events);
+		httpResponseWrite(&response, events, eventCount * sizeof(TraceEventStr),
+				HTTP_CONTENT_VOLATILE);
+	}
+	status = httpResponseEnd(&response);
+
+	traceRecorderResume(clear != 0);
+	return status;
+}
+
+/**
+ * @brief Sends the records kept in the log history and the counters of the log queue
+ * and syslog sink (GET /log, ?since=N sends only records with greater sequence number)
+ * @param request: pointer to \ref HttpRequestStr structure
+ * @param client: pointer to \ref netconn structure
+ * @retval ERR_OK if there are no errors
+ */
+static err_t getLogHandler(HttpRequestStr* request, struct netconn* client) {
+	HttpResponseStr response;
+	JsonWriterStr writer;
+	LogStatsStr logStats;
+	SyslogSinkStatsStr syslogStats;
+	LogEntryStr entry;
+	char text[HTTP_JSON_WRITER_BUFFER_SIZE];
+	uint32_t since = 0;
+	uint32_t sequence;
+	uint32_t last;
+
+	logMsg("GET log request");
+	httpRequestGetQueryUint(request, "since", &since);
+	logGetStats(&logStats);
+	syslogSinkGetStats(&syslogStats);
+	last = logGetLastSequence();
+	sequence = logGetFirstSequence();
+	if (sequence <= since)
+		sequence = since + 1;
+
+	httpResponseInit(&response, client, "200 OK");
+	httpResponseAddHeader(&response, "Content-Type", "application/json");
+	httpResponseAddHeader(&response, "Connection", "close");
+
+	jsonWriterInitResponse(&writer, text, sizeof(text), &response);
+	jsonWriterBeginObject(&writer);
+	jsonWriterAddUint(&writer, "LastSequence", last);
+	jsonWriterAddUint(&writer, "Written", logStats.written);
+	jsonWriterAddUint(&writer, "Dropped", logStats.dropped);
+	jsonWriterAddUint(&writer, "RateLimited", logStats.rateLimited);
+	jsonWriterAddUint(&writer, "Filtered", logStats.filtered);
+	jsonWriterAddUint(&writer, "SyslogRecords", syslogStats.sentRecords);
+	jsonWriterAddUint(&writer, "SyslogDatagrams", syslogStats.sentDatagrams);
+	jsonWriterAddUint(&writer, "SyslogFailures", syslogStats.failedDatagrams);
+	jsonWriterAddUint(&writer, "SyslogLost", syslogStats.lostRecords);
+
+	// records overwritten during sending are skipped
+	jsonWriterKey(&writer, "Records");
+	jsonWriterBeginArray(&writer);
+	for (; sequence <= last; sequence++) {
+		if (!logGetEntry(sequence, &entry))
+			continue;
+		jsonWriterBeginObject(&writer);
+		jsonWriterAddUint(&writer, "Sequence", entry.sequence);
+		jsonWriterAddUint64(&writer, "TimeUs",
+				timeBaseCyclesToUs(entry.timestamp));
+		jsonWriterAddString(&writer, "Severity",
+				logGetSeverityName(entry.severity));
+		jsonWriterAddString(&writer, "Text", entry.text);
+		jsonWriterEndObject(&writer);
+	}
+	jsonWriterEndArray(&writer);
+	jsonWriterEndObject(&writer);
+	if (!jsonWriterFinish(&writer))
+		logErr("Log JSON error");
+	return httpResponseEnd(&response);
+}
+
+/**
+ * @brief Sends the copied spectrum as binary data: \ref SpectrumSnapshotInfoStr header
+ * followed by info->count float32 values (little endian)
+ * @param client: pointer to \ref netconn structure
+ * @param info: pointer to \ref SpectrumSnapshotInfoStr describing \ref spectrumBins
+ * @retval ERR_OK if there are no errors
+ */
+static err_t sendSpectrumBinary(struct netconn* client,
+		SpectrumSnapshotInfoStr* info) {
+	HttpResponseStr response;
+	uint32_t binsLength = info->count * sizeof(float32_t);
+
+	httpResponseInit(&response, client, "200 OK");
+	httpResponseAddHeader(&response, "Content-Type", "application/octet-stream");
+	httpResponseAddHeader(&response, "Connection", "close");
+	httpResponseSetContentLength(&response,
+			sizeof(SpectrumSnapshotInfoStr) + binsLength);
+	httpResponseWrite(&response, info, sizeof(SpectrumSnapshotInfoStr),
+			HTTP_CONTENT_VOLATILE);
+	httpResponseWrite(&response, spectrumBins, binsLength,
+			HTTP_CONTENT_VOLATILE);
+	return httpResponseEnd(&response);
+}
+
+/**
+ * @brief Sends the copied spectrum as JSON (chunked response)
+ * @param client: pointer to \ref netconn structure
+ * @param info: pointer to \ref SpectrumSnapshotInfoStr describing \ref spectrumBins
+ * @retval ERR_OK if there are no errors
+ */
+static err_t sendSpectrumJson(struct netconn* client,
+		SpectrumSnapshotInfoStr* info) {
+	HttpResponseStr response;
+	char text[HTTP_SPECTRUM_JSON_CHUNK_SIZE];
+	uint64_t timestamp = ((uint64_t) info->timestampHigh << 32)
+			| info->timestampLow;
+	uint32_t length;
+	uint32_t i;
+
+	httpResponseInit(&response, client, "200 OK");
+	httpResponseAddHeader(&response, "Content-Type", "application/json");
+	httpResponseAddHeader(&response, "Connection", "close");
+
+	// timestamp written as seconds with microsecond fraction (printf may not support long long)
+	length = sprintf(text,
+			"{\"Frame\":%lu,\"Timestamp\":%lu.%06lu,\"VectorSize\":%lu,"
+					"\"FrequencyResolution\":%g,\"From\":%lu,\"Decimation\":%lu,"
+					"\"Scale\":\"%s\",\"Amplitudes\":[",
+			(unsigned long) info->frameNumber,
+			(unsigned long) (timestamp / 1000000),
+			(unsigned long) (timestamp % 1000000),
+			(unsigned long) info->vectorSize, info->frequencyResolution,
+			(unsigned long) info->from, (unsigned long) info->decimation,
+			soundProcessingGetScaleName(info->scale));
+
+	for (i = 0; i < info->count; i++) {
+		// flushing the chunk if the next value may not fit
+		if (length > HTTP_SPECTRUM_JSON_CHUNK_SIZE - 20) {
+			if (httpResponseWrite(&response, text, length,
+					HTTP_CONTENT_VOLATILE) != ERR_OK)
+				return response.status;
+			length = 0;
+		}
+		length += sprintf(&text[length], i == 0 ? "%g" : ",%g",
+				spectrumBins[i]);
+	}
+	length += sprintf(&text[length], "]}");
+
+	httpResponseWrite(&response, text, length, HTTP_CONTENT_VOLATILE);
+	return httpResponseEnd(&response);
+}
+
+/**
+ * @brief Sends the last calculated spectrum (GET /spectrum?from=&to=&decimation=&format=bin|json)
+ * @param request: pointer to \ref HttpRequestStr structure
+ * @param client: pointer to \ref netconn structure
+ * @retval ERR_OK if there are no errors
+ */
+static err_t getSpectrumHandler(HttpRequestStr* request,
+		struct netconn* client) {
+	SpectrumSnapshotInfoStr info;
+	uint32_t from = 0;
+	uint32_t to = AMPLITUDE_STR_MAX_BUFFER_SIZE;
+	uint32_t decimation = 1;
+	char format[8] = "bin";
+
+	if (!httpRequestGetQueryUint(request, "from", &from)
+			|| !httpRequestGetQueryUint(request, "to", &to)
+			|| !httpRequestGetQueryUint(request, "decimation", &decimation)
+			|| decimation == 0 || from >= to) {
+		return sendError(client, "400 Bad Request", "<h1>400 Bad Request</h1>");
+	}
+	httpRequestGetQueryParam(request, "format", format, sizeof(format));
+
+	if (!spectrumSnapshotRead(&mainSpectrumSnapshot, spectrumBins, from, to,
+			decimation, &info)) {
+		logErr("Spectrum snapshot busy");
+		return sendError(client, "503 Service Unavailable",
+				"<h1>503 Service Unavailable</h1>");
+	}
+
+	if (strcmp(format, "json") == 0)
+		return sendSpectrumJson(client, &info);
+	else if (strcmp(format, "bin") == 0)
+		return sendSpectrumBinary(client, &info);
+	else
+		return sendError(client, "400 Bad Request", "<h1>400 Bad Request</h1>");
+}
+
+/**
+ * @brief Writes the peaks as JSON array
+ * @param writer: pointer to \ref JsonWriterStr structure
+ * @param key: array key
+ * @param peaks: array of \ref PeakStr
+ * @param count: number of peaks
+ */
+static void writePeaks(JsonWriterStr* writer, const char* key,
+		const PeakStr* peaks, uint32_t count) {
+	uint32_t i;
+
+	jsonWriterKey(writer, key);
+	jsonWriterBeginArray(writer);
+	for (i = 0; i < count; i++) {
+		jsonWriterBeginObject(writer);
+		jsonWriterAddFloat(writer, "Frequency", peaks[i].frequency);
+		jsonWriterAddFloat(writer, "Amplitude", peaks[i].amplitude);
+		jsonWriterEndObject(writer);
+	}
+	jsonWriterEndArray(writer);
+}
+
+/**
+ * @brief Sends the strongest peaks, harmonics of the strongest one, THD [%], SNR [dB]
+ * and SINAD [dB] of the last spectrum (GET /peaks)
+ * @param request: pointer to \ref HttpRequestStr structure
+ * @param client: pointer to \ref netconn structure
+ * @retval ERR_OK if there are no errors
+ */
+static err_t getPeaksHandler(HttpRequestStr* request, struct netconn* client) {
+	HttpResponseStr response;
+	JsonWriterStr writer;
+	PeakAnalysisStr analysis;
+	char text[HTTP_JSON_WRITER_BUFFER_SIZE];
+	uint32_t frameNumber;
+
+	if (!spectrumSnapshotReadAnalysis(&mainSpectrumSnapshot, &analysis,
+			&frameNumber)) {
+		logErr("Spectrum snapshot busy");
+		return sendError(client, "503 Service Unavailable",
+				"<h1>503 Service Unavailable</h1>");
+	}
+
+	httpResponseInit(&response, client, "200 OK");
+	httpResponseAddHeader(&response, "Content-Type", "application/json");
+	httpResponseAddHeader(&response, "Connection", "close");
+
+	jsonWriterInitResponse(&writer, text, sizeof(text), &response);
+	jsonWriterBeginObject(&writer);
+	jsonWriterAddUint(&writer, "Frame", frameNumber);
+	writePeaks(&writer, "Peaks", analysis.peaks, analysis.peakCount);
+	writePeaks(&writer, "Harmonics", analysis.harmonics,
+			analysis.harmonicCount);
+	jsonWriterAddFloat(&writer, "ThdPercent", analysis.thd * 100.0f);
+	jsonWriterAddFloat(&writer, "SnrDb", analysis.snr);
+	jsonWriterAddFloat(&writer, "SinadDb", analysis.sinad);
+	jsonWriterEndObject(&writer);
+	if (!jsonWriterFinish(&writer))
+		logErr("Peaks JSON error");
+	return httpResponseEnd(&response);
+}
+
+/**
+ * @brief Sends the levels of the recorded signal [dBFS] measured on every DMA buffer (GET /level)
+ * @param request: pointer to \ref HttpRequestStr structure
+ * @param client: pointer to \ref netconn structure
+ * @retval ERR_OK if there are no errors
+ */
+static err_t getLevelHandler(HttpRequestStr* request, struct netconn* client) {
+	HttpResponseStr response;
+	JsonWriterStr writer;
+	LevelMeterReadingStr level;
+	char text[HTTP_JSON_WRITER_BUFFER_SIZE];
+
+	if (!levelMeterRead(&level)) {
+		logErr("Level meter busy");
+		return sendError(client, "503 Service Unavailable",
+				"<h1>503 Service Unavailable</h1>");
+	}
+
+	httpResponseInit(&response, client, "200 OK");
+	httpResponseAddHeader(&response, "Content-Type", "application/json");
+	httpResponseAddHeader(&response, "Connection", "close");
+
+	jsonWriterInitResponse(&writer, text, sizeof(text), &response);
+	jsonWriterBeginObject(&writer);
+	jsonWriterAddUint(&writer, "Blocks", level.blocks);
+	jsonWriterAddUint(&writer, "ClippedBlocks", level.clippedBlocks);
+	jsonWriterAddFloat(&writer, "RmsDbfs", level.rms);
+	jsonWriterAddFloat(&writer, "PeakDbfs", level.peak);
+	jsonWriterAddFloat(&writer, "PeakHoldDbfs", level.peakHold);
+	jsonWriterAddFloat(&writer, "FastDbfs", level.fast);
+	jsonWriterAddFloat(&writer, "SlowDbfs", level.slow);
+	jsonWriterAddFloat(&writer, "LeqDbfs", level.leq);
+	jsonWriterAddFloat(&writer, "LeqCurrentDbfs", level.leqCurrent);
+	jsonWriterAddUint(&writer, "LeqPeriod", level.leqPeriod);
+	jsonWriterAddUint(&writer, "LeqWindows", level.leqWindows);
+	jsonWriterEndObject(&writer);
+	if (!jsonWriterFinish(&writer))
+		logErr("Level JSON error");
+	return httpResponseEnd(&response);
+}
+
+/**
+ * @brief Adds the array of band levels to JSON
+ * @param writer: pointer to \ref JsonWriterStr structure
+ * @param key: array key
+ * @param levels: band levels [dB]
+ * @param count: number of bands below Nyquist frequency
+ * @param octave: 1 for octave bands, 0 for 1/3-octave bands
+ */
+static void writeBands(JsonWriterStr* writer, const char* key,
+		const float32_t* levels, uint32_t count, uint8_t octave) {
+	uint32_t i;
+
+	jsonWriterKey(writer, key);
+	jsonWriterBeginArray(writer);
+	for (i = 0; i < count; i++) {
+		jsonWriterBeginObject(writer);
+		jsonWriterAddFloat(writer, "Frequency",
+				octave ?
+						bandAnalysisGetOctaveMidFrequency(i) :
+						bandAnalysisGetMidFrequency(i));
+		jsonWriterAddFloat(writer, "Level", levels[i]);
+		jsonWriterEndObject(writer);
+	}
+	jsonWriterEndArray(writer);
+}
+
+/**
+ * @brief Sends 1/3-octave and octave band levels [dB] and Z, A, C weighted totals of the last
+ * spectrum (GET /bands?weighting=Z|A|C, the weighting is applied to the band levels)
+ * @param request: pointer to \ref HttpRequestStr structure
+ * @param client: pointer to \ref netconn structure
+ * @retval ERR_OK if there are no errors
+ */
+static err_t getBandsHandler(HttpRequestStr* request, struct netconn* client) {
+	HttpResponseStr response;
+	JsonWriterStr writer;
+	BandLevelsStr bands;
+	BandWeightingType weighting;
+	char text[HTTP_JSON_WRITER_BUFFER_SIZE];
+	char weightingName[4] = "Z";
+	uint32_t frameNumber;
+
+	httpRequestGetQueryParam(request, "weighting", weightingName,
+			sizeof(weightingName));
+	if (strcmp(weightingName, "Z") == 0)
+		weighting = BAND_WEIGHTING_Z;
+	else if (strcmp(weightingName, "A") == 0)
+		weighting = BAND_WEIGHTING_A;
+	else if (strcmp(weightingName, "C") == 0)
+		weighting = BAND_WEIGHTING_C;
+	else
+		return sendError(client, "400 Bad Request", "<h1>400 Bad Request</h1>");
+
+	if (!spectrumSnapshotReadBands(&mainSpectrumSnapshot, &bands,
+			&frameNumber)) {
+		logErr("Spectrum snapshot busy");
+		return sendError(client, "503 Service Unavailable",
+				"<h1>503 Service Unavailable</h1>");
+	}
+	bandAnalysisApplyWeighting(&bands, weighting);
+
+	httpResponseInit(&response, client, "200 OK");
+	httpResponseAddHeader(&response, "Content-Type", "application/json");
+	httpResponseAddHeader(&response, "Connection", "close");
+
+	jsonWriterInitResponse(&writer, text, sizeof(text), &response);
+	jsonWriterBeginObject(&writer);
+	jsonWriterAddUint(&writer, "Frame", frameNumber);
+	jsonWriterAddString(&writer, "Weighting", weightingName);
+	jsonWriterAddFloat(&writer, "LevelZ", bands.levelZ);
+	jsonWriterAddFloat(&writer, "LevelA", bands.levelA);
+	jsonWriterAddFloat(&writer, "LevelC", bands.levelC);
+	writeBands(&writer, "ThirdOctave", bands.thirdOctave, bands.bandCount, 0);
+	writeBands(&writer, "Octave", bands.octave, bands.octaveCount, 1);
+	jsonWriterEndObject(&writer);
+	if (!jsonWriterFinish(&writer))
+		logErr("Bands JSON error");
+	return httpResponseEnd(&response);
+}
+
+/**
+ * @brief Sends the natural log of mel filterbank energies and MFCCs of the last spectrum
+ * (GET /mfcc)
+ * @param request: pointer to \ref HttpRequestStr structure
+ * @param client: pointer to \ref netconn structure
+ * @retval ERR_OK if there are no errors
+ */
+static err_t getMfccHandler(HttpRequestStr* request, struct netconn* client) {
+	HttpResponseStr response;
+	JsonWriterStr writer;
+	MfccFeaturesStr features;
+	char text[HTTP_JSON_WRITER_BUFFER_SIZE];
+	uint32_t frameNumber;
+	uint32_t i;
+
+	if (!spectrumSnapshotReadFeatures(&mainSpectrumSnapshot, &features,
+			&frameNumber)) {
+		logErr("Spectrum snapshot busy");
+		return sendError(client, "503 Service Unavailable",
+				"<h1>503 Service Unavailable</h1>");
+	}
+
+	httpResponseInit(&response, client, "200 OK");
+	httpResponseAddHeader(&response, "Content-Type", "application/json");
+	httpResponseAddHeader(&response, "Connection", "close");
+
+	jsonWriterInitResponse(&writer, text, sizeof(text), &response);
+	jsonWriterBeginObject(&writer);
+	jsonWriterAddUint(&writer, "Frame", frameNumber);
+	jsonWriterAddFloat(&writer, "LowFrequency", features.lowFrequency);
+	jsonWriterAddFloat(&writer, "HighFrequency", features.highFrequency);
+	jsonWriterKey(&writer, "LogMelEnergies");
+	jsonWriterBeginArray(&writer);
+	for (i = 0; i < MFCC_FILTER_COUNT; i++)
+		jsonWriterFloat(&writer, features.logEnergies[i]);
+	jsonWriterEndArray(&writer);
+	jsonWriterKey(&writer, "Mfcc");
+	jsonWriterBeginArray(&writer);
+	for (i = 0; i < MFCC_COEFFICIENT_COUNT; i++)
+		jsonWriterFloat(&writer, features.coefficients[i]);
+	jsonWriterEndArray(&writer);
+	jsonWriterEndObject(&writer);
+	if (!jsonWriterFinish(&writer))
+		logErr("MFCC JSON error");
+	return httpResponseEnd(&response);
+}
+
+/**
+ * @brief Upgrades the connection to WebSocket and passes it to the WebSocket task (GET /ws)
+ * @param request: pointer to \ref HttpRequestStr structure
+ * @param client: pointer to \ref netconn structure
+ * @retval ERR_OK if there are no errors
+ */
+static err_t getWebSocketHandler(HttpRequestStr* request,
+		struct netconn* client) {
+	HttpResponseStr response;
+	char accept[WEBSOCKET_ACCEPT_KEY_LENGTH + 1];
+
+	logMsg("WebSocket upgrade request");
+
+	if (!request->webSocketUpgrade || request->webSocketKey[0] == '\0')
+		return sendError(client, "400 Bad Request", "<h1>400 Bad Request</h1>");
+
+	if (!webSocketServerHasFreeSlot()) {
+		logErr("Too many WebSocket clients");
+		return sendError(client, "503 Service Unavailable",
+				"<h1>503 Service Unavailable</h1>");
+	}
+
+	webSocketComputeAccept(request->webSocketKey, accept);
+
+	httpResponseInit(&response, client, "101 Switching Protocols");
+	httpResponseAddHeader(&response, "Upgrade", "websocket");
+	httpResponseAddHeader(&response, "Connection", "Upgrade");
+	httpResponseAddHeader(&response, "Sec-WebSocket-Accept", accept);
+	httpResponseSetContentLength(&response, HTTP_RESPONSE_NO_BODY);
+	if (httpResponseEnd(&response) != ERR_OK)
+		return response.status;
+
+	if (webSocketServerAddClient(client))
+		request->connectionDetached = 1;
+	return ERR_OK;
+}
+
+/**
+ * @var HttpRouteStr httpRoutes[]
+ * @brief Route table (method and path to handler)
+ */
+static const HttpRouteStr httpRoutes[] = {
+		{ GET_REQUEST, "/config", getConfigHandler },
+		{ PUT_REQUEST, "/config", putConfigHandler },
+		{ GET_REQUEST, "/system", getSystemHandler },
+		{ GET_REQUEST, "/network", getNetworkHandler },
+		{ GET_REQUEST, "/memory", getMemoryHandler },
+		{ GET_REQUEST, "/audio", getAudioHandler },
+		{ GET_REQUEST, "/latency", getLatencyHandler },
+		{ GET_REQUEST, "/trace", getTraceHandler },
+		{ GET_REQUEST, "/log", getLogHandler },
+		{ GET_REQUEST, "/spectrum", getSpectrumHandler },
+		{ GET_REQUEST, "/peaks", getPeaksHandler },
+		{ GET_REQUEST, "/bands", getBandsHandler },
+		{ GET_REQUEST, "/level", getLevelHandler },
+		{ GET_REQUEST, "/mfcc", getMfccHandler },
+		{ GET_REQUEST, "/ws", getWebSocketHandler }
+};
+
+/**
+ * @brief Sends the response for request which could not be parsed
+ * @param request: pointer to \ref HttpRequestStr structure
+ * @param client: pointer to \ref netconn structure
+ * @retval ERR_OK if there are no errors
+ */
+static err_t sendParseError(HttpRequestStr* request, struct netconn* client) {
+	logErrVal("HTTP parse error ", request->error);
+
+	switch (request->error) {
+	case HTTP_PARSE_ERROR_URI_TOO_LONG:
+		return sendError(client, "414 URI Too Long", "<h1>414 URI Too Long</h1>");
+	case HTTP_PARSE_ERROR_HEADER_TOO_LARGE:
+		return sendError(client, "431 Request Header Fields Too Large",
+				"<h1>431 Request Header Fields Too Large</h1>");
+	case HTTP_PARSE_ERROR_BODY_TOO_LARGE:
+		return sendError(client, "413 Payload Too Large",
+				"<h1>413 Payload Too Large</h1>");
+	default:
+		return sendError(client, "400 Bad Request", "<h1>400 Bad Request</h1>");
+	}
+}
+
+/**
+ * @brief Calls the handler matching the request method and path
+ * @param request: pointer to parsed \ref HttpRequestStr structure
+ * @param client: pointer to \ref netconn structure
+ * @retval ERR_OK if there are no errors
+ */
+err_t httpServerDispatch(HttpRequestStr* request, struct netconn* client) {
+	uint8_t pathFound = FALSE;
+	uint32_t i;
+
+	if (request->method == NOT_SUPPORTED_REQUEST) {
+		logErr("Not implemented method");
+		return sendError(client, "501 Not Implemented",
+				"<h1>501 Not Implemented</h1>");
+	}
+
+	for (i = 0; i < sizeof(httpRoutes) / sizeof(httpRoutes[0]); i++) {
+		if (strcmp(httpRoutes[i].path, request->path) == 0) {
+			if (httpRoutes[i].method == request->method)
+				return httpRoutes[i].handler(request, client);
+			pathFound = TRUE;
+		}
+	}
+
+	logErr("Not supported request");
+	if (pathFound)
+		return sendError(client, "405 Method Not Allowed",
+				"<h1>405 Method Not Allowed</h1>");
+	return sendError(client, "404 Not Found", "<h1>404 Not Found</h1>");
+}
+
+/**
+ * @brief Receives the whole request from the client (also split into many segments). One segment
+ * is awaited at most the client receive timeout and the whole request at most \ref HTTP_REQUEST_TIMEOUT.
+ * @param request: pointer to \ref HttpRequestStr structure (output)
+ * @param client: pointer to \ref netconn structure (accepted connection)
+ * @retval \ref HTTP_PARSE_INCOMPLETE if the request was not received in time (no response is sent)
+ */
+HttpParseStatus httpServerReceiveRequest(HttpRequestStr* request,
+		struct netconn* client) {
+	HttpParseStatus parseStatus = HTTP_PARSE_INCOMPLETE;
+	int segmentTimeout = netconn_get_recvtimeout(client);
+	uint32_t start = HAL_GetTick();
+	uint32_t elapsed;
+	struct netbuf* recvBuf;
+	err_t netStatus;
+
+	httpRequestParserInit(request);
+
+	while (parseStatus == HTTP_PARSE_INCOMPLETE) {
+		elapsed = HAL_GetTick() - start;
+		if (elapsed >= HTTP_REQUEST_TIMEOUT) {
+			logErr("HTTP request timeout");
+			break;
+		}
+
+		// the last segment is awaited only until the request deadline
+		if (segmentTimeout <= 0
+				|| HTTP_REQUEST_TIMEOUT - elapsed < (uint32_t) segmentTimeout)
+			netconn_set_recvtimeout(client, HTTP_REQUEST_TIMEOUT - elapsed);
+
+		// receiving data from client
+		netStatus = netconn_recv(client, &recvBuf);
+		if (netStatus != ERR_OK) {
+			logErrVal("TCP no data", netStatus);
+			break;
+		}
+
+		parseStatus = httpRequestParserFeedNetbuf(request, recvBuf);
+
+		// deleting socket buffer
+		netbuf_delete(recvBuf);
+	}
+
+	netconn_set_recvtimeout(client, segmentTimeout);
+	return parseStatus;
+}
+
+/**
+ * @brief Sends the response to the request received by \ref httpServerReceiveRequest
+ * @param request: pointer to parsed \ref HttpRequestStr structure (done or with parse error)
+ * @param client: pointer to \ref netconn structure (accepted connection)
+ * @retval returns 1 if the connection was taken over by other task (it must not be closed)
+ */
+uint8_t httpServerRespond(HttpRequestStr* request, struct netconn* client) {
+	if (request->state == HTTP_PARSER_DONE)
+		httpServerDispatch(request, client);
+	else
+		sendParseError(request, client);
+
+	return request->connectionDetached;
+}
@@ -8,115 +8,148 @@
 #include "jsonConfiguration.h"
 
 /**
- * @brief Parses JSON data to \StmConfig structure
+ * @var JsonSchemaEnumStr windowTypeNames[]
+ * @brief Names of the window types used in JSON
+ */
+static const JsonSchemaEnumStr windowTypeNames[] = {
+		{ "RECTANGLE", RECTANGLE },
+		{ "HANN", HANN },
+		{ "FLAT_TOP", FLAT_TOP }
+};
+
+/**
+ * @var JsonSchemaEnumStr samplingFrequencies[]
+ * @brief Audio sampling frequencies supported by the codec (sent as numbers in JSON)
+ */
+static const JsonSchemaEnumStr samplingFrequencies[] = {
+		{ "8K", AUDIO_FREQUENCY_8K },
+		{ "11K", AUDIO_FREQUENCY_11K },
+		{ "16K", AUDIO_FREQUENCY_16K },
+		{ "22K", AUDIO_FREQUENCY_22K },
+		{ "32K", AUDIO_FREQUENCY_32K },
+		{ "44K", AUDIO_FREQUENCY_44K },
+		{ "48K", AUDIO_FREQUENCY_48K },
+		{ "96K", AUDIO_FREQUENCY_96K }
+};
+
+/**
+ * @var JsonSchemaEnumStr lcdViewNames[]
+ * @brief Names of the LCD views used in JSON
+ */
+static const JsonSchemaEnumStr lcdViewNames[] = {
+		{ "SPECTRUM", LCD_VIEW_SPECTRUM },
+		{ "WATERFALL", LCD_VIEW_WATERFALL }
+};
+
+/**
+ * @var JsonSchemaEnumStr streamContentNames[]
+ * @brief Names of the UDP streaming contents used in JSON
+ */
+static const JsonSchemaEnumStr streamContentNames[] = {
+		{ "SPECTRUM", STREAM_CONTENT_SPECTRUM },
+		{ "BANDS", STREAM_CONTENT_BANDS },
+		{ "MFCC", STREAM_CONTENT_MFCC }
+};
+
+/**
+ * @var JsonSchemaEnumStr spectrumScaleNames[]
+ * @brief Names of the spectrum scales used in JSON
+ */
+static const JsonSchemaEnumStr spectrumScaleNames[] = {
+		{ "LINEAR", SPECTRUM_SCALE_LINEAR },
+		{ "POWER", SPECTRUM_SCALE_POWER },
+		{ "DB", SPECTRUM_SCALE_DB }
+};
+
+/**
+ * @var JsonSchemaFieldStr stmConfigSchema[]
+ * @brief JSON representation of \ref StmConfig (key, type, member and allowed values)
+ */
+const JsonSchemaFieldStr stmConfigSchema[] = {
+		{ "UdpEndpointIP", JSON_SCHEMA_IPV4, offsetof(StmConfig, clientIp),
+				sizeof(((StmConfig*) 0)->clientIp), 0, 0, NULL, 0 },
+		{ "AmplitudeSamplingDelay", JSON_SCHEMA_UINT, offsetof(StmConfig,
+				amplitudeSamplingDelay), sizeof(uint8_t), 1, 255, NULL, 0 },
+		{ "SamplingFrequency", JSON_SCHEMA_UINT_SET, offsetof(StmConfig,
+				audioSamplingFrequency), sizeof(uint32_t), 0, 0,
+				samplingFrequencies, sizeof(samplingFrequencies)
+						/ sizeof(samplingFrequencies[0]) },
+		{ "UdpEndpointPort", JSON_SCHEMA_UINT, offsetof(StmConfig, clientPort),
+				sizeof(uint32_t), 1, 65535, NULL, 0 },
+		{ "WindowType", JSON_SCHEMA_ENUM, offsetof(StmConfig, windowType),
+				sizeof(uint32_t), 0, 0, windowTypeNames, sizeof(windowTypeNames)
+						/ sizeof(windowTypeNames[0]) },
+		{ "LcdView", JSON_SCHEMA_ENUM, offsetof(StmConfig, lcdView),
+				sizeof(uint32_t), 0, 0, lcdViewNames, sizeof(lcdViewNames)
+						/ sizeof(lcdViewNames[0]) },
+		{ "SyslogIP", JSON_SCHEMA_IPV4, offsetof(StmConfig, syslogIp),
+				sizeof(((StmConfig*) 0)->syslogIp), 0, 0, NULL, 0 },
+		{ "SyslogPort", JSON_SCHEMA_UINT, offsetof(StmConfig, syslogPort),
+				sizeof(uint32_t), 1, 65535, NULL, 0 },
+		{ "StreamContent", JSON_SCHEMA_ENUM, offsetof(StmConfig, streamContent),
+				sizeof(uint32_t), 0, 0, streamContentNames,
+				sizeof(streamContentNames) / sizeof(streamContentNames[0]) },
+		{ "LeqPeriod", JSON_SCHEMA_UINT, offsetof(StmConfig, leqPeriod),
+				sizeof(uint32_t), LEVEL_METER_MIN_LEQ_PERIOD,
+				LEVEL_METER_MAX_LEQ_PERIOD, NULL, 0 },
+		{ "SpectrumScale", JSON_SCHEMA_ENUM, offsetof(StmConfig, spectrumScale),
+				sizeof(uint32_t), 0, 0, spectrumScaleNames,
+				sizeof(spectrumScaleNames) / sizeof(spectrumScaleNames[0]) }
+};
+
+/**
+ * @var uint32_t stmConfigSchemaSize
+ * @brief Number of fields in \ref stmConfigSchema
+ */
+const uint32_t stmConfigSchemaSize = sizeof(stmConfigSchema)
+		/ sizeof(stmConfigSchema[0]);
+
+/**
+ * @brief Parses JSON data to \ref StmConfig structure (without memory allocation). The fields
+ * missing in JSON are set to 0 (not changed by \ref makeChanges).
  * @param jsonData: JSON data string
  * @param config: output system configuration structure
+ * @param result: output parsing result (rejected fields)
+ * @retval returns 1 if JSON is valid and all fields were accepted
  */
-void parseJSON(char* jsonData, StmConfig* config) {
-	char windowTypeStr[20];
-	char errorMsg[35];
-	cJSON* parser;
-	
+uint8_t parseJSON(char* jsonData, StmConfig* config, JsonSchemaResultStr* result) {
 	config->amplitudeSamplingDelay = 0;
 	config->audioSamplingFrequency = 0;
 	strcpy(config->clientIp, "");
 	config->clientPort = 0;
 	config->windowType = UNDEFINED;
-	
-	parser = cJSON_Parse(jsonData);
-	if(!parser)
-	{
-		sprintf(errorMsg, "cJSON error");
-		logErr(errorMsg);
-		return;
-	}
-	
-	if(cJSON_HasObjectItem(parser,"UdpEndpointIP"))
-	{
-		strcpy(config->clientIp, cJSON_GetObjectItem(parser, "UdpEndpointIP")->valuestring);
-	}
-	
-	if(cJSON_HasObjectItem(parser,"AmplitudeSamplingDelay"))
-	{
-		config->amplitudeSamplingDelay = cJSON_GetObjectItem(parser, "AmplitudeSamplingDelay")->valueint;
-	}
-	
-	if(cJSON_HasObjectItem(parser,"SamplingFrequency"))
-	{
-		config->audioSamplingFrequency = cJSON_GetObjectItem(parser, "SamplingFrequency")->valueint;
-	}
-	
-	if(cJSON_HasObjectItem(parser,"UdpEndpointPort"))
-	{
-		config->clientPort = cJSON_GetObjectItem(parser, "UdpEndpointPort")->valueint;
-	}
-	
-	if(cJSON_HasObjectItem(parser,"WindowType"))
-	{
-		strcpy(windowTypeStr, cJSON_GetObjectItem(parser, "WindowType")->valuestring);
-		
-		if(strcmp(windowTypeStr, "RECTANGLE") == 0)
-		{
-			config->windowType = RECTANGLE;
-		}
-		else if (strcmp(windowTypeStr, "HANN") == 0)
-		{
-			config->windowType = HANN;
-		}
-		else if(strcmp(windowTypeStr, "FLAT_TOP") == 0)
-		{
-			config->windowType = FLAT_TOP;
-		}
-	}
+	config->lcdView = LCD_VIEW_UNDEFINED;
+	strcpy(config->syslogIp, "");
+	config->syslogPort = 0;
+	config->streamContent = STREAM_CONTENT_UNDEFINED;
+	config->leqPeriod = 0;
+	config->spectrumScale = SPECTRUM_SCALE_UNDEFINED;
 
-	cJSON_Delete(parser);
+	if (!jsonSchemaParse(jsonData, stmConfigSchema, stmConfigSchemaSize, config,
+			result)) {
+		if (result->syntaxError)
+			logErrVal("JSON syntax error at ", result->errorPosition);
+		else
+			logErrVal("JSON rejected fields ", result->rejectedFields);
+		return 0;
+	}
+	return 1;
 }
 
 /**
- * @brief Converts \ref StmConfig structure to JSON string
+ * @brief Converts \ref StmConfig structure to JSON string (without memory allocation)
  * @param config: pointer to \ref StmConfig structure
  * @param str: pointer to output of the JSON string (must have allocated memory)
  * @param len: length of output JSON string
+ * @retval returns 1 if the whole JSON fits into \p str
  */
-void stmConfigToString(StmConfig* config, char* str, uint32_t len) {
-	char windowTypeStr[20];
-	cJSON *jsonCreator;
-	
-	switch(config->windowType)
-	{
-		case RECTANGLE:
-		{
-			strcpy(windowTypeStr, "RECTANGLE");
-			break;
-		}
-		case HANN:
-		{
-			strcpy(windowTypeStr, "HANN");
-			break;
-		}
-		case FLAT_TOP:
-		{
-			strcpy(windowTypeStr, "FLAT_TOP");
-			break;
-		}
-		default:
-		{
-			strcpy(windowTypeStr, "UNDEFINED");
-			break;
-		}
-	}
-	
-	jsonCreator = cJSON_CreateObject();
-	cJSON_AddNumberToObject(jsonCreator, "UdpEndpointPort", config->clientPort);
-	cJSON_AddNumberToObject(jsonCreator, "AmplitudeSamplingDelay",
-			config->amplitudeSamplingDelay);
-	cJSON_AddNumberToObject(jsonCreator, "SamplingFrequency",
-			config->audioSamplingFrequency);
-	cJSON_AddStringToObject(jsonCreator, "UdpEndpointIP", config->clientIp);
-	cJSON_AddStringToObject(jsonCreator, "WindowType", windowTypeStr);
+uint8_t stmConfigToString(StmConfig* config, char* str, uint32_t len) {
+	JsonWriterStr writer;
 
-	cJSON_PrintPreallocated(jsonCreator, str, len, FALSE);
-	cJSON_Delete(jsonCreator);
+	jsonWriterInit(&writer, str, len);
+	jsonWriterSchemaObject(&writer, stmConfigSchema, stmConfigSchemaSize,
+			config);
+	return jsonWriterFinish(&writer);
 }
 
 /**
@@ -125,7 +158,7 @@ void stmConfigToString(StmConfig* config, char* str, uint32_t len) {
  * @param oldConfig: pointer to old system configuration structure
  */
 void makeChanges(StmConfig* newConfig, StmConfig* oldConfig) {
-	char msg[30];
+	char msg[40];
 	uint8_t knownWindow = TRUE;
 	
 	if(newConfig->amplitudeSamplingDelay != oldConfig->amplitudeSamplingDelay && newConfig->amplitudeSamplingDelay != 0)
@@ -137,7 +170,8 @@ void makeChanges(StmConfig* newConfig, StmConfig* oldConfig) {
 	if(newConfig->audioSamplingFrequency != oldConfig->audioSamplingFrequency && newConfig->audioSamplingFrequency != 0)
 	{
 		logMsgVal("Changed sampling frequency ", newConfig->audioSamplingFrequency);
-		audioRecorderSetSamplingFrequency(newConfig->audioSamplingFrequency);
+		if (audioRecorderSwitchSamplingFrequency(newConfig->audioSamplingFrequency) != AUDIO_OK)
+			audioRecorderSetSamplingFrequency(newConfig->audioSamplingFrequency);
 		oldConfig->audioSamplingFrequency = newConfig->audioSamplingFrequency;
 	}
 	
@@ -186,4 +220,76 @@ void makeChanges(StmConfig* newConfig, StmConfig* oldConfig) {
 			oldConfig->windowType = newConfig->windowType;
 		}
 	}
+	
+	if(newConfig->lcdView != oldConfig->lcdView && newConfig->lcdView > LCD_VIEW_UNDEFINED && newConfig->lcdView <= LCD_VIEW_WATERFALL)
+	{
+		logMsg(newConfig->lcdView == LCD_VIEW_WATERFALL ? "Changed LCD view WATERFALL" : "Changed LCD view SPECTRUM");
+		oldConfig->lcdView = newConfig->lcdView;
+	}
+	
+	// 0.0.0.0 turns the syslog sink off
+	if(strcmp(newConfig->syslogIp, oldConfig->syslogIp) && strlen(newConfig->syslogIp) > 0)
+	{
+		sprintf(msg, "Changed syslog IP: %s", newConfig->syslogIp);
+		logMsg(msg);
+		strcpy(oldConfig->syslogIp, newConfig->syslogIp);
+	}
+	
+	if(newConfig->syslogPort != oldConfig->syslogPort && newConfig->syslogPort != 0)
+	{
+		logMsgVal("Changed syslog port ", newConfig->syslogPort);
+		oldConfig->syslogPort = newConfig->syslogPort;
+	}
+	
+	if(newConfig->streamContent != oldConfig->streamContent && newConfig->streamContent > STREAM_CONTENT_UNDEFINED && newConfig->streamContent <= STREAM_CONTENT_MFCC)
+	{
+		switch(newConfig->streamContent)
+		{
+			case STREAM_CONTENT_BANDS:
+			{
+				logMsg("Changed stream BANDS");
+				break;
+			}
+			case STREAM_CONTENT_MFCC:
+			{
+				logMsg("Changed stream MFCC");
+				break;
+			}
+			default:
+			{
+				logMsg("Changed stream SPECTRUM");
+				break;
+			}
+		}
+		oldConfig->streamContent = newConfig->streamContent;
+	}
+	
+	if(newConfig->leqPeriod != oldConfig->leqPeriod && newConfig->leqPeriod != 0)
+	{
+		logMsgVal("Changed Leq period ", newConfig->leqPeriod);
+		oldConfig->leqPeriod = newConfig->leqPeriod;
+	}
+	
+	if(newConfig->spectrumScale != oldConfig->spectrumScale && newConfig->spectrumScale > SPECTRUM_SCALE_UNDEFINED && newConfig->spectrumScale <= SPECTRUM_SCALE_DB)
+	{
+		switch(newConfig->spectrumScale)
+		{
+			case SPECTRUM_SCALE_POWER:
+			{
+				logMsg("Changed scale POWER");
+				break;
+			}
+			case SPECTRUM_SCALE_DB:
+			{
+				logMsg("Changed scale DB");
+				break;
+			}
+			default:
+			{
+				logMsg("Changed scale LINEAR");
+				break;
+			}
+		}
+		oldConfig->spectrumScale = newConfig->spectrumScale;
+	}
 }
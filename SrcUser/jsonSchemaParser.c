@@ -0,0 +1,533 @@
+/*
+ * jsonSchemaParser.c
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#include "jsonSchemaParser.h"
+
+/**
+ * @brief Skips white spaces
+ * @param json: pointer to current position (updated)
+ */
+static void skipWhitespace(const char** json) {
+	while (**json == ' ' || **json == '\t' || **json == '\r' || **json == '\n')
+		(*json)++;
+}
+
+/**
+ * @brief Checks if the character is a hexadecimal digit
+ * @param c: character
+ * @retval returns 1 if \p c is a hexadecimal digit
+ */
+static uint8_t isHexDigit(char c) {
+	return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f')
+			|| (c >= 'A' && c <= 'F');
+}
+
+/**
+ * @brief Parses the string (the current position points to the opening quote).
+ * Escaped characters are decoded, characters outside ASCII are replaced by '?'.
+ * @param json: pointer to current position (updated)
+ * @param str: output buffer (may be NULL if the string is only skipped)
+ * @param size: output buffer size
+ * @param truncated: set to 1 if the string did not fit into \p str
+ * @retval returns 0 on syntax error
+ */
+static uint8_t parseString(const char** json, char* str, uint32_t size,
+		uint8_t* truncated) {
+	const char* position = *json + 1;
+	uint32_t length = 0;
+	char c;
+
+	*truncated = 0;
+
+	while (*position != '"') {
+		c = *position++;
+		if (c == '\0' || (uint8_t) c < 0x20)
+			return 0;
+
+		if (c == '\\') {
+			c = *position++;
+			switch (c) {
+			case '"':
+			case '\\':
+			case '/':
+				break;
+			case 'b':
+				c = '\b';
+				break;
+			case 'f':
+				c = '\f';
+				break;
+			case 'n':
+				c = '\n';
+				break;
+			case 'r':
+				c = '\r';
+				break;
+			case 't':
+				c = '\t';
+				break;
+			case 'u':
+				if (!isHexDigit(position[0]) || !isHexDigit(position[1])
+						|| !isHexDigit(position[2]) || !isHexDigit(position[3]))
+					return 0;
+				position += 4;
+				c = '?';
+				break;
+			default:
+				return 0;
+			}
+		}
+
+		if (str != NULL) {
+			if (length + 1 < size)
+				str[length++] = c;
+			else
+				*truncated = 1;
+		}
+	}
+
+	if (str != NULL)
+		str[length] = '\0';
+	*json = position + 1;
+	return 1;
+}
+
+/**
+ * @brief Parses the number. Only non-negative integers are converted to \p value.
+ * @param json: pointer to current position (updated)
+ * @param value: output value
+ * @param isUint: set to 1 if the number is an integer which fits into uint32_t
+ * @retval returns 0 on syntax error
+ */
+static uint8_t parseNumber(const char** json, uint32_t* value, uint8_t* isUint) {
+	const char* position = *json;
+	uint32_t result = 0;
+	uint8_t digits = 0;
+
+	*isUint = 1;
+
+	if (*position == '-') {
+		*isUint = 0;
+		position++;
+	}
+
+	// integer part (leading zeros are not allowed)
+	if (*position == '0') {
+		position++;
+		digits = 1;
+	} else {
+		while (*position >= '0' && *position <= '9') {
+			uint32_t digit = *position - '0';
+			if (result > (0xFFFFFFFF - digit) / 10)
+				*isUint = 0;
+			result = result * 10 + digit;
+			position++;
+			digits++;
+		}
+	}
+	if (digits == 0)
+		return 0;
+
+	// fraction
+	if (*position == '.') {
+		*isUint = 0;
+		position++;
+		if (*position < '0' || *position > '9')
+			return 0;
+		while (*position >= '0' && *position <= '9')
+			position++;
+	}
+
+	// exponent
+	if (*position == 'e' || *position == 'E') {
+		*isUint = 0;
+		position++;
+		if (*position == '+' || *position == '-')
+			position++;
+		if (*position < '0' || *position > '9')
+			return 0;
+		while (*position >= '0' && *position <= '9')
+			position++;
+	}
+
+	*value = result;
+	*json = position;
+	return 1;
+}
+
+/**
+ * @brief Skips any value (used for unknown keys and values of wrong type)
+ * @param json: pointer to current position (updated)
+ * @param depth: current nesting level
+ * @retval returns 0 on syntax error
+ */
+static uint8_t skipValue(const char** json, uint32_t depth) {
+	uint32_t number;
+	uint8_t flag;
+	char closing;
+
+	skipWhitespace(json);
+
+	switch (**json) {
+	case '"':
+		return parseString(json, NULL, 0, &flag);
+	case 't':
+		if (strncmp(*json, "true", 4) != 0)
+			return 0;
+		*json += 4;
+		return 1;
+	case 'f':
+		if (strncmp(*json, "false", 5) != 0)
+			return 0;
+		*json += 5;
+		return 1;
+	case 'n':
+		if (strncmp(*json, "null", 4) != 0)
+			return 0;
+		*json += 4;
+		return 1;
+	case '{':
+	case '[':
+		if (depth >= JSON_SCHEMA_MAX_DEPTH)
+			return 0;
+		closing = **json == '{' ? '}' : ']';
+		(*json)++;
+		skipWhitespace(json);
+		if (**json == closing) {
+			(*json)++;
+			return 1;
+		}
+		for (;;) {
+			if (closing == '}') {
+				skipWhitespace(json);
+				if (**json != '"' || !parseString(json, NULL, 0, &flag))
+					return 0;
+				skipWhitespace(json);
+				if (**json != ':')
+					return 0;
+				(*json)++;
+			}
+			if (!skipValue(json, depth + 1))
+				return 0;
+			skipWhitespace(json);
+			if (**json == closing) {
+				(*json)++;
+				return 1;
+			}
+			if (**json != ',')
+				return 0;
+			(*json)++;
+		}
+		break;
+	default:
+		return parseNumber(json, &number, &flag);
+	}
+}
+
+/**
+ * @brief Checks if the text is an IPv4 address in dotted decimal notation
+ * @param str: text
+ * @retval returns 1 if \p str is a valid address
+ */
+static uint8_t isIpv4Address(const char* str) {
+	uint32_t octets = 0;
+	uint32_t value;
+	uint32_t digits;
+
+	for (;;) {
+		value = 0;
+		digits = 0;
+		while (*str >= '0' && *str <= '9' && digits < 4) {
+			value = value * 10 + (*str++ - '0');
+			digits++;
+		}
+		if (digits == 0 || digits > 3 || value > 255)
+			return 0;
+		octets++;
+
+		if (*str == '\0')
+			return octets == 4;
+		if (*str != '.' || octets == 4)
+			return 0;
+		str++;
+	}
+}
+
+/**
+ * @brief Stores the unsigned value in the destination member (1, 2 or 4 bytes)
+ * @param field: pointer to \ref JsonSchemaFieldStr
+ * @param destination: pointer to destination structure
+ * @param value: value
+ */
+static void storeUint(const JsonSchemaFieldStr* field, void* destination,
+		uint32_t value) {
+	uint8_t* member = (uint8_t*) destination + field->offset;
+
+	switch (field->size) {
+	case 1:
+		*member = (uint8_t) value;
+		break;
+	case 2:
+		*(uint16_t*) member = (uint16_t) value;
+		break;
+	default:
+		*(uint32_t*) member = value;
+		break;
+	}
+}
+
+/**
+ * @brief Loads the unsigned value of the member (1, 2 or 4 bytes)
+ * @param field: pointer to \ref JsonSchemaFieldStr
+ * @param source: pointer to source structure
+ * @retval member value
+ */
+static uint32_t loadUint(const JsonSchemaFieldStr* field, const void* source) {
+	const uint8_t* member = (const uint8_t*) source + field->offset;
+
+	switch (field->size) {
+	case 1:
+		return *member;
+	case 2:
+		return *(const uint16_t*) member;
+	default:
+		return *(const uint32_t*) member;
+	}
+}
+
+/**
+ * @brief Checks the unsigned value against the range or the set of allowed values
+ * @param field: pointer to \ref JsonSchemaFieldStr (\ref JSON_SCHEMA_UINT or \ref JSON_SCHEMA_UINT_SET)
+ * @param value: checked value
+ * @retval returns 1 if the value is allowed
+ */
+static uint8_t isUintAllowed(const JsonSchemaFieldStr* field, uint32_t value) {
+	uint32_t i;
+
+	if (field->type == JSON_SCHEMA_UINT)
+		return value >= field->min && value <= field->max;
+
+	for (i = 0; i < field->enumCount; i++) {
+		if (field->enumValues[i].value == value)
+			return 1;
+	}
+	return 0;
+}
+
+/**
+ * @brief Checks the member value in the same way as the parsed JSON value
+ * @param field: pointer to \ref JsonSchemaFieldStr
+ * @param source: pointer to source structure
+ * @retval returns 1 if the value would be accepted by \ref parseField
+ */
+static uint8_t isMemberValid(const JsonSchemaFieldStr* field,
+		const void* source) {
+	const char* str = (const char*) source + field->offset;
+	uint32_t value;
+	uint32_t i;
+
+	switch (field->type) {
+	case JSON_SCHEMA_UINT:
+	case JSON_SCHEMA_UINT_SET:
+		return isUintAllowed(field, loadUint(field, source));
+	case JSON_SCHEMA_IPV4:
+		return memchr(str, '\0', field->size) != NULL && isIpv4Address(str);
+	case JSON_SCHEMA_STRING:
+		return memchr(str, '\0', field->size) != NULL;
+	case JSON_SCHEMA_ENUM:
+		value = loadUint(field, source);
+		for (i = 0; i < field->enumCount; i++) {
+			if (field->enumValues[i].value == value)
+				return 1;
+		}
+		return 0;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * @brief Parses the value of the known field and stores it if it is valid
+ * @param json: pointer to current position (updated)
+ * @param field: pointer to \ref JsonSchemaFieldStr
+ * @param destination: pointer to destination structure
+ * @param rejected: set to 1 if the value has wrong type or it is out of range
+ * @retval returns 0 on syntax error
+ */
+static uint8_t parseField(const char** json, const JsonSchemaFieldStr* field,
+		void* destination, uint8_t* rejected) {
+	char str[JSON_SCHEMA_MAX_STRING_LENGTH + 1];
+	uint32_t value;
+	uint8_t flag;
+	uint32_t i;
+
+	*rejected = 1;
+
+	if (field->type == JSON_SCHEMA_UINT || field->type == JSON_SCHEMA_UINT_SET) {
+		if (**json != '-' && (**json < '0' || **json > '9'))
+			return skipValue(json, 0);
+		if (!parseNumber(json, &value, &flag))
+			return 0;
+		if (flag && isUintAllowed(field, value)) {
+			storeUint(field, destination, value);
+			*rejected = 0;
+		}
+		return 1;
+	}
+
+	// string, IPv4 and enum fields
+	if (**json != '"')
+		return skipValue(json, 0);
+	if (!parseString(json, str, sizeof(str), &flag))
+		return 0;
+	if (flag)
+		return 1;
+
+	switch (field->type) {
+	case JSON_SCHEMA_IPV4:
+		if (!isIpv4Address(str))
+			return 1;
+		// no break
+	case JSON_SCHEMA_STRING:
+		if (strlen(str) >= field->size)
+			return 1;
+		strcpy((char*) destination + field->offset, str);
+		*rejected = 0;
+		break;
+	case JSON_SCHEMA_ENUM:
+		for (i = 0; i < field->enumCount; i++) {
+			if (strcmp(field->enumValues[i].name, str) == 0) {
+				storeUint(field, destination, field->enumValues[i].value);
+				*rejected = 0;
+				break;
+			}
+		}
+		break;
+	default:
+		break;
+	}
+	return 1;
+}
+
+/**
+ * @brief Parses the object members and writes the known fields
+ * @param json: pointer to current position (updated, points to the error on failure)
+ * @param schema: array of \ref JsonSchemaFieldStr
+ * @param fieldCount: number of fields in \p schema
+ * @param destination: pointer to destination structure
+ * @param result: output \ref JsonSchemaResultStr
+ * @retval returns 0 on syntax error
+ */
+static uint8_t parseObject(const char** json, const JsonSchemaFieldStr* schema,
+		uint32_t fieldCount, void* destination, JsonSchemaResultStr* result) {
+	char key[JSON_SCHEMA_MAX_KEY_LENGTH + 1];
+	uint8_t truncated;
+	uint8_t rejected;
+	uint32_t i;
+
+	skipWhitespace(json);
+	if (**json != '{')
+		return 0;
+	(*json)++;
+	skipWhitespace(json);
+	if (**json == '}') {
+		(*json)++;
+		return 1;
+	}
+
+	for (;;) {
+		// key
+		skipWhitespace(json);
+		if (**json != '"' || !parseString(json, key, sizeof(key), &truncated))
+			return 0;
+		skipWhitespace(json);
+		if (**json != ':')
+			return 0;
+		(*json)++;
+		skipWhitespace(json);
+
+		// value
+		for (i = 0; i < fieldCount && !truncated; i++) {
+			if (strcmp(schema[i].name, key) == 0)
+				break;
+		}
+		if (i < fieldCount && !truncated) {
+			if (!parseField(json, &schema[i], destination, &rejected))
+				return 0;
+			result->foundFields |= 1u << i;
+			if (rejected)
+				result->rejectedFields |= 1u << i;
+			else
+				result->rejectedFields &= ~(1u << i);
+		} else {
+			if (!skipValue(json, 0))
+				return 0;
+			result->unknownFields++;
+		}
+
+		skipWhitespace(json);
+		if (**json == '}') {
+			(*json)++;
+			return 1;
+		}
+		if (**json != ',')
+			return 0;
+		(*json)++;
+	}
+}
+
+/**
+ * @brief Parses the JSON object in one pass and writes the values directly to \p destination
+ * (no memory is allocated). Fields missing in JSON are not changed. Values with wrong type
+ * or out of range are not written and they are reported in \p result.
+ * @param json: JSON text (null terminated)
+ * @param schema: array of \ref JsonSchemaFieldStr describing the destination structure
+ * @param fieldCount: number of fields in \p schema (at most \ref JSON_SCHEMA_MAX_FIELDS)
+ * @param destination: pointer to destination structure
+ * @param result: output \ref JsonSchemaResultStr
+ * @retval returns 1 if JSON is valid and no field was rejected
+ */
+uint8_t jsonSchemaParse(const char* json, const JsonSchemaFieldStr* schema,
+		uint32_t fieldCount, void* destination, JsonSchemaResultStr* result) {
+	const char* position = json;
+
+	memset(result, 0, sizeof(JsonSchemaResultStr));
+
+	if (parseObject(&position, schema, fieldCount, destination, result)) {
+		skipWhitespace(&position);
+		if (*position == '\0')
+			return result->rejectedFields == 0;
+	}
+
+	result->syntaxError = 1;
+	result->errorPosition = position - json;
+	return 0;
+}
+
+/**
+ * @brief Copies the members of the structure which pass the same checks as the values
+ * parsed by \ref jsonSchemaParse (e.g. configuration loaded from storage). Rejected
+ * members of \p destination are not changed.
+ * @param schema: array of \ref JsonSchemaFieldStr describing both structures
+ * @param fieldCount: number of fields in \p schema (at most \ref JSON_SCHEMA_MAX_FIELDS)
+ * @param destination: pointer to destination structure
+ * @param source: pointer to source structure
+ * @retval bit n is set if n-th field was rejected
+ */
+uint32_t jsonSchemaCopyValid(const JsonSchemaFieldStr* schema,
+		uint32_t fieldCount, void* destination, const void* source) {
+	uint32_t rejectedFields = 0;
+	uint32_t i;
+
+	for (i = 0; i < fieldCount; i++) {
+		if (isMemberValid(&schema[i], source))
+			memcpy((uint8_t*) destination + schema[i].offset,
+					(const uint8_t*) source + schema[i].offset, schema[i].size);
+		else
+			rejectedFields |= 1u << i;
+	}
+	return rejectedFields;
+}
@@ -0,0 +1,400 @@
+/*
+ * jsonWriter.c
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#include "jsonWriter.h"
+
+/**
+ * @brief Sends the buffered text as the next part of the response
+ * @param writer: pointer to \ref JsonWriterStr structure
+ * @retval returns 1 if the buffer was sent
+ */
+static uint8_t flush(JsonWriterStr* writer) {
+	if (writer->response == NULL)
+		return 0;
+
+	if (writer->length > 0
+			&& httpResponseWrite(writer->response, writer->buffer,
+					writer->length, HTTP_CONTENT_VOLATILE) != ERR_OK)
+		return 0;
+	writer->length = 0;
+	return 1;
+}
+
+/**
+ * @brief Appends the text. If the buffer is full it is flushed (response mode)
+ * or the overflow is reported (the text written so far stays null terminated).
+ * @param writer: pointer to \ref JsonWriterStr structure
+ * @param data: text
+ * @param length: text length
+ */
+static void append(JsonWriterStr* writer, const char* data, uint32_t length) {
+	uint32_t part;
+
+	while (length > 0 && !writer->overflow) {
+		// one byte is always left for the terminating null
+		if (writer->length + 1 >= writer->size && !flush(writer)) {
+			writer->overflow = 1;
+			break;
+		}
+
+		part = writer->size - 1 - writer->length;
+		if (part > length)
+			part = length;
+		memcpy(&writer->buffer[writer->length], data, part);
+		writer->length += part;
+		data += part;
+		length -= part;
+	}
+
+	if (writer->size > 0)
+		writer->buffer[writer->length] = '\0';
+}
+
+/**
+ * @brief Writes the separator before the next value (comma if it is not the first element)
+ * @param writer: pointer to \ref JsonWriterStr structure
+ */
+static void beginValue(JsonWriterStr* writer) {
+	if (writer->afterKey) {
+		writer->afterKey = 0;
+		return;
+	}
+	if (writer->depth > 0) {
+		if (writer->hasElements[writer->depth - 1])
+			append(writer, ",", 1);
+		writer->hasElements[writer->depth - 1] = 1;
+	}
+}
+
+/**
+ * @brief Writes the quoted and escaped string
+ * @param writer: pointer to \ref JsonWriterStr structure
+ * @param str: string
+ */
+static void appendQuoted(JsonWriterStr* writer, const char* str) {
+	const char* plain = str;
+	char escaped[8];
+
+	append(writer, "\"", 1);
+	for (; *str != '\0'; str++) {
+		if (*str != '"' && *str != '\\' && (uint8_t) *str >= 0x20)
+			continue;
+
+		// writing the plain part at once
+		append(writer, plain, str - plain);
+		if (*str == '"' || *str == '\\') {
+			escaped[0] = '\\';
+			escaped[1] = *str;
+			append(writer, escaped, 2);
+		} else {
+			sprintf(escaped, "\\u%04x", (uint8_t) *str);
+			append(writer, escaped, 6);
+		}
+		plain = str + 1;
+	}
+	append(writer, plain, str - plain);
+	append(writer, "\"", 1);
+}
+
+/**
+ * @brief Opens the container (object or array)
+ * @param writer: pointer to \ref JsonWriterStr structure
+ * @param bracket: opening bracket
+ */
+static void beginContainer(JsonWriterStr* writer, const char* bracket) {
+	beginValue(writer);
+	append(writer, bracket, 1);
+	if (writer->depth >= JSON_WRITER_MAX_DEPTH) {
+		writer->overflow = 1;
+		return;
+	}
+	writer->hasElements[writer->depth++] = 0;
+}
+
+/**
+ * @brief Closes the container (object or array)
+ * @param writer: pointer to \ref JsonWriterStr structure
+ * @param bracket: closing bracket
+ */
+static void endContainer(JsonWriterStr* writer, const char* bracket) {
+	if (writer->depth > 0)
+		writer->depth--;
+	append(writer, bracket, 1);
+}
+
+/**
+ * @brief Initializes the writer which writes to the bounded buffer
+ * @param writer: pointer to \ref JsonWriterStr structure
+ * @param buffer: output buffer
+ * @param size: output buffer size (with the terminating null)
+ */
+void jsonWriterInit(JsonWriterStr* writer, char* buffer, uint32_t size) {
+	writer->buffer = buffer;
+	writer->size = size;
+	writer->length = 0;
+	writer->response = NULL;
+	writer->overflow = size == 0;
+	writer->depth = 0;
+	writer->afterKey = 0;
+	if (size > 0)
+		buffer[0] = '\0';
+}
+
+/**
+ * @brief Initializes the writer which sends the JSON as parts of HTTP response
+ * @param writer: pointer to \ref JsonWriterStr structure
+ * @param buffer: buffer for one part of the response
+ * @param size: buffer size
+ * @param response: pointer to initialized \ref HttpResponseStr structure
+ */
+void jsonWriterInitResponse(JsonWriterStr* writer, char* buffer, uint32_t size,
+		HttpResponseStr* response) {
+	jsonWriterInit(writer, buffer, size);
+	writer->response = response;
+}
+
+/**
+ * @brief Opens the object
+ * @param writer: pointer to \ref JsonWriterStr structure
+ */
+void jsonWriterBeginObject(JsonWriterStr* writer) {
+	beginContainer(writer, "{");
+}
+
+/**
+ * @brief Closes the object
+ * @param writer: pointer to \ref JsonWriterStr structure
+ */
+void jsonWriterEndObject(JsonWriterStr* writer) {
+	endContainer(writer, "}");
+}
+
+/**
+ * @brief Opens the array
+ * @param writer: pointer to \ref JsonWriterStr structure
+ */
+void jsonWriterBeginArray(JsonWriterStr* writer) {
+	beginContainer(writer, "[");
+}
+
+/**
+ * @brief Closes the array
+ * @param writer: pointer to \ref JsonWriterStr structure
+ */
+void jsonWriterEndArray(JsonWriterStr* writer) {
+	endContainer(writer, "]");
+}
+
+/**
+ * @brief Writes the object key (the next call writes its value)
+ * @param writer: pointer to \ref JsonWriterStr structure
+ * @param key: key
+ */
+void jsonWriterKey(JsonWriterStr* writer, const char* key) {
+	beginValue(writer);
+	appendQuoted(writer, key);
+	append(writer, ":", 1);
+	writer->afterKey = 1;
+}
+
+/**
+ * @brief Writes the string value
+ * @param writer: pointer to \ref JsonWriterStr structure
+ * @param value: string
+ */
+void jsonWriterString(JsonWriterStr* writer, const char* value) {
+	beginValue(writer);
+	appendQuoted(writer, value);
+}
+
+/**
+ * @brief Writes the unsigned integer value
+ * @param writer: pointer to \ref JsonWriterStr structure
+ * @param value: value
+ */
+void jsonWriterUint(JsonWriterStr* writer, uint32_t value) {
+	char text[12];
+
+	beginValue(writer);
+	append(writer, text, sprintf(text, "%lu", (unsigned long) value));
+}
+
+/**
+ * @brief Writes the 64-bit unsigned integer value (converted without printf which may not support long long)
+ * @param writer: pointer to \ref JsonWriterStr structure
+ * @param value: value
+ */
+void jsonWriterUint64(JsonWriterStr* writer, uint64_t value) {
+	char text[20];
+	uint32_t position = sizeof(text);
+
+	do {
+		text[--position] = '0' + value % 10;
+		value /= 10;
+	} while (value > 0);
+
+	beginValue(writer);
+	append(writer, &text[position], sizeof(text) - position);
+}
+
+/**
+ * @brief Writes the integer value
+ * @param writer: pointer to \ref JsonWriterStr structure
+ * @param value: value
+ */
+void jsonWriterInt(JsonWriterStr* writer, int32_t value) {
+	char text[12];
+
+	beginValue(writer);
+	append(writer, text, sprintf(text, "%ld", (long) value));
+}
+
+/**
+ * @brief Writes the floating point value (NaN and infinity are written as null)
+ * @param writer: pointer to \ref JsonWriterStr structure
+ * @param value: value
+ */
+void jsonWriterFloat(JsonWriterStr* writer, float value) {
+	char text[20];
+
+	beginValue(writer);
+	if (value != value || value > 3.4e38f || value < -3.4e38f)
+		append(writer, "null", 4);
+	else
+		append(writer, text, snprintf(text, sizeof(text), "%g", value));
+}
+
+/**
+ * @brief Writes the key and string value
+ * @param writer: pointer to \ref JsonWriterStr structure
+ * @param key: key
+ * @param value: string
+ */
+void jsonWriterAddString(JsonWriterStr* writer, const char* key,
+		const char* value) {
+	jsonWriterKey(writer, key);
+	jsonWriterString(writer, value);
+}
+
+/**
+ * @brief Writes the key and unsigned integer value
+ * @param writer: pointer to \ref JsonWriterStr structure
+ * @param key: key
+ * @param value: value
+ */
+void jsonWriterAddUint(JsonWriterStr* writer, const char* key, uint32_t value) {
+	jsonWriterKey(writer, key);
+	jsonWriterUint(writer, value);
+}
+
+/**
+ * @brief Writes the key and 64-bit unsigned integer value
+ * @param writer: pointer to \ref JsonWriterStr structure
+ * @param key: key
+ * @param value: value
+ */
+void jsonWriterAddUint64(JsonWriterStr* writer, const char* key,
+		uint64_t value) {
+	jsonWriterKey(writer, key);
+	jsonWriterUint64(writer, value);
+}
+
+/**
+ * @brief Writes the key and floating point value
+ * @param writer: pointer to \ref JsonWriterStr structure
+ * @param key: key
+ * @param value: value
+ */
+void jsonWriterAddFloat(JsonWriterStr* writer, const char* key, float value) {
+	jsonWriterKey(writer, key);
+	jsonWriterFloat(writer, value);
+}
+
+/**
+ * @brief Writes the structure described by the schema as JSON object
+ * (the same representation as parsed by \ref jsonSchemaParse)
+ * @param writer: pointer to \ref JsonWriterStr structure
+ * @param schema: array of \ref JsonSchemaFieldStr
+ * @param fieldCount: number of fields in \p schema
+ * @param source: pointer to source structure
+ */
+void jsonWriterSchemaObject(JsonWriterStr* writer,
+		const JsonSchemaFieldStr* schema, uint32_t fieldCount,
+		const void* source) {
+	const uint8_t* member;
+	uint32_t value;
+	uint32_t i;
+	uint32_t j;
+
+	jsonWriterBeginObject(writer);
+	for (i = 0; i < fieldCount; i++) {
+		member = (const uint8_t*) source + schema[i].offset;
+
+		if (schema[i].type == JSON_SCHEMA_STRING
+				|| schema[i].type == JSON_SCHEMA_IPV4) {
+			jsonWriterAddString(writer, schema[i].name, (const char*) member);
+			continue;
+		}
+
+		if (schema[i].size == 1)
+			value = *member;
+		else if (schema[i].size == 2)
+			value = *(const uint16_t*) member;
+		else
+			value = *(const uint32_t*) member;
+
+		if (schema[i].type == JSON_SCHEMA_ENUM) {
+			for (j = 0; j < schema[i].enumCount; j++) {
+				if (schema[i].enumValues[j].value == value)
+					break;
+			}
+			jsonWriterAddString(writer, schema[i].name,
+					j < schema[i].enumCount ?
+							schema[i].enumValues[j].name : "UNDEFINED");
+		} else {
+			jsonWriterAddUint(writer, schema[i].name, value);
+		}
+	}
+	jsonWriterEndObject(writer);
+}
+
+/**
+ * @brief Writes the parsing result as JSON object: {"SyntaxError":..,"Rejected":[..],"Unknown":..}
+ * (SyntaxError only if there was one)
+ * @param writer: pointer to \ref JsonWriterStr structure
+ * @param schema: array of \ref JsonSchemaFieldStr used for parsing
+ * @param fieldCount: number of fields in \p schema
+ * @param result: pointer to \ref JsonSchemaResultStr
+ */
+void jsonWriterSchemaResult(JsonWriterStr* writer,
+		const JsonSchemaFieldStr* schema, uint32_t fieldCount,
+		const JsonSchemaResultStr* result) {
+	uint32_t i;
+
+	jsonWriterBeginObject(writer);
+	if (result->syntaxError)
+		jsonWriterAddUint(writer, "SyntaxError", result->errorPosition);
+	jsonWriterKey(writer, "Rejected");
+	jsonWriterBeginArray(writer);
+	for (i = 0; i < fieldCount; i++) {
+		if (result->rejectedFields & (1u << i))
+			jsonWriterString(writer, schema[i].name);
+	}
+	jsonWriterEndArray(writer);
+	jsonWriterAddUint(writer, "Unknown", result->unknownFields);
+	jsonWriterEndObject(writer);
+}
+
+/**
+ * @brief Finishes writing (in response mode the rest of the buffer is sent)
+ * @param writer: pointer to \ref JsonWriterStr structure
+ * @retval returns 1 if the whole JSON was written
+ */
+uint8_t jsonWriterFinish(JsonWriterStr* writer) {
+	if (writer->response != NULL && !writer->overflow && !flush(writer))
+		writer->overflow = 1;
+	return !writer->overflow && writer->depth == 0;
+}
@@ -8,33 +8,104 @@
 #include "lcdAmplitudePrinter.h"
 
 /**
- * @brief The function prints the amplitude \p amp on the LCD screen.
- * @param amp: pointer to \ref SpectrumStr structure
+ * @var float32_t columns[]
+ * @brief Spectrum bins copied from the snapshot (one bin per LCD column)
  */
-void lcdAmpPrinterPrint(SpectrumStr* amp) {
+static float32_t columns[LCD_WIDTH];
 
-	uint16_t ampVal;
-	uint16_t itCount = LCD_WIDTH;
-	if (LCD_WIDTH > amp->vectorSize)
-		itCount = amp->vectorSize;
+/**
+ * @var uint16_t barTops[][]
+ * @brief Top row of the bar drawn in every column of every framebuffer (rows above it have background color)
+ */
+static uint16_t barTops[LCD_FRAME_BUFFER_COUNT][LCD_WIDTH];
+
+/**
+ * @var uint32_t lastFrameNumber
+ * @brief Number of the last drawn spectrum
+ */
+static uint32_t lastFrameNumber = 0;
+
+/**
+ * @var float32_t maxAmp
+ * @brief The biggest amplitude shown so far (it scales the bars)
+ */
+static float32_t maxAmp = 1;
+
+/**
+ * @brief Redraws the column only where the bar top was moved since the framebuffer was drawn last time
+ * @param bufferIndex: framebuffer index
+ * @param column: column index
+ * @param top: new top row of the bar
+ */
+static void drawBar(uint32_t bufferIndex, uint32_t column, uint16_t top) {
+	uint16_t previousTop = barTops[bufferIndex][column];
+
+	if (previousTop == LCD_AMP_PRINTER_UNKNOWN_BAR) {
+		lcdFrameBufferFillRect(bufferIndex, column, 0, 1, top,
+		LCD_AMP_PRINTER_BACKGROUND_COLOR);
+		lcdFrameBufferFillRect(bufferIndex, column, top, 1, LCD_HEIGHT - top,
+		LCD_AMP_PRINTER_BAR_COLOR);
+	} else if (top < previousTop)
+		lcdFrameBufferFillRect(bufferIndex, column, top, 1, previousTop - top,
+		LCD_AMP_PRINTER_BAR_COLOR);
+	else if (top > previousTop)
+		lcdFrameBufferFillRect(bufferIndex, column, previousTop, 1,
+				top - previousTop, LCD_AMP_PRINTER_BACKGROUND_COLOR);
+
+	barTops[bufferIndex][column] = top;
+}
+
+/**
+ * @brief Clears the framebuffers and forces drawing of all columns by the next \ref lcdAmpPrinterPrint
+ */
+void lcdAmpPrinterInit() {
+	uint32_t buffer;
+	uint32_t i;
+
+	for (buffer = 0; buffer < LCD_FRAME_BUFFER_COUNT; buffer++) {
+		lcdFrameBufferFillRect(buffer, 0, 0, LCD_WIDTH, LCD_HEIGHT,
+		LCD_AMP_PRINTER_BACKGROUND_COLOR);
+		for (i = 0; i < LCD_WIDTH; i++)
+			barTops[buffer][i] = LCD_AMP_PRINTER_UNKNOWN_BAR;
+	}
+	lcdFrameBufferWaitForDma2d();
+	lastFrameNumber = 0;
+	maxAmp = 1;
+}
 
-	static float32_t maxAmp = 1;
-	float32_t newMaxAmp = soundProcessingGetStrongestFrequency(amp, 1,
-			itCount - 1).amplitude;
+/**
+ * @brief The function prints the last published spectrum to the framebuffer. The spectrum
+ * is copied without locking and only the changed parts of the bars are filled by DMA2D.
+ * @param snapshot: pointer to \ref SpectrumSnapshotStr structure
+ * @param bufferIndex: index of the framebuffer which is not shown
+ * @retval returns 1 if the new spectrum was printed
+ */
+uint8_t lcdAmpPrinterPrint(SpectrumSnapshotStr* snapshot, uint32_t bufferIndex) {
+	SpectrumSnapshotInfoStr info;
+	float32_t newMaxAmp;
+	uint32_t maxIndex;
+	uint32_t ampVal;
+	uint32_t i;
+
+	if (!spectrumSnapshotRead(snapshot, columns, 0, LCD_WIDTH, 1, &info)
+			|| info.count < 2 || info.frameNumber == lastFrameNumber)
+		return 0;
+	lastFrameNumber = info.frameNumber;
+	soundProcessingToMagnitude(columns, info.count, info.scale);
+
+	// the constant component is not used for scaling
+	arm_max_f32(&columns[1], info.count - 1, &newMaxAmp, &maxIndex);
 	if (newMaxAmp > maxAmp)
 		maxAmp = newMaxAmp;
 
-	for (uint16_t i = 0; i < itCount; i++) {
-		ampVal = (maxAmp - amp->amplitudeVector[i]) / maxAmp * LCD_HEIGHT;
+	for (i = 0; i < info.count; i++) {
+		ampVal = columns[i] >= maxAmp ?
+				0 : (maxAmp - columns[i]) / maxAmp * LCD_HEIGHT;
 		if (ampVal > LCD_HEIGHT)
 			ampVal = LCD_HEIGHT;
-
-		for (uint32_t j = 0; j < LCD_HEIGHT; j++) {
-			if (j < ampVal) {
-				BSP_LCD_DrawPixel(i, j, LCD_COLOR_WHITE);
-			} else {
-				BSP_LCD_DrawPixel(i, j, LCD_COLOR_BLACK);
-			}
-		}
+		drawBar(bufferIndex, i, ampVal);
 	}
+
+	lcdFrameBufferWaitForDma2d();
+	return 1;
 }
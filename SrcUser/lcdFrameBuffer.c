@@ -0,0 +1,206 @@
+/*
+ * lcdFrameBuffer.c
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#include "lcdFrameBuffer.h"
+
+/**
+ * @var LTDC_HandleTypeDef hLtdcHandler
+ * @brief LTDC handler of the LCD driver (layer 0 is shown)
+ */
+extern LTDC_HandleTypeDef hLtdcHandler;
+
+/**
+ * @var uint8_t frontIndex
+ * @brief Index of the shown framebuffer
+ */
+static volatile uint8_t frontIndex = 0;
+
+/**
+ * @var uint8_t pendingIndex
+ * @brief Index of the framebuffer shown at the next vertical blanking (\ref LCD_FRAME_BUFFER_NO_SWAP if none)
+ */
+static volatile uint8_t pendingIndex = LCD_FRAME_BUFFER_NO_SWAP;
+
+/**
+ * @var osThreadId swapTask
+ * @brief Task which waits for the swap
+ */
+static osThreadId swapTask = NULL;
+
+/**
+ * @var osMutexId dma2dMutex_id
+ * @brief DMA2D owner (the LCD task draws the spectrum, the logger task clears the overlay)
+ */
+osMutexDef(dma2dMutex);
+static osMutexId dma2dMutex_id = NULL;
+
+/**
+ * @brief Starts page flipping (layer 0 shows the first framebuffer set by \ref lcdInit)
+ * and creates DMA2D mutex. It is called by \ref lcdInit before the drawing tasks are started.
+ */
+void lcdFrameBufferInit() {
+	frontIndex = 0;
+	pendingIndex = LCD_FRAME_BUFFER_NO_SWAP;
+
+	dma2dMutex_id = osMutexCreate(osMutex(dma2dMutex));
+
+	HAL_NVIC_SetPriority(LTDC_IRQn, LCD_FRAME_BUFFER_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(LTDC_IRQn);
+}
+
+/**
+ * @brief Gets the address of the framebuffer
+ * @param index: framebuffer index
+ * @retval framebuffer address in SDRAM
+ */
+uint32_t lcdFrameBufferGetAddress(uint32_t index) {
+	return LCD_FB_START_ADDRESS + index * LCD_FRAME_BUFFER_SPACING;
+}
+
+/**
+ * @brief Gets the index of the shown framebuffer
+ * @retval framebuffer index
+ */
+uint32_t lcdFrameBufferGetFrontIndex() {
+	return frontIndex;
+}
+
+/**
+ * @brief Gets the index of the framebuffer which is not shown (the next frame is drawn there)
+ * @retval framebuffer index
+ */
+uint32_t lcdFrameBufferGetBackIndex() {
+	return (frontIndex + 1) % LCD_FRAME_BUFFER_COUNT;
+}
+
+/**
+ * @brief Shows the drawn framebuffer at the next vertical blanking. The calling task
+ * waits until the swap is done, so it never draws in the shown framebuffer.
+ * @retval returns 1 if the framebuffers were swapped
+ */
+uint8_t lcdFrameBufferSwap() {
+	osEvent event;
+
+	swapTask = osThreadGetId();
+	pendingIndex = lcdFrameBufferGetBackIndex();
+
+	// the line interrupt is set at the first line after the active area
+	HAL_LTDC_ProgramLineEvent(&hLtdcHandler,
+			hLtdcHandler.Init.AccumulatedActiveH + 1);
+
+	event = osSignalWait(LCD_FRAME_BUFFER_SWAP_SIGNAL,
+	LCD_FRAME_BUFFER_SWAP_TIMEOUT);
+	if (event.status != osEventSignal) {
+		pendingIndex = LCD_FRAME_BUFFER_NO_SWAP;
+		return 0;
+	}
+	return 1;
+}
+
+/**
+ * @brief Fills the rectangle of the framebuffer using DMA2D register to memory mode.
+ * The function does not wait for the end of the transfer, so the CPU can prepare
+ * the next drawing while DMA2D fills the rectangle (DMA2D has to be taken by
+ * \ref lcdFrameBufferLockDma2d).
+ * @param index: framebuffer index
+ * @param x: left column
+ * @param y: top row
+ * @param width: rectangle width [pixels]
+ * @param height: rectangle height [pixels]
+ * @param color: ARGB8888 color
+ */
+void lcdFrameBufferFillRect(uint32_t index, uint32_t x, uint32_t y,
+		uint32_t width, uint32_t height, uint32_t color) {
+	if (width == 0 || height == 0)
+		return;
+
+	lcdFrameBufferWaitForDma2d();
+	DMA2D->CR = DMA2D_R2M;
+	DMA2D->OPFCCR = DMA2D_OUTPUT_ARGB8888;
+	DMA2D->OCOLR = color;
+	DMA2D->OMAR = lcdFrameBufferGetAddress(index)
+			+ (y * LCD_FRAME_BUFFER_WIDTH + x) * LCD_FRAME_BUFFER_PIXEL_SIZE;
+	DMA2D->OOR = LCD_FRAME_BUFFER_WIDTH - width;
+	DMA2D->NLR = (width << 16) | height;
+	DMA2D->CR |= DMA2D_CR_START;
+}
+
+/**
+ * @brief Copies full rows between framebuffers using DMA2D memory to memory mode
+ * (it does not wait for the end of the transfer, DMA2D has to be taken by
+ * \ref lcdFrameBufferLockDma2d)
+ * @param sourceIndex: source framebuffer index
+ * @param sourceRow: first source row
+ * @param destinationIndex: destination framebuffer index
+ * @param destinationRow: first destination row
+ * @param rows: number of rows
+ */
+void lcdFrameBufferCopyRows(uint32_t sourceIndex, uint32_t sourceRow,
+		uint32_t destinationIndex, uint32_t destinationRow, uint32_t rows) {
+	if (rows == 0)
+		return;
+
+	lcdFrameBufferWaitForDma2d();
+	DMA2D->CR = DMA2D_M2M;
+	DMA2D->FGPFCCR = DMA2D_INPUT_ARGB8888;
+	DMA2D->FGMAR = lcdFrameBufferGetAddress(sourceIndex)
+			+ sourceRow * LCD_FRAME_BUFFER_WIDTH * LCD_FRAME_BUFFER_PIXEL_SIZE;
+	DMA2D->FGOR = 0;
+	DMA2D->OPFCCR = DMA2D_OUTPUT_ARGB8888;
+	DMA2D->OMAR = lcdFrameBufferGetAddress(destinationIndex)
+			+ destinationRow * LCD_FRAME_BUFFER_WIDTH
+					* LCD_FRAME_BUFFER_PIXEL_SIZE;
+	DMA2D->OOR = 0;
+	DMA2D->NLR = (LCD_FRAME_BUFFER_WIDTH << 16) | rows;
+	DMA2D->CR |= DMA2D_CR_START;
+}
+
+/**
+ * @brief Waits for the end of the DMA2D transfer
+ */
+void lcdFrameBufferWaitForDma2d() {
+	while (DMA2D->CR & DMA2D_CR_START)
+		;
+}
+
+/**
+ * @brief Takes DMA2D for the calling task. The transfers are started without waiting,
+ * so DMA2D is taken for the whole drawing (e.g. one frame) and not for a single transfer.
+ */
+void lcdFrameBufferLockDma2d() {
+	osMutexWait(dma2dMutex_id, osWaitForever);
+}
+
+/**
+ * @brief Waits for the end of the last transfer and releases DMA2D
+ */
+void lcdFrameBufferUnlockDma2d() {
+	lcdFrameBufferWaitForDma2d();
+	osMutexRelease(dma2dMutex_id);
+}
+
+/**
+ * @brief LTDC line interrupt callback (vertical blanking). The layer address is reloaded
+ * immediately, because the next frame has not started yet.
+ * @param hltdc: pointer to \ref LTDC_HandleTypeDef
+ */
+void HAL_LTDC_LineEvenCallback(LTDC_HandleTypeDef *hltdc) {
+	uint32_t address;
+
+	if (pendingIndex == LCD_FRAME_BUFFER_NO_SWAP)
+		return;
+
+	address = lcdFrameBufferGetAddress(pendingIndex);
+	LTDC_Layer1->CFBAR = address;
+	LTDC->SRCR = LTDC_SRCR_IMR;
+
+	// the driver configuration of layer 0 follows the shown framebuffer
+	hltdc->LayerCfg[0].FBStartAdress = address;
+
+	frontIndex = pendingIndex;
+	pendingIndex = LCD_FRAME_BUFFER_NO_SWAP;
+	osSignalSet(swapTask, LCD_FRAME_BUFFER_SWAP_SIGNAL);
+}
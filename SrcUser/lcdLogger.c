@@ -14,16 +14,111 @@
 static int row = 0;
 
 /**
- * @val char* fullMsg
- * @brief Allocated memory to hold the message
+ * @val LogRecordStr logQueue[]
+ * @brief Records written by tasks and interrupts, displayed by the logger task
  */
-static char* fullMsg;
+static LogRecordStr logQueue[LOG_QUEUE_SIZE];
 
 /**
- * @val int flag
- * @brief Equals 0 if the \ref fullMsg is not allocated
+ * @val uint32_t logHead
+ * @brief Number of reserved records (the next record index is logHead modulo queue size)
  */
-static int flag = 0;
+static volatile uint32_t logHead = 0;
+
+/**
+ * @val uint32_t logTail
+ * @brief Number of records processed by \ref logProcess
+ */
+static volatile uint32_t logTail = 0;
+
+/**
+ * @val LogEntryStr logHistory[]
+ * @brief The newest processed records (written only by the logger task)
+ */
+static LogEntryStr logHistory[LOG_HISTORY_SIZE];
+
+/**
+ * @val uint32_t lastSequence
+ * @brief Sequence number of the newest record in \ref logHistory (0 if there are no records)
+ */
+static volatile uint32_t lastSequence = 0;
+
+/**
+ * @val LogStatsStr logStats
+ * @brief Counters of written and lost records
+ */
+static volatile LogStatsStr logStats;
+
+/**
+ * @val uint32_t reportedLoss
+ * @brief Number of lost records which were already reported on the LCD
+ */
+static uint32_t reportedLoss = 0;
+
+/**
+ * @val uint32_t rateWindows[]
+ * @brief Current rate limiter period of each severity
+ */
+static volatile uint32_t rateWindows[LOG_SEVERITY_COUNT];
+
+/**
+ * @val uint32_t rateCounts[]
+ * @brief Number of records of each severity in the current period
+ */
+static volatile uint32_t rateCounts[LOG_SEVERITY_COUNT];
+
+/**
+ * @val uint8_t clearRequested
+ * @brief Set by \ref logClear, the LCD is cleared by the logger task
+ */
+static volatile uint8_t clearRequested = 0;
+
+/**
+ * @brief Atomically increments the counter (safe in tasks and interrupts)
+ * @param counter: pointer to counter
+ * @retval counter value before the increment
+ */
+static uint32_t atomicIncrement(volatile uint32_t* counter) {
+	uint32_t value;
+
+	do {
+		value = __LDREXW(counter);
+	} while (__STREXW(value + 1, counter) != 0);
+	return value;
+}
+
+/**
+ * @brief Checks if the record exceeds the rate limit of its severity
+ * (races at the beginning of the period let only a few more records through)
+ * @param severity: \ref LogSeverity
+ * @retval returns 1 if the record has to be dropped
+ */
+static uint8_t isRateLimited(LogSeverity severity) {
+	uint32_t window = HAL_GetTick() / LOG_RATE_PERIOD;
+
+	if (rateWindows[severity] != window) {
+		rateWindows[severity] = window;
+		rateCounts[severity] = 0;
+	}
+	return atomicIncrement(&rateCounts[severity]) >= LOG_RATE_LIMIT;
+}
+
+/**
+ * @brief Reserves the next free record without locking
+ * @retval pointer to reserved \ref LogRecordStr (NULL if the queue is full)
+ */
+static LogRecordStr* reserveRecord() {
+	uint32_t head;
+
+	do {
+		head = __LDREXW(&logHead);
+		if (head - logTail >= LOG_QUEUE_SIZE) {
+			__CLREX();
+			return NULL;
+		}
+	} while (__STREXW(head + 1, &logHead) != 0);
+	return &logQueue[head & (LOG_QUEUE_SIZE - 1)];
+}
 
 /**
  * @brief Displays the \p msg
@@ -35,32 +130,227 @@ static void disp(char* msg, uint32_t col) {
 	BSP_LCD_DisplayStringAtLine(row++, (uint8_t*) msg);
 }
 
+/**
+ * @brief Clears the log layer (DMA2D is shared with the LCD task)
+ */
+static void clearLogLayer() {
+	lcdFrameBufferLockDma2d();
+	lcdFrameBufferFillRect(LCD_FRAME_BUFFER_OVERLAY, 0, 0,
+	LCD_FRAME_BUFFER_WIDTH, LCD_FRAME_BUFFER_HEIGHT, LOG_LAYER_BACKGROUND_COLOR);
+	lcdFrameBufferUnlockDma2d();
+}
+
 /**
  * @brief Checks if the row is too large
  */
 static void updateRow() {
 	if (row > LOG_MAX_ROWS) {
 		row = 0;
-		BSP_LCD_Clear(LOG_BACKGROUND_COLOR);
+		clearLogLayer();
 	}
 }
 
 /**
- * @brief Initializes LCD logging feature. At first initializes and clears the LCD. Then allocates memory for \ref fullMsg.
+ * @brief Displays the record in the next row
+ * @param record: pointer to \ref LogRecordStr
+ */
+static void displayRecord(LogRecordStr* record) {
+	updateRow();
+	if (record->severity <= LOG_SEVERITY_ERROR)
+		disp(record->text, LOG_ERROR_COLOR);
+	else if (record->severity == LOG_SEVERITY_WARNING)
+		disp(record->text, LOG_WARNING_COLOR);
+	else
+		disp(record->text, LOG_FONT_COLOR);
+}
+
+/**
+ * @brief Copies the record to the history (readers check the sequence number,
+ * so they never use an entry which is overwritten at the moment)
+ * @param record: pointer to \ref LogRecordStr
+ */
+static void addToHistory(LogRecordStr* record) {
+	uint32_t sequence = lastSequence + 1;
+	LogEntryStr* entry = &logHistory[sequence & (LOG_HISTORY_SIZE - 1)];
+
+	entry->sequence = 0;
+	__DMB();
+	entry->severity = record->severity;
+	entry->timestamp = record->timestamp;
+	memcpy(entry->text, record->text, LOG_MAX_MESSAGE_LENGTH);
+	__DMB();
+	entry->sequence = sequence;
+	lastSequence = sequence;
+}
+
+/**
+ * @brief Initializes LCD logging feature. Initializes and clears the LCD
+ * (records written before are displayed by the logger task). The log text is drawn
+ * in layer 1 over the flipped spectrum framebuffers of layer 0, so it is never hidden
+ * by the swap and it does not change the pixels which the spectrum printers redraw.
  */
 void lcdInit() {
+	uint32_t buffer;
+
 	BSP_LCD_Init();
-	BSP_LCD_LayerDefaultInit(0, LCD_FB_START_ADDRESS);
-	BSP_LCD_SelectLayer(0);
+	BSP_LCD_LayerDefaultInit(0, lcdFrameBufferGetAddress(0));
+	BSP_LCD_LayerDefaultInit(1,
+			lcdFrameBufferGetAddress(LCD_FRAME_BUFFER_OVERLAY));
+	lcdFrameBufferInit();
+
+	lcdFrameBufferLockDma2d();
+	for (buffer = 0; buffer < LCD_FRAME_BUFFER_COUNT; buffer++)
+		lcdFrameBufferFillRect(buffer, 0, 0, LCD_FRAME_BUFFER_WIDTH,
+		LCD_FRAME_BUFFER_HEIGHT, LOG_BACKGROUND_COLOR);
+	lcdFrameBufferUnlockDma2d();
+	clearLogLayer();
+
+	BSP_LCD_SelectLayer(1);
 	BSP_LCD_DisplayOn();
-	BSP_LCD_Clear(LOG_BACKGROUND_COLOR);
 	BSP_LCD_SetTextColor(LOG_FONT_COLOR);
+	BSP_LCD_SetBackColor(LOG_LAYER_BACKGROUND_COLOR);
 	BSP_LCD_SetFont(LOG_FONT);
 
 	row = 0;
-	if (flag == 0) {
-		fullMsg = malloc(LOG_MAX_MESSAGE_LENGTH);
-		flag = 1;
+}
+
+/**
+ * @brief Formats the record and puts it to the log queue. It does not wait and does not draw,
+ * so it can be called from any task or interrupt (the record is dropped if the queue is full).
+ * @param severity: \ref LogSeverity
+ * @param format: printf format
+ */
+void logWrite(LogSeverity severity, const char* format, ...) {
+	LogRecordStr* record;
+	va_list arguments;
+
+	if (severity > LOG_LEVEL) {
+		atomicIncrement(&logStats.filtered);
+		return;
+	}
+	if (isRateLimited(severity)) {
+		atomicIncrement(&logStats.rateLimited);
+		return;
+	}
+
+	record = reserveRecord();
+	if (record == NULL) {
+		atomicIncrement(&logStats.dropped);
+		return;
+	}
+
+	record->severity = severity;
+	record->timestamp = timeBaseGetCycles();
+	va_start(arguments, format);
+	vsnprintf(record->text, LOG_MAX_MESSAGE_LENGTH, format, arguments);
+	va_end(arguments);
+
+	// the logger task may read the record after the ready flag is set
+	__DMB();
+	record->ready = 1;
+	atomicIncrement(&logStats.written);
+}
+
+/**
+ * @brief Displays the queued records on the LCD (called only by the logger task).
+ * The number of lost records is displayed if some records were dropped.
+ */
+void logProcess() {
+	LogRecordStr* record;
+	uint32_t lost;
+	char msg[LOG_MAX_MESSAGE_LENGTH];
+
+	if (clearRequested) {
+		clearRequested = 0;
+		row = 0;
+		clearLogLayer();
+	}
+
+	// the records are processed in order of reservation (a record which is still written stops the loop)
+	for (;;) {
+		record = &logQueue[logTail & (LOG_QUEUE_SIZE - 1)];
+		if (!record->ready)
+			break;
+		__DMB();
+		addToHistory(record);
+		displayRecord(record);
+
+		record->ready = 0;
+		__DMB();
+		logTail++;
+	}
+
+	lost = logStats.dropped + logStats.rateLimited;
+	if (lost != reportedLoss) {
+		sprintf(msg, "Log lost %lu", lost - reportedLoss);
+		reportedLoss = lost;
+		updateRow();
+		disp(msg, LOG_ERROR_COLOR);
+	}
+}
+
+/**
+ * @brief Copies the counters of the log queue
+ * @param stats: output \ref LogStatsStr structure
+ */
+void logGetStats(LogStatsStr* stats) {
+	*stats = *(LogStatsStr*) &logStats;
+}
+
+/**
+ * @brief Gets the sequence number of the oldest record kept in the history
+ * @retval sequence number (greater than \ref logGetLastSequence if there are no records)
+ */
+uint32_t logGetFirstSequence() {
+	uint32_t last = lastSequence;
+
+	return last >= LOG_HISTORY_SIZE ? last - LOG_HISTORY_SIZE + 1 : 1;
+}
+
+/**
+ * @brief Gets the sequence number of the newest record kept in the history
+ * @retval sequence number (0 if there are no records)
+ */
+uint32_t logGetLastSequence() {
+	return lastSequence;
+}
+
+/**
+ * @brief Copies the record from the history (it can be called by any task)
+ * @param sequence: sequence number of the record
+ * @param entry: output \ref LogEntryStr
+ * @retval returns 1 if the record was copied (0 if it was overwritten or not written yet)
+ */
+uint8_t logGetEntry(uint32_t sequence, LogEntryStr* entry) {
+	LogEntryStr* source = &logHistory[sequence & (LOG_HISTORY_SIZE - 1)];
+
+	if (sequence == 0 || source->sequence != sequence)
+		return 0;
+	__DMB();
+	memcpy(entry, source, sizeof(LogEntryStr));
+	__DMB();
+
+	// the entry could be overwritten by the logger task during copying
+	return source->sequence == sequence;
+}
+
+/**
+ * @brief Gets the name of the severity (used in GET /log)
+ * @param severity: \ref LogSeverity
+ * @retval severity name
+ */
+const char* logGetSeverityName(uint32_t severity) {
+	switch (severity) {
+	case LOG_SEVERITY_ERROR:
+		return "ERROR";
+	case LOG_SEVERITY_WARNING:
+		return "WARNING";
+	case LOG_SEVERITY_INFO:
+		return "INFO";
+	case LOG_SEVERITY_DEBUG:
+		return "DEBUG";
+	default:
+		return "UNKNOWN";
 	}
 }
 
@@ -69,8 +359,15 @@ void lcdInit() {
  * @param msg: log message
  */
 void logMsg(char* msg) {
-	updateRow();
-	disp(msg, LOG_FONT_COLOR);
+	logWrite(LOG_SEVERITY_INFO, "%s", msg);
+}
+
+/**
+ * @brief The function displays warning \p msg on the LCD in the next row.
+ * @param msg: log message
+ */
+void logWarn(char* msg) {
+	logWrite(LOG_SEVERITY_WARNING, "%s", msg);
 }
 
 /**
@@ -78,8 +375,7 @@ void logMsg(char* msg) {
  * @param msg: log message
  */
 void logErr(char* msg) {
-	updateRow();
-	disp(msg, LCD_COLOR_RED);
+	logWrite(LOG_SEVERITY_ERROR, "%s", msg);
 }
 
 /**
@@ -88,9 +384,7 @@ void logErr(char* msg) {
  * @param val: value to concatenate
  */
 void logMsgVal(char* msg, int val) {
-	updateRow();
-	sprintf(fullMsg, "%s%d", msg, val);
-	disp(fullMsg, LOG_FONT_COLOR);
+	logWrite(LOG_SEVERITY_INFO, "%s%d", msg, val);
 }
 
 /**
@@ -99,9 +393,7 @@ void logMsgVal(char* msg, int val) {
  * @param val: value to concatenate
  */
 void logErrVal(char* msg, int val) {
-	updateRow();
-	sprintf(fullMsg, "%s%d", msg, val);
-	disp(fullMsg, LCD_COLOR_RED);
+	logWrite(LOG_SEVERITY_ERROR, "%s%d", msg, val);
 }
 
 /**
@@ -110,8 +402,7 @@ void logErrVal(char* msg, int val) {
  * @param val: value to concatenate
  */
 void logMsgValFt(char* msg, float val) {
-	sprintf(fullMsg, "%s%5.2f", msg, val);
-	disp(fullMsg, LOG_FONT_COLOR);
+	logWrite(LOG_SEVERITY_INFO, "%s%5.2f", msg, val);
 }
 
 /**
@@ -120,14 +411,12 @@ void logMsgValFt(char* msg, float val) {
  * @param val: value to concatenate
  */
 void logErrValFt(char* msg, float val) {
-	sprintf(fullMsg, "%s%5.2f", msg, val);
-	disp(fullMsg, LCD_COLOR_RED);
+	logWrite(LOG_SEVERITY_ERROR, "%s%5.2f", msg, val);
 }
 
 /**
- * @brief The functions clears the LCD and resets \ref row
+ * @brief The functions clears the LCD and resets \ref row (done by the logger task)
  */
 void logClear() {
-	row = 0;
-	BSP_LCD_Clear(LOG_BACKGROUND_COLOR);
+	clearRequested = 1;
 }
@@ -0,0 +1,148 @@
+/*
+ * lcdWaterfallPrinter.c
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#include "lcdWaterfallPrinter.h"
+
+/**
+ * @var uint32_t colorLut[]
+ * @brief ARGB8888 colors of levels from -\ref LCD_WATERFALL_RANGE_DB (index 0) to 0 dB (last index)
+ */
+static uint32_t colorLut[LCD_WATERFALL_LUT_SIZE];
+
+/**
+ * @var uint32_t lutColors[]
+ * @brief Colors interpolated in \ref colorLut (black, blue, cyan, yellow, red, white)
+ */
+static const uint32_t lutColors[] = { 0x000000, 0x0000FF, 0x00FFFF, 0xFFFF00,
+		0xFF0000, 0xFFFFFF };
+
+/**
+ * @var float32_t columns[]
+ * @brief Spectrum bins copied from the snapshot (one bin per LCD column)
+ */
+static float32_t columns[LCD_FRAME_BUFFER_WIDTH];
+
+/**
+ * @var float32_t maxLevel
+ * @brief The highest level shown so far [dB] (the last color of \ref colorLut)
+ */
+static float32_t maxLevel = 0;
+
+/**
+ * @var uint32_t lastFrameNumber
+ * @brief Number of the last drawn spectrum
+ */
+static uint32_t lastFrameNumber = 0;
+
+/**
+ * @brief Interpolates one color component
+ * @param from: first color
+ * @param to: second color
+ * @param shift: position of the component in the color
+ * @param step: interpolation step
+ * @param steps: number of steps between colors
+ * @retval component value moved to its position
+ */
+static uint32_t mixComponent(uint32_t from, uint32_t to, uint32_t shift,
+		uint32_t step, uint32_t steps) {
+	int32_t first = (from >> shift) & 0xFF;
+	int32_t second = (to >> shift) & 0xFF;
+
+	return (uint32_t) (first + (second - first) * (int32_t) step / (int32_t) steps)
+			<< shift;
+}
+
+/**
+ * @brief Fills \ref colorLut with colors interpolated between \ref lutColors
+ */
+static void buildColorLut() {
+	uint32_t segments = sizeof(lutColors) / sizeof(lutColors[0]) - 1;
+	uint32_t segment;
+	uint32_t step;
+	uint32_t i;
+
+	for (i = 0; i < LCD_WATERFALL_LUT_SIZE; i++) {
+		segment = i * segments / LCD_WATERFALL_LUT_SIZE;
+		step = i * segments - segment * LCD_WATERFALL_LUT_SIZE;
+		colorLut[i] = 0xFF000000
+				| mixComponent(lutColors[segment], lutColors[segment + 1], 16,
+						step, LCD_WATERFALL_LUT_SIZE)
+				| mixComponent(lutColors[segment], lutColors[segment + 1], 8,
+						step, LCD_WATERFALL_LUT_SIZE)
+				| mixComponent(lutColors[segment], lutColors[segment + 1], 0,
+						step, LCD_WATERFALL_LUT_SIZE);
+	}
+}
+
+/**
+ * @brief Prepares the color table and clears the framebuffers
+ */
+void lcdWaterfallInit() {
+	uint32_t buffer;
+
+	buildColorLut();
+	for (buffer = 0; buffer < LCD_FRAME_BUFFER_COUNT; buffer++)
+		lcdFrameBufferFillRect(buffer, 0, 0, LCD_FRAME_BUFFER_WIDTH,
+		LCD_FRAME_BUFFER_HEIGHT, LCD_WATERFALL_BACKGROUND_COLOR);
+	lcdFrameBufferWaitForDma2d();
+
+	lastFrameNumber = 0;
+	maxLevel = 0;
+}
+
+/**
+ * @brief The function adds the last published spectrum as the top row of the waterfall.
+ * The older rows are moved down from the shown framebuffer by DMA2D while the new row
+ * is colored by the CPU.
+ * @param snapshot: pointer to \ref SpectrumSnapshotStr structure
+ * @param bufferIndex: index of the framebuffer which is not shown
+ * @retval returns 1 if the new spectrum was printed
+ */
+uint8_t lcdWaterfallPrint(SpectrumSnapshotStr* snapshot, uint32_t bufferIndex) {
+	SpectrumSnapshotInfoStr info;
+	uint32_t* row;
+	float32_t newMaxLevel;
+	float32_t scale;
+	int32_t index;
+	uint32_t maxIndex;
+	uint32_t i;
+
+	if (!spectrumSnapshotRead(snapshot, columns, 0, LCD_FRAME_BUFFER_WIDTH, 1,
+			&info) || info.count < 2 || info.frameNumber == lastFrameNumber)
+		return 0;
+	lastFrameNumber = info.frameNumber;
+	// the bins in dB scale are mapped to the colors without conversion
+	soundProcessingToDb(columns, info.count, info.scale);
+
+	// history is scrolled by one row
+	lcdFrameBufferCopyRows(lcdFrameBufferGetFrontIndex(), 0, bufferIndex, 1,
+	LCD_FRAME_BUFFER_HEIGHT - 1);
+
+	// the constant component is not used for scaling
+	arm_max_f32(&columns[1], info.count - 1, &newMaxLevel, &maxIndex);
+	if (newMaxLevel > maxLevel)
+		maxLevel = newMaxLevel;
+	scale = (LCD_WATERFALL_LUT_SIZE - 1) / LCD_WATERFALL_RANGE_DB;
+
+	row = (uint32_t*) lcdFrameBufferGetAddress(bufferIndex);
+	for (i = 0; i < LCD_FRAME_BUFFER_WIDTH; i++) {
+		if (i >= info.count) {
+			row[i] = LCD_WATERFALL_BACKGROUND_COLOR;
+			continue;
+		}
+
+		index = LCD_WATERFALL_LUT_SIZE - 1
+				+ (int32_t) ((columns[i] - maxLevel) * scale);
+		if (index < 0)
+			index = 0;
+		else if (index >= LCD_WATERFALL_LUT_SIZE)
+			index = LCD_WATERFALL_LUT_SIZE - 1;
+		row[i] = colorLut[index];
+	}
+
+	lcdFrameBufferWaitForDma2d();
+	return 1;
+}
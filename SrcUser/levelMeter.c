@@ -0,0 +1,192 @@
+/*
+ * levelMeter.c
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#include "levelMeter.h"
+
+/**
+ * @var LevelMeterStr levelMeter
+ * @brief Level meter of the recorded signal (updated with every DMA buffer)
+ */
+static LevelMeterStr levelMeter;
+
+/**
+ * @brief Starts the new Leq integration period (the last completed Leq is kept)
+ */
+static void restartLeq() {
+	levelMeter.leqTarget = (uint64_t) levelMeter.leqPeriod
+			* levelMeter.frequency / 1000;
+	levelMeter.leqEnergy = 0;
+	levelMeter.leqSamples = 0;
+}
+
+/**
+ * @brief Calculates the factors of the exponential integration for one block
+ * (it is done again only if the sampling frequency or block size was changed)
+ * @param count: number of samples in the block
+ * @param frequency: sampling frequency
+ */
+static void updateFactors(uint32_t count, uint32_t frequency) {
+	float32_t blockTime = (float32_t) count / frequency;
+
+	levelMeter.fastFactor = 1.0f - expf(-blockTime / LEVEL_METER_FAST_TIME);
+	levelMeter.slowFactor = 1.0f - expf(-blockTime / LEVEL_METER_SLOW_TIME);
+	levelMeter.blockSize = count;
+	if (levelMeter.frequency != frequency) {
+		levelMeter.frequency = frequency;
+		levelMeter.holdSamples = 0;
+		restartLeq();
+	}
+}
+
+/**
+ * @brief Converts the power relative to full scale to dB
+ * @param power: power relative to full scale
+ * @retval level [dBFS]
+ */
+static float32_t toLevel(float32_t power) {
+	if (power <= 0.0f)
+		return LEVEL_METER_MIN_LEVEL;
+	return 10.0f * log10f(power);
+}
+
+/**
+ * @brief Initializes the level meter (called before the sampling task starts)
+ * @param leqPeriod: Leq integration period [ms]
+ */
+void levelMeterInit(uint32_t leqPeriod) {
+	memset(&levelMeter, 0, sizeof(LevelMeterStr));
+	levelMeter.leqPeriod = leqPeriod;
+}
+
+/**
+ * @brief Changes the Leq integration period and starts the new period (called only
+ * by the sampling task)
+ * @param leqPeriod: Leq integration period [ms]
+ */
+void levelMeterSetLeqPeriod(uint32_t leqPeriod) {
+	if (leqPeriod == levelMeter.leqPeriod)
+		return;
+
+	levelMeter.sequence++;
+	__DMB();
+	levelMeter.leqPeriod = leqPeriod;
+	restartLeq();
+	__DMB();
+	levelMeter.sequence++;
+}
+
+/**
+ * @brief Updates the levels with the block of samples (called by the sampling task for every
+ * DMA buffer, the cost depends only on the block size). Leq periods end at the block
+ * boundary, the energy is divided by the number of integrated samples.
+ * @param samples: 16-bit signed samples
+ * @param count: number of samples
+ * @param frequency: sampling frequency of the samples
+ */
+void levelMeterProcess(const uint16_t* samples, uint32_t count,
+		uint32_t frequency) {
+	q63_t energy;
+	q15_t maximum;
+	q15_t minimum;
+	uint32_t index;
+	float32_t peak;
+
+	if (count == 0 || frequency == 0)
+		return;
+
+	arm_power_q15((q15_t*) samples, count, &energy);
+	arm_max_q15((q15_t*) samples, count, &maximum, &index);
+	arm_min_q15((q15_t*) samples, count, &minimum, &index);
+	peak = (maximum > -(int32_t) minimum ? maximum : -(int32_t) minimum)
+			/ 32768.0f;
+
+	levelMeter.sequence++;
+	__DMB();
+
+	if (frequency != levelMeter.frequency || count != levelMeter.blockSize)
+		updateFactors(count, frequency);
+
+	levelMeter.blockPower = (float32_t) energy
+			/ (LEVEL_METER_FULL_SCALE_POWER * count);
+	levelMeter.blockPeak = peak;
+	levelMeter.fastPower += (levelMeter.blockPower - levelMeter.fastPower)
+			* levelMeter.fastFactor;
+	levelMeter.slowPower += (levelMeter.blockPower - levelMeter.slowPower)
+			* levelMeter.slowFactor;
+
+	// the peak is held until it expires or a higher one comes
+	if (peak >= levelMeter.holdPeak || levelMeter.holdSamples <= count) {
+		levelMeter.holdPeak = peak;
+		levelMeter.holdSamples = LEVEL_METER_PEAK_HOLD_TIME * frequency / 1000;
+	} else
+		levelMeter.holdSamples -= count;
+
+	levelMeter.leqEnergy += energy;
+	levelMeter.leqSamples += count;
+	if (levelMeter.leqSamples >= levelMeter.leqTarget) {
+		levelMeter.leqPower = (float32_t) levelMeter.leqEnergy
+				/ (LEVEL_METER_FULL_SCALE_POWER * levelMeter.leqSamples);
+		levelMeter.leqWindows++;
+		levelMeter.leqEnergy = 0;
+		levelMeter.leqSamples = 0;
+	}
+
+	levelMeter.blocks++;
+	if (maximum == INT16_MAX || minimum == INT16_MIN)
+		levelMeter.clippedBlocks++;
+
+	__DMB();
+	levelMeter.sequence++;
+}
+
+/**
+ * @brief Copies the levels without locking (the sampling task is never blocked by readers)
+ * @param reading: output \ref LevelMeterReadingStr
+ * @retval returns 1 if a consistent copy was made
+ */
+uint8_t levelMeterRead(LevelMeterReadingStr* reading) {
+	LevelMeterStr meter;
+	uint32_t retries;
+	uint32_t sequence;
+
+	for (retries = 0; retries < LEVEL_METER_MAX_RETRIES; retries++) {
+		sequence = levelMeter.sequence;
+		if (sequence & 1) {
+			// the sampling task was preempted during the update
+			osThreadYield();
+			continue;
+		}
+		__DMB();
+
+		meter = levelMeter;
+
+		__DMB();
+		if (levelMeter.sequence == sequence)
+			break;
+		osThreadYield();
+	}
+	if (retries == LEVEL_METER_MAX_RETRIES)
+		return 0;
+
+	reading->rms = toLevel(meter.blockPower);
+	reading->peak = toLevel(meter.blockPeak * meter.blockPeak);
+	reading->peakHold = toLevel(meter.holdPeak * meter.holdPeak);
+	reading->fast = toLevel(meter.fastPower);
+	reading->slow = toLevel(meter.slowPower);
+	reading->leq = toLevel(meter.leqPower);
+	reading->leqCurrent =
+			meter.leqSamples > 0 ?
+					toLevel(
+							(float32_t) meter.leqEnergy
+									/ (LEVEL_METER_FULL_SCALE_POWER
+											* meter.leqSamples)) :
+					LEVEL_METER_MIN_LEVEL;
+	reading->leqPeriod = meter.leqPeriod;
+	reading->leqWindows = meter.leqWindows;
+	reading->blocks = meter.blocks;
+	reading->clippedBlocks = meter.clippedBlocks;
+	return 1;
+}
@@ -0,0 +1,134 @@
+/*
+ * mfccAnalysis.c
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#include "mfccAnalysis.h"
+
+/**
+ * @var MfccTableStr mfccTable
+ * @brief Filterbank of the current spectrum size (rebuilt when the sampling frequency changes,
+ * used only by the sound processing task)
+ */
+static MfccTableStr mfccTable;
+
+/**
+ * @var float32_t highFrequency
+ * @brief Upper edge of the last filter of \ref mfccTable [Hz]
+ */
+static float32_t highFrequency;
+
+/**
+ * @brief Converts the frequency to the mel scale
+ * @param frequency: frequency [Hz]
+ * @retval mel value
+ */
+static float32_t toMel(float32_t frequency) {
+	return 2595.0f * log10f(1.0f + frequency / 700.0f);
+}
+
+/**
+ * @brief Converts the mel value to the frequency
+ * @param mel: mel value
+ * @retval frequency [Hz]
+ */
+static float32_t fromMel(float32_t mel) {
+	return 700.0f * (powf(10.0f, mel / 2595.0f) - 1.0f);
+}
+
+/**
+ * @brief Prepares the filterbank and DCT-II matrix (orthonormal, as used by common
+ * MFCC implementations)
+ * @param size: number of bins (up to the sampling frequency)
+ * @param frequencyResolution: frequency resolution [Hz]
+ */
+static void buildTable(uint32_t size, float32_t frequencyResolution) {
+	float32_t centers[MFCC_FILTER_COUNT + 2];
+	float32_t lowMel;
+	float32_t highMel;
+	float32_t scale;
+	uint32_t point;
+	uint32_t bin;
+	uint32_t k;
+	uint32_t j;
+
+	mfccTable.vectorSize = size;
+	mfccTable.frequencyResolution = frequencyResolution;
+
+	highFrequency = frequencyResolution * (size / 2);
+	if (highFrequency > MFCC_MAX_FREQUENCY)
+		highFrequency = MFCC_MAX_FREQUENCY;
+	lowMel = toMel(MFCC_MIN_FREQUENCY);
+	highMel = toMel(highFrequency);
+
+	// filter edges and centers equally spaced on the mel scale [bins]
+	for (point = 0; point < MFCC_FILTER_COUNT + 2; point++) {
+		centers[point] = fromMel(
+				lowMel
+						+ (highMel - lowMel) * point
+								/ (MFCC_FILTER_COUNT + 1))
+				/ frequencyResolution;
+		mfccTable.segmentStart[point] = (uint32_t) ceilf(centers[point]);
+	}
+	if (mfccTable.segmentStart[0] == 0)
+		mfccTable.segmentStart[0] = 1;
+
+	for (point = 0; point < MFCC_FILTER_COUNT + 1; point++) {
+		for (bin = mfccTable.segmentStart[point];
+				bin < mfccTable.segmentStart[point + 1]; bin++)
+			mfccTable.weights[bin] = (bin - centers[point])
+					/ (centers[point + 1] - centers[point]);
+	}
+
+	for (k = 0; k < MFCC_COEFFICIENT_COUNT; k++) {
+		scale = sqrtf((k == 0 ? 1.0f : 2.0f) / MFCC_FILTER_COUNT);
+		for (j = 0; j < MFCC_FILTER_COUNT; j++)
+			mfccTable.dct[k][j] = scale
+					* cosf(PI * k * (j + 0.5f) / MFCC_FILTER_COUNT);
+	}
+}
+
+/**
+ * @brief Computes mel filterbank energies, their natural log and MFCCs of the spectrum.
+ * The filterbank is prepared again only if the spectrum size or resolution was changed.
+ * @param power: power spectrum (squared magnitudes of bins up to the sampling frequency)
+ * @param size: number of bins
+ * @param frequencyResolution: frequency resolution [Hz]
+ * @param features: output \ref MfccFeaturesStr
+ */
+void mfccAnalysisProcess(const float32_t* power, uint32_t size,
+		float32_t frequencyResolution, MfccFeaturesStr* features) {
+	float32_t energies[MFCC_FILTER_COUNT];
+	float32_t rising;
+	uint32_t segment;
+	uint32_t bin;
+	uint32_t k;
+
+	if (mfccTable.vectorSize != size
+			|| mfccTable.frequencyResolution != frequencyResolution)
+		buildTable(size, frequencyResolution);
+
+	memset(energies, 0, sizeof(energies));
+	for (segment = 0; segment < MFCC_FILTER_COUNT + 1; segment++) {
+		for (bin = mfccTable.segmentStart[segment];
+				bin < mfccTable.segmentStart[segment + 1]; bin++) {
+			rising = mfccTable.weights[bin] * power[bin];
+			if (segment < MFCC_FILTER_COUNT)
+				energies[segment] += rising;
+			if (segment > 0)
+				energies[segment - 1] += power[bin] - rising;
+		}
+	}
+
+	for (k = 0; k < MFCC_FILTER_COUNT; k++)
+		features->logEnergies[k] = logf(
+				energies[k] > MFCC_LOG_FLOOR ? energies[k] : MFCC_LOG_FLOOR);
+
+	for (k = 0; k < MFCC_COEFFICIENT_COUNT; k++)
+		arm_dot_prod_f32(mfccTable.dct[k], features->logEnergies,
+				MFCC_FILTER_COUNT, &features->coefficients[k]);
+
+	features->lowFrequency = MFCC_MIN_FREQUENCY;
+	features->highFrequency = highFrequency;
+}
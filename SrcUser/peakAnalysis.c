@@ -0,0 +1,302 @@
+/*
+ * peakAnalysis.c
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#include "peakAnalysis.h"
+
+/**
+ * @brief Gets the half width of the window main lobe (the bins of the lobe are not searched
+ * for other peaks)
+ * @param windowType: \ref WindowType used before FFT
+ * @retval half width of the main lobe [bins]
+ */
+static uint32_t getLobeWidth(WindowType windowType) {
+	switch (windowType) {
+	case HANN:
+		return 2;
+	case FLAT_TOP:
+		return 5;
+	default:
+		return 1;
+	}
+}
+
+/**
+ * @brief Gets the half width of the range which holds the power of a tone. It is wider than
+ * the main lobe because the first side lobes hold a noticeable part of the power
+ * (the rectangular window leaks too much for accurate SNR of tones between bins).
+ * @param windowType: \ref WindowType used before FFT
+ * @retval half width of the range [bins]
+ */
+static uint32_t getPowerWidth(WindowType windowType) {
+	switch (windowType) {
+	case HANN:
+		return 4;
+	case FLAT_TOP:
+		return 6;
+	default:
+		return 3;
+	}
+}
+
+/**
+ * @brief Finds the maximum of the range without the lobes of already found peaks
+ * (every free part of the range is searched by arm_max_f32)
+ * @param power: power spectrum (squared magnitudes)
+ * @param from: first bin
+ * @param to: last bin (exclusive)
+ * @param excluded: sorted bins of found peaks
+ * @param excludedCount: number of found peaks
+ * @param width: half width of excluded lobes [bins]
+ * @param index: output bin index of the maximum
+ * @retval maximum value (negative if all bins are excluded)
+ */
+static float32_t findMaximum(const float32_t* power, uint32_t from,
+		uint32_t to, const uint32_t* excluded, uint32_t excludedCount,
+		uint32_t width, uint32_t* index) {
+	float32_t best = -1.0f;
+	float32_t value;
+	uint32_t valueIndex;
+	uint32_t start = from;
+	uint32_t end;
+	uint32_t i;
+
+	for (i = 0; i <= excludedCount; i++) {
+		if (i < excludedCount)
+			end = excluded[i] > width ? excluded[i] - width : 0;
+		else
+			end = to;
+		if (end > to)
+			end = to;
+
+		if (end > start) {
+			arm_max_f32((float32_t*) &power[start], end - start, &value,
+					&valueIndex);
+			if (value > best) {
+				best = value;
+				*index = start + valueIndex;
+			}
+		}
+
+		if (i < excludedCount && excluded[i] + width + 1 > start)
+			start = excluded[i] + width + 1;
+	}
+	return best;
+}
+
+/**
+ * @brief Adds the bin to the sorted array
+ * @param excluded: sorted bins
+ * @param count: number of bins
+ * @param bin: added bin
+ */
+static void insertSorted(uint32_t* excluded, uint32_t count, uint32_t bin) {
+	while (count > 0 && excluded[count - 1] > bin) {
+		excluded[count] = excluded[count - 1];
+		count--;
+	}
+	excluded[count] = bin;
+}
+
+/**
+ * @brief Refines the frequency and amplitude of the peak from three bins. The rectangular lobe
+ * is refined by the ratio of the bins (exact for the sinc lobe), Hann lobe by parabola fitted
+ * to logarithms of magnitudes (Gaussian interpolation) and flat top lobe by parabola
+ * (its amplitude error is small, the frequency error is up to 0.14 bin).
+ * @param power: power spectrum (squared magnitudes)
+ * @param index: bin of the maximum (it has two neighbours)
+ * @param frequencyResolution: frequency resolution [Hz]
+ * @param windowType: \ref WindowType used before FFT
+ * @param peak: output \ref PeakStr
+ */
+static void refinePeak(const float32_t* power, uint32_t index,
+		float32_t frequencyResolution, WindowType windowType, PeakStr* peak) {
+	float32_t left = sqrtf(power[index - 1]);
+	float32_t center = sqrtf(power[index]);
+	float32_t right = sqrtf(power[index + 1]);
+	uint8_t gaussian = windowType == HANN && left > 0.0f && right > 0.0f;
+	float32_t denominator;
+	float32_t delta = 0.0f;
+
+	if (windowType != HANN && windowType != FLAT_TOP) {
+		// the bigger neighbour is on the side of the real frequency
+		if (right > left)
+			delta = right / (center + right);
+		else
+			delta = -left / (left + center);
+		peak->frequency = ((float32_t) index + delta) * frequencyResolution;
+		if (fabsf(delta) > PEAK_ANALYSIS_MIN_DELTA)
+			center *= PI * delta / sinf(PI * delta);
+		peak->amplitude = center;
+		return;
+	}
+
+	if (gaussian) {
+		left = logf(left);
+		center = logf(center);
+		right = logf(right);
+	}
+
+	denominator = left - 2.0f * center + right;
+	if (denominator < 0.0f) {
+		delta = 0.5f * (left - right) / denominator;
+		if (delta > 0.5f)
+			delta = 0.5f;
+		else if (delta < -0.5f)
+			delta = -0.5f;
+	}
+
+	center -= 0.25f * (left - right) * delta;
+	peak->frequency = ((float32_t) index + delta) * frequencyResolution;
+	peak->amplitude = gaussian ? expf(center) : center;
+}
+
+/**
+ * @brief Checks if the bin is a local maximum which can be interpolated
+ * @param power: power spectrum (squared magnitudes)
+ * @param index: bin index
+ * @param size: number of bins
+ * @retval returns 1 if the bin is not smaller than its neighbours
+ */
+static uint8_t isLocalMaximum(const float32_t* power, uint32_t index,
+		uint32_t size) {
+	return index > 0 && index + 1 < size
+			&& power[index] >= power[index - 1]
+			&& power[index] >= power[index + 1];
+}
+
+/**
+ * @brief Computes the power of the lobe around the bin
+ * @param power: power spectrum (squared magnitudes)
+ * @param index: center bin
+ * @param width: half width of the lobe [bins]
+ * @param from: first bin of the analysed range
+ * @param to: last bin of the analysed range (exclusive)
+ * @retval sum of squared magnitudes
+ */
+static float32_t getLobePower(const float32_t* power, uint32_t index,
+		uint32_t width, uint32_t from, uint32_t to) {
+	uint32_t first = index > from + width ? index - width : from;
+	uint32_t last = index + width + 1 < to ? index + width + 1 : to;
+	float32_t mean = 0.0f;
+
+	if (last > first)
+		arm_mean_f32((float32_t*) &power[first], last - first, &mean);
+	return mean * (last - first);
+}
+
+/**
+ * @brief Converts the power ratio to dB
+ * @param signal: signal power
+ * @param noise: noise power
+ * @retval ratio [dB]
+ */
+static float32_t toDecibels(float32_t signal, float32_t noise) {
+	if (noise < PEAK_ANALYSIS_MIN_POWER)
+		noise = PEAK_ANALYSIS_MIN_POWER;
+	if (signal < PEAK_ANALYSIS_MIN_POWER)
+		signal = PEAK_ANALYSIS_MIN_POWER;
+	return 10.0f * log10f(signal / noise);
+}
+
+/**
+ * @brief Finds the strongest peaks of the spectrum and the harmonics of the strongest one,
+ * then calculates THD, SNR and SINAD. The DC lobe and bins above Nyquist frequency are skipped.
+ * @param power: power spectrum (squared magnitudes of bins up to the sampling frequency)
+ * @param size: number of bins
+ * @param frequencyResolution: frequency resolution [Hz]
+ * @param windowType: \ref WindowType used before FFT
+ * @param analysis: output \ref PeakAnalysisStr
+ */
+void peakAnalysisProcess(const float32_t* power, uint32_t size,
+		float32_t frequencyResolution, WindowType windowType,
+		PeakAnalysisStr* analysis) {
+	uint32_t excluded[2 * PEAK_ANALYSIS_MAX_PEAKS];
+	uint32_t excludedCount = 0;
+	uint32_t width = getLobeWidth(windowType);
+	uint32_t powerWidth = getPowerWidth(windowType);
+	uint32_t from = powerWidth + 1;
+	uint32_t to = size / 2;
+	uint32_t fundamentalIndex = 0;
+	uint32_t index;
+	uint32_t harmonic;
+	uint32_t first;
+	float32_t fundamentalBin;
+	float32_t value;
+	float32_t totalPower;
+	float32_t fundamentalPower;
+	float32_t harmonicPower = 0.0f;
+
+	analysis->peakCount = 0;
+	analysis->harmonicCount = 0;
+	analysis->thd = 0.0f;
+	analysis->snr = 0.0f;
+	analysis->sinad = 0.0f;
+	if (to <= from + 1)
+		return;
+
+	// peaks are found from the strongest one, their lobes are skipped in the next searches
+	while (excludedCount < 2 * PEAK_ANALYSIS_MAX_PEAKS
+			&& analysis->peakCount < PEAK_ANALYSIS_MAX_PEAKS) {
+		value = findMaximum(power, from, to, excluded, excludedCount,
+				width, &index);
+		if (value <= 0.0f)
+			break;
+		insertSorted(excluded, excludedCount++, index);
+
+		// the maximum on the slope of the skipped lobe is not a peak
+		if (!isLocalMaximum(power, index, size))
+			continue;
+		if (analysis->peakCount == 0)
+			fundamentalIndex = index;
+		refinePeak(power, index, frequencyResolution, windowType,
+				&analysis->peaks[analysis->peakCount++]);
+	}
+	if (analysis->peakCount == 0)
+		return;
+
+	// harmonics are searched around multiples of the refined fundamental frequency
+	analysis->harmonics[0] = analysis->peaks[0];
+	analysis->harmonicCount = 1;
+	fundamentalBin = analysis->peaks[0].frequency / frequencyResolution;
+	fundamentalPower = getLobePower(power, fundamentalIndex, powerWidth,
+			from, to);
+
+	// lobes of harmonics would overlap
+	if (fundamentalBin >= 2 * powerWidth + 1) {
+		for (harmonic = 2; harmonic <= PEAK_ANALYSIS_MAX_HARMONICS; harmonic++) {
+			index = (uint32_t) (harmonic * fundamentalBin + 0.5f);
+			if (index + powerWidth + 1 >= to)
+				break;
+
+			first = index - width;
+			arm_max_f32((float32_t*) &power[first], 2 * width + 1, &value,
+					&index);
+			index += first;
+
+			if (isLocalMaximum(power, index, size))
+				refinePeak(power, index, frequencyResolution, windowType,
+						&analysis->harmonics[analysis->harmonicCount]);
+			else {
+				analysis->harmonics[analysis->harmonicCount].frequency =
+						(float32_t) index * frequencyResolution;
+				analysis->harmonics[analysis->harmonicCount].amplitude = sqrtf(
+						value);
+			}
+			analysis->harmonicCount++;
+			harmonicPower += getLobePower(power, index, powerWidth, from,
+					to);
+		}
+	}
+
+	arm_mean_f32((float32_t*) &power[from], to - from, &totalPower);
+	totalPower *= to - from;
+	if (fundamentalPower > 0.0f)
+		arm_sqrt_f32(harmonicPower / fundamentalPower, &analysis->thd);
+	analysis->sinad = toDecibels(fundamentalPower,
+			totalPower - fundamentalPower);
+	analysis->snr = toDecibels(fundamentalPower,
+			totalPower - fundamentalPower - harmonicPower);
+}
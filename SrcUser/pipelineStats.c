@@ -0,0 +1,179 @@
+/*
+ * pipelineStats.c
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#include "pipelineStats.h"
+
+/**
+ * @var PipelineHistogramStr histograms[]
+ * @brief Latency histograms of the pipeline stages
+ */
+static PipelineHistogramStr histograms[PIPELINE_STAGE_COUNT];
+
+/**
+ * @var const char* stageNames[]
+ * @brief Names of \ref PipelineStage values
+ */
+static const char* stageNames[PIPELINE_STAGE_COUNT] = { "Capture", "Copy",
+		"Window", "Fft", "Magnitude", "Analysis", "Bands", "Features",
+		"Scale", "Publish", "Send", "CaptureToPublish", "CaptureToSend" };
+
+/**
+ * @brief Gets the histogram bucket of the value. Values below \ref PIPELINE_STATS_SUB_BUCKETS
+ * have their own buckets, bigger values are split by the most significant bit and the next
+ * \ref PIPELINE_STATS_SUB_BUCKETS_BITS bits.
+ * @param value: latency [us]
+ * @retval index of the bucket
+ */
+static uint32_t getBucket(uint32_t value) {
+	uint32_t msb;
+	uint32_t bucket;
+
+	if (value < PIPELINE_STATS_SUB_BUCKETS)
+		return value;
+
+	msb = 31 - __CLZ(value);
+	bucket = (msb - PIPELINE_STATS_SUB_BUCKETS_BITS + 1)
+			* PIPELINE_STATS_SUB_BUCKETS
+			+ ((value >> (msb - PIPELINE_STATS_SUB_BUCKETS_BITS))
+					& (PIPELINE_STATS_SUB_BUCKETS - 1));
+	return bucket < PIPELINE_STATS_BUCKETS ? bucket : PIPELINE_STATS_BUCKETS - 1;
+}
+
+/**
+ * @brief Gets the biggest value counted in the bucket
+ * @param bucket: index of the bucket
+ * @retval latency [us]
+ */
+static uint32_t getBucketLimit(uint32_t bucket) {
+	uint32_t shift;
+	uint32_t mantissa;
+
+	if (bucket < PIPELINE_STATS_SUB_BUCKETS)
+		return bucket;
+
+	shift = bucket / PIPELINE_STATS_SUB_BUCKETS - 1;
+	mantissa = PIPELINE_STATS_SUB_BUCKETS + bucket % PIPELINE_STATS_SUB_BUCKETS;
+	return ((mantissa + 1) << shift) - 1;
+}
+
+/**
+ * @brief Gets the latency which is not exceeded by the given part of samples
+ * (the limit of the bucket, but not more than the measured maximum)
+ * @param histogram: pointer to \ref PipelineHistogramStr
+ * @param count: number of samples in the histogram
+ * @param percent: percentile [%]
+ * @retval latency [us]
+ */
+static uint32_t getPercentile(const PipelineHistogramStr* histogram,
+		uint32_t count, uint32_t percent) {
+	uint32_t rank = (uint32_t) (((uint64_t) count * percent + 99) / 100);
+	uint32_t sum = 0;
+	uint32_t limit;
+	uint32_t i;
+
+	for (i = 0; i < PIPELINE_STATS_BUCKETS; i++) {
+		sum += histogram->buckets[i];
+		if (sum >= rank && sum > 0) {
+			limit = getBucketLimit(i);
+			return limit < histogram->max ? limit : histogram->max;
+		}
+	}
+	return histogram->max;
+}
+
+/**
+ * @brief Clears all histograms (samples recorded at the same time may be lost)
+ */
+void pipelineStatsReset() {
+	memset(histograms, 0, sizeof(histograms));
+}
+
+/**
+ * @brief Adds the latency to the histogram of the stage
+ * @param stage: \ref PipelineStage
+ * @param latency: latency [us]
+ */
+void pipelineStatsRecord(PipelineStage stage, uint32_t latency) {
+	PipelineHistogramStr* histogram = &histograms[stage];
+
+	histogram->buckets[getBucket(latency)]++;
+	histogram->sum += latency;
+	if (latency > histogram->max)
+		histogram->max = latency;
+	histogram->count++;
+}
+
+/**
+ * @brief Adds the time since \p startCycles to the histogram of the stage
+ * @param stage: \ref PipelineStage
+ * @param startCycles: start of the stage (\ref timeBaseGetCycles value)
+ * @retval current \ref timeBaseGetCycles value (start of the next stage)
+ */
+uint64_t pipelineStatsRecordSince(PipelineStage stage, uint64_t startCycles) {
+	uint64_t cycles = timeBaseGetCycles();
+
+	pipelineStatsRecord(stage,
+			(uint32_t) timeBaseCyclesToUs(cycles - startCycles));
+	return cycles;
+}
+
+/**
+ * @brief Adds the age of the data to the histogram of the stage
+ * @param stage: \ref PipelineStage
+ * @param timestamp: time when the data were captured (\ref timeBaseGetUs value, 0 if nothing was captured yet)
+ */
+void pipelineStatsRecordAge(PipelineStage stage, uint64_t timestamp) {
+	uint64_t now = timeBaseGetUs();
+
+	if (timestamp == 0)
+		return;
+	pipelineStatsRecord(stage, now > timestamp ? now - timestamp : 0);
+}
+
+/**
+ * @brief Gets the latency summary of the stage
+ * @param stage: \ref PipelineStage
+ * @param summary: output \ref PipelineStageSummaryStr
+ */
+void pipelineStatsGetSummary(PipelineStage stage,
+		PipelineStageSummaryStr* summary) {
+	const PipelineHistogramStr* histogram = &histograms[stage];
+	uint32_t count = histogram->count;
+
+	memset(summary, 0, sizeof(PipelineStageSummaryStr));
+	if (count == 0)
+		return;
+
+	summary->count = count;
+	summary->mean = (uint32_t) (histogram->sum / count);
+	summary->p50 = getPercentile(histogram, count, 50);
+	summary->p99 = getPercentile(histogram, count, 99);
+	summary->max = histogram->max;
+}
+
+/**
+ * @brief Writes the latency summary of all stages as JSON object (stage name -> summary)
+ * @param writer: pointer to \ref JsonWriterStr
+ */
+void pipelineStatsToJson(JsonWriterStr* writer) {
+	PipelineStageSummaryStr summary;
+	uint32_t stage;
+
+	jsonWriterBeginObject(writer);
+	for (stage = 0; stage < PIPELINE_STAGE_COUNT; stage++) {
+		pipelineStatsGetSummary((PipelineStage) stage, &summary);
+
+		jsonWriterKey(writer, stageNames[stage]);
+		jsonWriterBeginObject(writer);
+		jsonWriterAddUint(writer, "Count", summary.count);
+		jsonWriterAddUint(writer, "MeanUs", summary.mean);
+		jsonWriterAddUint(writer, "P50Us", summary.p50);
+		jsonWriterAddUint(writer, "P99Us", summary.p99);
+		jsonWriterAddUint(writer, "MaxUs", summary.max);
+		jsonWriterEndObject(writer);
+	}
+	jsonWriterEndObject(writer);
+}
@@ -15,9 +15,148 @@
  */
 void soundProcessingGetAmplitudeInstance(arm_cfft_instance_f32* cfft_instance,
 		SpectrumStr* amplitudeStr, float32_t* sourceBuffer) {
+	soundProcessingTransform(cfft_instance, sourceBuffer);
+	soundProcessingGetMagnitude(cfft_instance, amplitudeStr, sourceBuffer);
+}
+
+/**
+ * @brief The function calculates FFT of the samples in place (first step of \ref soundProcessingGetAmplitudeInstance)
+ * @param cfft_instance: pointer to \ref arm_cfft_instance_f32
+ * @param sourceBuffer: buffer of audio samples (replaced by complex FFT result)
+ */
+void soundProcessingTransform(arm_cfft_instance_f32* cfft_instance,
+		float32_t* sourceBuffer) {
 	arm_cfft_f32(cfft_instance, sourceBuffer, 0, 1);
+}
+
+/**
+ * @brief The function calculates the amplitude vector from FFT result (second step of \ref soundProcessingGetAmplitudeInstance)
+ * @param cfft_instance: pointer to \ref arm_cfft_instance_f32
+ * @param amplitudeStr: pointer to \ref SpectrumStr - destination of amplitude vector
+ * @param sourceBuffer: complex FFT result
+ */
+void soundProcessingGetMagnitude(arm_cfft_instance_f32* cfft_instance,
+		SpectrumStr* amplitudeStr, float32_t* sourceBuffer) {
 	arm_cmplx_mag_f32(sourceBuffer, amplitudeStr->amplitudeVector,
 			cfft_instance->fftLen);
+	amplitudeStr->scale = SPECTRUM_SCALE_LINEAR;
+}
+
+/**
+ * @brief The function calculates the power vector (squared magnitudes) from FFT result
+ * without the square root per bin (used instead of \ref soundProcessingGetMagnitude)
+ * @param cfft_instance: pointer to \ref arm_cfft_instance_f32
+ * @param amplitudeStr: pointer to \ref SpectrumStr - destination of power vector
+ * @param sourceBuffer: complex FFT result
+ */
+void soundProcessingGetPower(arm_cfft_instance_f32* cfft_instance,
+		SpectrumStr* amplitudeStr, float32_t* sourceBuffer) {
+	arm_cmplx_mag_squared_f32(sourceBuffer, amplitudeStr->amplitudeVector,
+			cfft_instance->fftLen);
+	amplitudeStr->scale = SPECTRUM_SCALE_POWER;
+}
+
+/**
+ * @brief Approximates base 2 logarithm with the exponent bits of the float and a parabola
+ * fitted to the mantissa (the error is below 0.005, i.e. 0.015 dB of power)
+ * @param value: positive value
+ * @retval logarithm of the value
+ */
+float32_t soundProcessingLog2(float32_t value) {
+	union {
+		float32_t value;
+		int32_t bits;
+	} number;
+	int32_t exponent;
+
+	number.value = value;
+	exponent = ((number.bits >> 23) & 0xFF) - 127;
+	number.bits = (number.bits & 0x007FFFFF) | 0x3F800000;
+	return (float32_t) exponent
+			+ (-0.34484843f * number.value + 2.02466578f) * number.value
+			- 1.67487759f;
+}
+
+/**
+ * @brief Converts the power vector calculated by \ref soundProcessingGetPower to the scale
+ * (the square root is taken only for the linear scale)
+ * @param amplitudeStr: pointer to \ref SpectrumStr with power vector
+ * @param scale: output \ref SpectrumScaleType
+ */
+void soundProcessingApplyScale(SpectrumStr* amplitudeStr,
+		SpectrumScaleType scale) {
+	float32_t* vector = amplitudeStr->amplitudeVector;
+	uint32_t i;
+
+	switch (scale) {
+	case SPECTRUM_SCALE_DB: {
+		// 10 * log10(x) = 10 * log10(2) * log2(x)
+		for (i = 0; i < amplitudeStr->vectorSize; i++)
+			vector[i] =
+					vector[i] > SOUND_PROCESSING_MIN_POWER ?
+							3.01029996f * soundProcessingLog2(vector[i]) :
+							SOUND_PROCESSING_MIN_DB;
+		amplitudeStr->scale = SPECTRUM_SCALE_DB;
+		break;
+	}
+	case SPECTRUM_SCALE_POWER: {
+		break;
+	}
+	default: {
+		for (i = 0; i < amplitudeStr->vectorSize; i++)
+			arm_sqrt_f32(vector[i], &vector[i]);
+		amplitudeStr->scale = SPECTRUM_SCALE_LINEAR;
+		break;
+	}
+	}
+}
+
+/**
+ * @brief Converts the copied bins to magnitudes (used by views which scale the magnitude)
+ * @param values: bins in \p scale (changed in place)
+ * @param count: number of bins
+ * @param scale: \ref SpectrumScaleType of the bins
+ */
+void soundProcessingToMagnitude(float32_t* values, uint32_t count,
+		SpectrumScaleType scale) {
+	uint32_t i;
+
+	if (scale == SPECTRUM_SCALE_POWER) {
+		for (i = 0; i < count; i++)
+			arm_sqrt_f32(values[i], &values[i]);
+	} else if (scale == SPECTRUM_SCALE_DB) {
+		for (i = 0; i < count; i++)
+			values[i] =
+					values[i] > SOUND_PROCESSING_MIN_DB ?
+							powf(10.0f, values[i] / 20.0f) : 0.0f;
+	}
+}
+
+/**
+ * @brief Converts the copied bins to power levels in dB (used by views which show the level,
+ * the bins in dB scale are not changed)
+ * @param values: bins in \p scale (changed in place)
+ * @param count: number of bins
+ * @param scale: \ref SpectrumScaleType of the bins
+ */
+void soundProcessingToDb(float32_t* values, uint32_t count,
+		SpectrumScaleType scale) {
+	float32_t factor = 3.01029996f;
+	float32_t minValue = SOUND_PROCESSING_MIN_POWER;
+	uint32_t i;
+
+	if (scale == SPECTRUM_SCALE_DB)
+		return;
+	if (scale != SPECTRUM_SCALE_POWER) {
+		// the power level of the magnitude: 20 * log10(x) = 20 * log10(2) * log2(x)
+		factor = 6.02059991f;
+		minValue = SOUND_PROCESSING_MIN_MAGNITUDE;
+	}
+	for (i = 0; i < count; i++)
+		values[i] =
+				values[i] > minValue ?
+						factor * soundProcessingLog2(values[i]) :
+						SOUND_PROCESSING_MIN_DB;
 }
 
 /**
@@ -33,6 +172,7 @@ void soundProcessingAmplitudeInit(SpectrumStr* spectrumStr,
 	spectrumStr->frequencyResolution = (float32_t) soundBuffer->frequency
 			/ soundBuffer->size * 2;
 	spectrumStr->vectorSize = soundBuffer->size / 2;
+	spectrumStr->timestamp = soundBuffer->timestamp;
 
 	soundBuffIterator = soundBuffer->iterator + 1;
 	for (i = 0; i < soundBuffer->size; i++) {
@@ -42,6 +182,22 @@ void soundProcessingAmplitudeInit(SpectrumStr* spectrumStr,
 	}
 }
 
+/**
+ * @brief Gets the name of the scale (the same as in JSON configuration)
+ * @param scale: \ref SpectrumScaleType
+ * @retval name of the scale
+ */
+const char* soundProcessingGetScaleName(SpectrumScaleType scale) {
+	switch (scale) {
+	case SPECTRUM_SCALE_POWER:
+		return "POWER";
+	case SPECTRUM_SCALE_DB:
+		return "DB";
+	default:
+		return "LINEAR";
+	}
+}
+
 /**
  * @brief Returns the \ref SingleFreqStr instance which is representating the frequency with the maximum amplitude found in the amplitude vector
  * @param amplitudeStr: pointer to \ref SpectrumStr
@@ -133,6 +289,11 @@ void soundProcessingCopyAmplitudeInstance(SpectrumStr* source,
 	uint32_t i;
 	destination->frequencyResolution = source->frequencyResolution;
 	destination->vectorSize = source->vectorSize;
+	destination->scale = source->scale;
+	destination->timestamp = source->timestamp;
+	destination->analysis = source->analysis;
+	destination->bands = source->bands;
+	destination->features = source->features;
 
 	for (i = 0; i < destination->vectorSize; i++) {
 		destination->amplitudeVector[i] = source->amplitudeVector[i];
@@ -0,0 +1,172 @@
+/*
+ * spectrumSnapshot.c
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#include "spectrumSnapshot.h"
+
+/**
+ * @brief Initializes the snapshot
+ * @param snapshot: pointer to \ref SpectrumSnapshotStr structure
+ * @param spectrum: pointer to \ref SpectrumStr which holds the published spectrum
+ */
+void spectrumSnapshotInit(SpectrumSnapshotStr* snapshot, SpectrumStr* spectrum) {
+	snapshot->sequence = 0;
+	snapshot->spectrum = spectrum;
+}
+
+/**
+ * @brief Publishes the new spectrum (only one task may publish)
+ * @param snapshot: pointer to \ref SpectrumSnapshotStr structure
+ * @param source: pointer to \ref SpectrumStr with the new spectrum
+ */
+void spectrumSnapshotPublish(SpectrumSnapshotStr* snapshot, SpectrumStr* source) {
+	snapshot->sequence++;
+	__DMB();
+
+	soundProcessingCopyAmplitudeInstance(source, snapshot->spectrum);
+
+	__DMB();
+	snapshot->sequence++;
+}
+
+/**
+ * @brief Copies the part of the last published spectrum without locking. Every \p decimation bins
+ * are reduced to one bin holding their maximum value.
+ * @param snapshot: pointer to \ref SpectrumSnapshotStr structure
+ * @param destination: output buffer (must hold (to - from) / decimation + 1 values)
+ * @param from: first bin index
+ * @param to: last bin index (exclusive, it is limited to the spectrum size)
+ * @param decimation: number of bins reduced to one output bin (at least 1)
+ * @param info: output description of copied data
+ * @retval returns 1 if a consistent copy was made
+ */
+uint8_t spectrumSnapshotRead(SpectrumSnapshotStr* snapshot,
+		float32_t* destination, uint32_t from, uint32_t to, uint32_t decimation,
+		SpectrumSnapshotInfoStr* info) {
+	uint32_t retries;
+	uint32_t sequence;
+	uint32_t i;
+	uint32_t j;
+
+	if (decimation == 0)
+		decimation = 1;
+
+	for (retries = 0; retries < SPECTRUM_SNAPSHOT_MAX_RETRIES; retries++) {
+		sequence = snapshot->sequence;
+		if (sequence & 1) {
+			// the writer was preempted during the copy
+			osThreadYield();
+			continue;
+		}
+		__DMB();
+
+		SpectrumStr* spectrum = snapshot->spectrum;
+		uint32_t last = to;
+		if (last > spectrum->vectorSize)
+			last = spectrum->vectorSize;
+
+		info->frameNumber = sequence / 2;
+		info->vectorSize = spectrum->vectorSize;
+		info->frequencyResolution = spectrum->frequencyResolution;
+		info->from = from;
+		info->decimation = decimation;
+		info->count = 0;
+		info->timestampLow = (uint32_t) spectrum->timestamp;
+		info->timestampHigh = (uint32_t) (spectrum->timestamp >> 32);
+		info->scale = spectrum->scale;
+
+		for (i = from; i < last; i += decimation) {
+			float32_t maxValue = spectrum->amplitudeVector[i];
+			for (j = i + 1; j < i + decimation && j < last; j++) {
+				if (spectrum->amplitudeVector[j] > maxValue)
+					maxValue = spectrum->amplitudeVector[j];
+			}
+			destination[info->count++] = maxValue;
+		}
+
+		__DMB();
+		if (snapshot->sequence == sequence)
+			return 1;
+		osThreadYield();
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Copies one member of the last published spectrum without locking (the readers of
+ * the analysis results do not copy the bins)
+ * @param snapshot: pointer to \ref SpectrumSnapshotStr structure
+ * @param destination: output buffer
+ * @param offset: offset of the member in \ref SpectrumStr
+ * @param size: size of the member
+ * @param frameNumber: output number of the published spectrum
+ * @retval returns 1 if a consistent copy was made
+ */
+static uint8_t readMember(SpectrumSnapshotStr* snapshot, void* destination,
+		uint32_t offset, uint32_t size, uint32_t* frameNumber) {
+	uint32_t retries;
+	uint32_t sequence;
+
+	for (retries = 0; retries < SPECTRUM_SNAPSHOT_MAX_RETRIES; retries++) {
+		sequence = snapshot->sequence;
+		if (sequence & 1) {
+			// the writer was preempted during the copy
+			osThreadYield();
+			continue;
+		}
+		__DMB();
+
+		memcpy(destination, (uint8_t*) snapshot->spectrum + offset, size);
+		*frameNumber = sequence / 2;
+
+		__DMB();
+		if (snapshot->sequence == sequence)
+			return 1;
+		osThreadYield();
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Copies the peak analysis of the last published spectrum without locking
+ * (clients which need only peaks and harmonics do not copy the bins)
+ * @param snapshot: pointer to \ref SpectrumSnapshotStr structure
+ * @param analysis: output \ref PeakAnalysisStr
+ * @param frameNumber: output number of the published spectrum
+ * @retval returns 1 if a consistent copy was made
+ */
+uint8_t spectrumSnapshotReadAnalysis(SpectrumSnapshotStr* snapshot,
+		PeakAnalysisStr* analysis, uint32_t* frameNumber) {
+	return readMember(snapshot, analysis, offsetof(SpectrumStr, analysis),
+			sizeof(PeakAnalysisStr), frameNumber);
+}
+
+/**
+ * @brief Copies the band levels of the last published spectrum without locking
+ * @param snapshot: pointer to \ref SpectrumSnapshotStr structure
+ * @param bands: output \ref BandLevelsStr
+ * @param frameNumber: output number of the published spectrum
+ * @retval returns 1 if a consistent copy was made
+ */
+uint8_t spectrumSnapshotReadBands(SpectrumSnapshotStr* snapshot,
+		BandLevelsStr* bands, uint32_t* frameNumber) {
+	return readMember(snapshot, bands, offsetof(SpectrumStr, bands),
+			sizeof(BandLevelsStr), frameNumber);
+}
+
+/**
+ * @brief Copies the MFCC features of the last published spectrum without locking
+ * @param snapshot: pointer to \ref SpectrumSnapshotStr structure
+ * @param features: output \ref MfccFeaturesStr
+ * @param frameNumber: output number of the published spectrum
+ * @retval returns 1 if a consistent copy was made
+ */
+uint8_t spectrumSnapshotReadFeatures(SpectrumSnapshotStr* snapshot,
+		MfccFeaturesStr* features, uint32_t* frameNumber) {
+	return readMember(snapshot, features, offsetof(SpectrumStr, features),
+			sizeof(MfccFeaturesStr), frameNumber);
+}
@@ -44,7 +44,7 @@ extern ETH_HandleTypeDef heth;
 extern TIM_HandleTypeDef htim1;
 extern TIM_HandleTypeDef htim11;
 
-volatile uint16_t tim6OverflowCount;
+extern LTDC_HandleTypeDef hLtdcHandler;
 
 /******************************************************************************/
 /*            Cortex-M7 Processor Interruption and Exception Handlers         */
@@ -55,11 +55,11 @@ volatile uint16_t tim6OverflowCount;
  */
 void SysTick_Handler(void) {
 	/* USER CODE BEGIN SysTick_IRQn 0 */
-
+	traceRecorderIsrEnter();
 	/* USER CODE END SysTick_IRQn 0 */
 	osSystickHandler();
 	/* USER CODE BEGIN SysTick_IRQn 1 */
-
+	traceRecorderIsrExit();
 	/* USER CODE END SysTick_IRQn 1 */
 }
 
@@ -75,11 +75,11 @@ void SysTick_Handler(void) {
  */
 void TIM1_UP_TIM10_IRQHandler(void) {
 	/* USER CODE BEGIN TIM1_UP_TIM10_IRQn 0 */
-
+	traceRecorderIsrEnter();
 	/* USER CODE END TIM1_UP_TIM10_IRQn 0 */
 	HAL_TIM_IRQHandler(&htim1);
 	/* USER CODE BEGIN TIM1_UP_TIM10_IRQn 1 */
-
+	traceRecorderIsrExit();
 	/* USER CODE END TIM1_UP_TIM10_IRQn 1 */
 }
 
@@ -88,11 +88,11 @@ void TIM1_UP_TIM10_IRQHandler(void) {
  */
 void TIM1_TRG_COM_TIM11_IRQHandler(void) {
 	/* USER CODE BEGIN TIM1_TRG_COM_TIM11_IRQn 0 */
-
+	traceRecorderIsrEnter();
 	/* USER CODE END TIM1_TRG_COM_TIM11_IRQn 0 */
 	HAL_TIM_IRQHandler(&htim11);
 	/* USER CODE BEGIN TIM1_TRG_COM_TIM11_IRQn 1 */
-	tim6OverflowCount++;
+	traceRecorderIsrExit();
 	/* USER CODE END TIM1_TRG_COM_TIM11_IRQn 1 */
 }
 
@@ -101,15 +101,24 @@ void TIM1_TRG_COM_TIM11_IRQHandler(void) {
  */
 void ETH_IRQHandler(void) {
 	/* USER CODE BEGIN ETH_IRQn 0 */
-
+	traceRecorderIsrEnter();
 	/* USER CODE END ETH_IRQn 0 */
 	ETHERNET_IRQHandler();
 	/* USER CODE BEGIN ETH_IRQn 1 */
-
+	traceRecorderIsrExit();
 	/* USER CODE END ETH_IRQn 1 */
 }
 
 /* USER CODE BEGIN 1 */
+/**
+ * @brief This function handles LTDC global interrupt (line interrupt used for framebuffer swaps).
+ */
+void LTDC_IRQHandler(void) {
+	traceRecorderIsrEnter();
+	HAL_LTDC_IRQHandler(&hLtdcHandler);
+	traceRecorderIsrExit();
+}
+
 void HardFault_Handler() {
 	logMsg("Hard fault");
 
@@ -139,7 +148,9 @@ void MemMang_Handler() {
  * @retval None
  */
 void AUDIO_IN_SAIx_DMAx_IRQHandler(void) {
+	traceRecorderIsrEnter();
 	HAL_DMA_IRQHandler(haudio_in_sai.hdmarx);
+	traceRecorderIsrExit();
 }
 /* USER CODE END 1 */
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,218 @@
+/*
+ * syslogSink.c
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#include "syslogSink.h"
+
+/**
+ * @var netconn* syslogSocket
+ * @brief UDP socket of the sink (NULL until \ref syslogSinkInit is called)
+ */
+static struct netconn* volatile syslogSocket = NULL;
+
+/**
+ * @var netbuf* syslogBuffer
+ * @brief Netbuf reused for every datagram
+ */
+static struct netbuf* syslogBuffer = NULL;
+
+/**
+ * @var UdpConnectionStr syslogConnection
+ * @brief Current collector address
+ */
+static UdpConnectionStr syslogConnection;
+
+/**
+ * @var char syslogHostname[]
+ * @brief HOSTNAME field of the records (device IP address)
+ */
+static char syslogHostname[16];
+
+/**
+ * @var char datagram[]
+ * @brief Records waiting for sending (separated by LF)
+ */
+static char datagram[SYSLOG_DATAGRAM_SIZE];
+
+/**
+ * @var uint32_t datagramLength
+ * @brief Length of \ref datagram [bytes]
+ */
+static uint32_t datagramLength = 0;
+
+/**
+ * @var uint32_t datagramRecords
+ * @brief Number of records in \ref datagram
+ */
+static uint32_t datagramRecords = 0;
+
+/**
+ * @var uint32_t batchStart
+ * @brief Time when the first record was added to \ref datagram [ms]
+ */
+static uint32_t batchStart = 0;
+
+/**
+ * @var uint32_t nextSequence
+ * @brief Sequence number of the next record taken from the log history
+ */
+static uint32_t nextSequence = 1;
+
+/**
+ * @var SyslogSinkStatsStr syslogStats
+ * @brief Counters of the sink
+ */
+static SyslogSinkStatsStr syslogStats;
+
+/**
+ * @brief Formats the record as RFC 5424 message. The device has no calendar clock,
+ * so TIMESTAMP is NILVALUE and the uptime is sent in the meta structured data.
+ * @param entry: pointer to \ref LogEntryStr
+ * @param message: output buffer
+ * @param size: size of the output buffer [bytes]
+ * @retval message length [bytes]
+ */
+static uint32_t formatMessage(const LogEntryStr* entry, char* message,
+		uint32_t size) {
+	int length;
+
+	length = snprintf(message, size,
+			"<%lu>1 - %s " SYSLOG_APP_NAME " - - [meta sequenceId=\"%lu\" sysUpTime=\"%lu\"] %s",
+			(uint32_t) (SYSLOG_FACILITY * 8 + entry->severity), syslogHostname,
+			entry->sequence,
+			(uint32_t) (timeBaseCyclesToUs(entry->timestamp) / 10000),
+			entry->text);
+	if (length < 0)
+		return 0;
+	return (uint32_t) length < size ? (uint32_t) length : size - 1;
+}
+
+/**
+ * @brief Initializes the UDP socket of the sink (called after the network initialization)
+ * @param hostname: device IP address (text)
+ */
+void syslogSinkInit(const char* hostname) {
+	struct netconn* socket;
+
+	strncpy(syslogHostname, hostname, sizeof(syslogHostname) - 1);
+	syslogHostname[sizeof(syslogHostname) - 1] = '\0';
+	syslogConnection.connected = 0;
+
+	syslogBuffer = netbuf_new();
+	if (syslogBuffer == NULL)
+		logErr("Null syslog netbuf");
+
+	socket = netconn_new(NETCONN_UDP);
+	if (socket == NULL) {
+		logErr("Null syslog UDP");
+		return;
+	}
+
+	// the logger task starts using the sink when the socket is set
+	__DMB();
+	syslogSocket = socket;
+}
+
+/**
+ * @brief Checks if the sink was initialized (the configuration can be read then)
+ * @retval returns 1 if \ref syslogSinkInit created the socket
+ */
+uint8_t syslogSinkIsReady() {
+	return syslogSocket != NULL;
+}
+
+/**
+ * @brief Adds the new records from the log history to the datagram (called by the logger task).
+ * Records which were overwritten in the history before they were taken are counted as lost.
+ * @param ip: collector IP address (text, \ref SYSLOG_DISABLED_IP turns the sink off)
+ * @param port: collector UDP port
+ * @retval returns 1 if the datagram should be sent by \ref syslogSinkSend
+ */
+uint8_t syslogSinkCollect(const char* ip, uint32_t port) {
+	LogEntryStr entry;
+	char message[SYSLOG_MESSAGE_SIZE];
+	uint32_t length;
+	uint32_t first;
+	uint32_t last = logGetLastSequence();
+
+	if (syslogSocket == NULL || port == 0 || strlen(ip) == 0
+			|| strcmp(ip, SYSLOG_DISABLED_IP) == 0) {
+		// records are not collected while the sink is off
+		nextSequence = last + 1;
+		datagramLength = 0;
+		datagramRecords = 0;
+		return 0;
+	}
+
+	while (nextSequence <= last) {
+		first = logGetFirstSequence();
+		if (nextSequence < first) {
+			syslogStats.lostRecords += first - nextSequence;
+			nextSequence = first;
+		}
+
+		if (!logGetEntry(nextSequence, &entry)) {
+			syslogStats.lostRecords++;
+			nextSequence++;
+			continue;
+		}
+
+		// the full datagram is sent before the next record is added
+		length = formatMessage(&entry, message, sizeof(message));
+		if (datagramLength > 0
+				&& datagramLength + 1 + length > SYSLOG_DATAGRAM_SIZE)
+			return 1;
+
+		if (datagramLength == 0)
+			batchStart = HAL_GetTick();
+		else
+			datagram[datagramLength++] = '\n';
+		memcpy(&datagram[datagramLength], message, length);
+		datagramLength += length;
+		datagramRecords++;
+		nextSequence++;
+	}
+
+	return datagramLength > 0
+			&& HAL_GetTick() - batchStart >= SYSLOG_BATCH_TIME;
+}
+
+/**
+ * @brief Sends the collected records in one datagram (called by the logger task
+ * with taken ethernet interface mutex). The records are dropped if sending fails.
+ * @param ip: collector IP address (text)
+ * @param port: collector UDP port
+ * @retval returns \ref ERR_OK if there are no errors
+ */
+err_t syslogSinkSend(const char* ip, uint32_t port) {
+	err_t err;
+
+	if (syslogSocket == NULL || datagramLength == 0)
+		return ERR_OK;
+
+	err = udpConnectIfChanged(syslogSocket, &syslogConnection, ip, port);
+	if (err == ERR_OK)
+		err = udpSendNetbuf(syslogSocket, syslogBuffer, datagram,
+				datagramLength);
+
+	if (err == ERR_OK) {
+		syslogStats.sentDatagrams++;
+		syslogStats.sentRecords += datagramRecords;
+	} else {
+		syslogStats.failedDatagrams++;
+		syslogStats.lostRecords += datagramRecords;
+	}
+	datagramLength = 0;
+	datagramRecords = 0;
+	return err;
+}
+
+/**
+ * @brief Copies the counters of the sink
+ * @param stats: output \ref SyslogSinkStatsStr structure
+ */
+void syslogSinkGetStats(SyslogSinkStatsStr* stats) {
+	*stats = syslogStats;
+}
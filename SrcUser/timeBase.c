@@ -0,0 +1,80 @@
+/*
+ * timeBase.c
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#include "timeBase.h"
+
+/**
+ * @var uint32_t lastCycles
+ * @brief CYCCNT value read last time (a smaller value means that the counter wrapped)
+ */
+static uint32_t lastCycles = 0;
+
+/**
+ * @var uint32_t cycleOverflows
+ * @brief Number of CYCCNT wraps (upper 32 bits of the time base)
+ */
+static uint32_t cycleOverflows = 0;
+
+/**
+ * @brief Starts the DWT cycle counter. It wraps every 2^32 cycles (19.9 s at 216 MHz),
+ * so \ref timeBaseGetCycles has to be called more often (it is called by the tick hook).
+ */
+void timeBaseInit() {
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->LAR = TIME_BASE_DWT_UNLOCK_KEY;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	lastCycles = 0;
+	cycleOverflows = 0;
+}
+
+/**
+ * @brief Gets the monotonic 64-bit number of CPU cycles since \ref timeBaseInit
+ * (it can be called from tasks and interrupts)
+ * @retval number of CPU cycles
+ */
+uint64_t timeBaseGetCycles() {
+	uint32_t primask = __get_PRIMASK();
+	uint32_t cycles;
+	uint32_t overflows;
+
+	// the wrap has to be detected and counted by one caller at a time
+	__disable_irq();
+	cycles = DWT->CYCCNT;
+	if (cycles < lastCycles)
+		cycleOverflows++;
+	lastCycles = cycles;
+	overflows = cycleOverflows;
+	__set_PRIMASK(primask);
+
+	return ((uint64_t) overflows << 32) | cycles;
+}
+
+/**
+ * @brief Converts the number of CPU cycles to microseconds
+ * @param cycles: number of CPU cycles
+ * @retval time [us]
+ */
+uint64_t timeBaseCyclesToUs(uint64_t cycles) {
+	return cycles / (SystemCoreClock / 1000000);
+}
+
+/**
+ * @brief Gets the monotonic 64-bit time since \ref timeBaseInit
+ * @retval time [us]
+ */
+uint64_t timeBaseGetUs() {
+	return timeBaseCyclesToUs(timeBaseGetCycles());
+}
+
+/**
+ * @brief Gets the FreeRTOS run time counter (CPU cycles divided by 2^\ref TIME_BASE_RUN_TIME_SHIFT,
+ * without 64-bit division because it is called at every context switch)
+ * @retval run time counter value
+ */
+uint32_t timeBaseGetRunTimeCounter() {
+	return (uint32_t) (timeBaseGetCycles() >> TIME_BASE_RUN_TIME_SHIFT);
+}
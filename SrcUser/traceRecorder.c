@@ -0,0 +1,188 @@
+/*
+ * traceRecorder.c
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#include "traceRecorder.h"
+
+/**
+ * @var TraceEventStr traceEvents[]
+ * @brief Ring of trace events
+ */
+static TraceEventStr traceEvents[TRACE_RECORDER_EVENTS];
+
+/**
+ * @var uint32_t traceHead
+ * @brief Number of events written since the last clear (the next event index is traceHead modulo ring size)
+ */
+static volatile uint32_t traceHead = 0;
+
+/**
+ * @var uint32_t skippedEvents
+ * @brief Number of events which were not written because the recording was paused
+ */
+static volatile uint32_t skippedEvents = 0;
+
+/**
+ * @var uint8_t recording
+ * @brief Recording flag (cleared while the ring is sent)
+ */
+static volatile uint8_t recording = 1;
+
+/**
+ * @var TraceObjectEntryStr traceObjects[]
+ * @brief Named objects registered by FreeRTOS hooks
+ */
+static TraceObjectEntryStr traceObjects[TRACE_RECORDER_MAX_OBJECTS];
+
+/**
+ * @var uint32_t traceObjectCount
+ * @brief Number of reserved \ref traceObjects entries
+ */
+static volatile uint32_t traceObjectCount = 0;
+
+/**
+ * @brief Atomically increments the counter (safe in tasks and interrupts)
+ * @param counter: pointer to counter
+ * @retval counter value before the increment
+ */
+static uint32_t atomicIncrement(volatile uint32_t* counter) {
+	uint32_t value;
+
+	do {
+		value = __LDREXW(counter);
+	} while (__STREXW(value + 1, counter) != 0);
+	return value;
+}
+
+/**
+ * @brief Writes the event to the ring without locking (it is called by FreeRTOS trace hooks
+ * and interrupts, so it takes only a few dozens of cycles)
+ * @param type: \ref TraceEventType
+ * @param id: event id (see \ref TraceEventType)
+ * @param object: address of the task or queue (NULL if not used)
+ */
+void traceRecorderWrite(uint32_t type, uint32_t id, const void* object) {
+	TraceEventStr* event;
+
+	if (!recording) {
+		atomicIncrement(&skippedEvents);
+		return;
+	}
+
+	// the slot is reserved first, so nested interrupts write to the next slots
+	event = &traceEvents[atomicIncrement(&traceHead)
+			& (TRACE_RECORDER_EVENTS - 1)];
+	event->timestamp = DWT->CYCCNT;
+	event->type = type;
+	event->id = id;
+	event->object = (uint32_t) object;
+}
+
+/**
+ * @brief Writes the interrupt entry (called at the beginning of the interrupt handler)
+ */
+void traceRecorderIsrEnter() {
+	traceRecorderWrite(TRACE_EVENT_ISR_ENTER, __get_IPSR(), NULL);
+}
+
+/**
+ * @brief Writes the interrupt exit (called at the end of the interrupt handler)
+ */
+void traceRecorderIsrExit() {
+	traceRecorderWrite(TRACE_EVENT_ISR_EXIT, __get_IPSR(), NULL);
+}
+
+/**
+ * @brief Adds the object name sent with the trace (called when the task is created
+ * and when the queue is added to the registry). The name is copied.
+ * @param kind: \ref TraceObjectKind
+ * @param object: address of the task or queue
+ * @param id: task number or queue type
+ * @param name: object name
+ */
+void traceRecorderRegisterObject(uint32_t kind, const void* object, uint32_t id,
+		const char* name) {
+	uint32_t index = atomicIncrement(&traceObjectCount);
+
+	if (index >= TRACE_RECORDER_MAX_OBJECTS)
+		return;
+	traceObjects[index].object = object;
+	traceObjects[index].id = id;
+	traceObjects[index].kind = kind;
+	if (name != NULL)
+		strncpy(traceObjects[index].name, name, TRACE_RECORDER_NAME_LENGTH - 1);
+}
+
+/**
+ * @brief Pauses the recording (the ring is not changed until \ref traceRecorderResume is called)
+ * and prepares the trace header. All trace hooks run in interrupts or critical sections,
+ * so no event is written by a preempted task when the recording is paused.
+ * @param header: output \ref TraceHeaderStr
+ * @param objects: output table of \ref TRACE_RECORDER_MAX_OBJECTS named objects
+ */
+void traceRecorderPause(TraceHeaderStr* header, TraceObjectStr* objects) {
+	uint32_t head;
+	uint32_t i;
+
+	recording = 0;
+	__DMB();
+	head = traceHead;
+
+	memset(header, 0, sizeof(TraceHeaderStr));
+	header->magic = TRACE_RECORDER_MAGIC;
+	header->format = TRACE_RECORDER_FORMAT;
+	header->eventSize = sizeof(TraceEventStr);
+	header->cpuFrequency = SystemCoreClock;
+	header->eventCount =
+			head < TRACE_RECORDER_EVENTS ? head : TRACE_RECORDER_EVENTS;
+	header->lostEvents = head - header->eventCount + skippedEvents;
+	header->objectCount =
+			traceObjectCount < TRACE_RECORDER_MAX_OBJECTS ?
+					traceObjectCount : TRACE_RECORDER_MAX_OBJECTS;
+
+	for (i = 0; i < header->objectCount; i++) {
+		memset(&objects[i], 0, sizeof(TraceObjectStr));
+		objects[i].object = (uint32_t) traceObjects[i].object;
+		objects[i].id = traceObjects[i].id;
+		objects[i].kind = traceObjects[i].kind;
+		memcpy(objects[i].name, traceObjects[i].name,
+		TRACE_RECORDER_NAME_LENGTH);
+	}
+}
+
+/**
+ * @brief Gets the part of the paused ring (the ring is sent as two continuous parts: older and newer events)
+ * @param part: 0 for the older part, 1 for the newer part
+ * @param events: output pointer to the first event of the part
+ * @retval number of events in the part
+ */
+uint32_t traceRecorderGetEvents(uint32_t part, const TraceEventStr** events) {
+	uint32_t head = traceHead;
+	uint32_t count = head < TRACE_RECORDER_EVENTS ? head : TRACE_RECORDER_EVENTS;
+	uint32_t start = (head - count) & (TRACE_RECORDER_EVENTS - 1);
+	uint32_t olderCount =
+			count < TRACE_RECORDER_EVENTS - start ?
+					count : TRACE_RECORDER_EVENTS - start;
+
+	if (part == 0) {
+		*events = &traceEvents[start];
+		return olderCount;
+	}
+	*events = &traceEvents[0];
+	return count - olderCount;
+}
+
+/**
+ * @brief Resumes the recording
+ * @param clear: if 1 the ring is cleared
+ */
+void traceRecorderResume(uint8_t clear) {
+	if (clear) {
+		traceHead = 0;
+		skippedEvents = 0;
+	}
+	__DMB();
+	recording = 1;
+}
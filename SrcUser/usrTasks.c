@@ -14,10 +14,10 @@
 extern struct netif ethernetInterfaceHandler;
 
 /**
- * @var StmConfig configStr
- * @brief System configuration structure
-**/
-StmConfig* configStr;
+ * @var StmConfigSnapshotStr configSnapshot
+ * @brief System configuration (versioned, read without locking)
+ */
+StmConfigSnapshotStr configSnapshot;
 
 /**
  * @var SoundBuffer* mainSoundBuffer
@@ -37,14 +37,35 @@ uint16_t dmaAudioBuffer[AUDIO_BUFFER_SIZE];
  */
 SpectrumStr* mainSpectrumBuffer;
 
+/**
+ * @var SpectrumSnapshotStr mainSpectrumSnapshot
+ * @brief Lock-free access to \ref mainSpectrumBuffer (for readers which do not take mainSpectrumBufferMutex)
+ */
+SpectrumSnapshotStr mainSpectrumSnapshot;
+
+/**
+ * @var UdpStreamingStatsStr udpStreamingStats
+ * @brief UDP streaming throughput (updated by streaming task, read by GET /network)
+ */
+UdpStreamingStatsStr udpStreamingStats;
+
 /* Task handlers */
 osThreadId initTaskHandle;
 osThreadDef(initThread, initTask, osPriorityRealtime, 1,
 		3*configMINIMAL_STACK_SIZE);
 
+osThreadId loggerTaskHandle;
+osThreadDef(loggerThread, loggerTask, osPriorityLow, 1,
+		2*configMINIMAL_STACK_SIZE);
+
+osThreadId configStorageTaskHandle;
+osThreadDef(configStorageThread, configStorageTask, osPriorityLow, 1,
+		3*configMINIMAL_STACK_SIZE);
+
 #ifdef LCD_PRINTER_SUPPORT
 osThreadId lcdTaskHandle;
-osThreadDef(lcdThread, lcdTask, osPriorityNormal, 1, configMINIMAL_STACK_SIZE);
+osThreadDef(lcdThread, lcdTask, osPriorityNormal, 1,
+		2*configMINIMAL_STACK_SIZE);
 #endif
 
 osThreadId samplingTaskHandle;
@@ -59,6 +80,10 @@ osThreadId httpConfigTaskHandle;
 osThreadDef(httpConfigThread, httpConfigTask, osPriorityHigh, 1,
 		35*configMINIMAL_STACK_SIZE);
 
+osThreadId webSocketTaskHandle;
+osThreadDef(webSocketThread, webSocketTask, osPriorityBelowNormal, 1,
+		4*configMINIMAL_STACK_SIZE);
+
 osThreadId ethernetTaskHandle;
 osThreadDef(ethernetThread, ethernetTask, osPriorityNormal, 1,
 		5*configMINIMAL_STACK_SIZE);
@@ -77,13 +102,15 @@ osPoolId cfftPool_id;
 osPoolDef(soundProcessingBufferPool, 1,
 		float32_t[MAIN_SOUND_BUFFER_MAX_BUFFER_SIZE]);
 osPoolId soundProcessingBufferPool_id;
-osPoolDef(stmConfigBufferPool, 1, StmConfig);
-osPoolId stmConfigBufferPool_id;
 
 /* Mail queue handler */
 osMailQDef(dmaAudioMail_q, MAXIMUM_DMA_AUDIO_MESSAGE_QUEUE_SIZE, SoundMailStr);
 osMailQId dmaAudioMail_q_id;
 
+/* Message queue handler */
+osMessageQDef(webSocketClient_q, WEBSOCKET_MAX_CLIENTS, struct netconn*);
+osMessageQId webSocketClient_q_id;
+
 /* Mutex handlers */
 osMutexDef(mainSpectrumBufferMutex);
 osMutexId mainSpectrumBufferMutex_id;
@@ -113,6 +140,9 @@ void threadsInit() {
 void initTask(void const * argument) {
 	/* PERIPHERALS INITIALIZATION */
 	lcdInit();
+	loggerTaskHandle = osThreadCreate(osThread(loggerThread), NULL);
+	if (loggerTaskHandle == NULL)
+		printNullHandle("Logger task");
 	logMsg("Ethernet initialization...");
 	MX_LWIP_Init();
 
@@ -139,14 +169,14 @@ void initTask(void const * argument) {
 	soundBufferPool_id = osPoolCreate(osPool(soundBufferPool));
 	if (soundBufferPool_id == NULL)
 		printNullHandle("Sound pool");
-	stmConfigBufferPool_id = osPoolCreate(osPool(stmConfigBufferPool));
-	if (stmConfigBufferPool_id == NULL)
-		printNullHandle("Stm config pool");
 
 	logMsg("Initializing mail queues");
 	dmaAudioMail_q_id = osMailCreate(osMailQ(dmaAudioMail_q), NULL);
 	if (dmaAudioMail_q_id == NULL)
 		printNullHandle("Audio mail q");
+	webSocketClient_q_id = osMessageCreate(osMessageQ(webSocketClient_q), NULL);
+	if (webSocketClient_q_id == NULL)
+		printNullHandle("WebSocket q");
 
 	logMsg("Initializing mutexes");
 	mainSpectrumBufferMutex_id = osMutexCreate(
@@ -160,19 +190,38 @@ void initTask(void const * argument) {
 	if (ethernetInterfaceMutex_id == NULL)
 		printNullHandle("Eth mut");
 
+	// names of mutexes and queues sent with the trace
+	vQueueAddToRegistry(mainSpectrumBufferMutex_id, "SpectrumMutex");
+	vQueueAddToRegistry(mainSoundBufferMutex_id, "SoundMutex");
+	vQueueAddToRegistry(ethernetInterfaceMutex_id, "EthernetMutex");
+	vQueueAddToRegistry(webSocketClient_q_id, "WebSocketQueue");
+
 	/* Global variables */
 	logMsg("Preparing global variables");
-	configStr = osPoolCAlloc(stmConfigBufferPool_id);
-	configStr->amplitudeSamplingDelay = CONNECTION_TASK_DELAY_TIME;
-	configStr->audioSamplingFrequency = AUDIO_RECORDER_DEFAULT_FREQUENCY;
-	configStr->clientPort = UDP_STREAMING_PORT;
-	strcpy(configStr->clientIp, UDP_STREAMING_IP);
-	configStr->windowType = RECTANGLE;
+	StmConfig defaultConfig;
+	memset(&defaultConfig, 0, sizeof(StmConfig));
+	defaultConfig.amplitudeSamplingDelay = CONNECTION_TASK_DELAY_TIME;
+	defaultConfig.audioSamplingFrequency = AUDIO_RECORDER_DEFAULT_FREQUENCY;
+	defaultConfig.clientPort = UDP_STREAMING_PORT;
+	strcpy(defaultConfig.clientIp, UDP_STREAMING_IP);
+	defaultConfig.windowType = RECTANGLE;
+	defaultConfig.lcdView = LCD_VIEW_SPECTRUM;
+	strcpy(defaultConfig.syslogIp, SYSLOG_DISABLED_IP);
+	defaultConfig.syslogPort = SYSLOG_DEFAULT_PORT;
+	defaultConfig.streamContent = STREAM_CONTENT_SPECTRUM;
+	defaultConfig.leqPeriod = LEVEL_METER_DEFAULT_LEQ_PERIOD;
+	defaultConfig.spectrumScale = SPECTRUM_SCALE_LINEAR;
+	configStorageLoad(&defaultConfig);
+	configSnapshotInit(&configSnapshot, &defaultConfig);
+	levelMeterInit(defaultConfig.leqPeriod);
+	syslogSinkInit(ipaddr_ntoa(&ethernetInterfaceHandler.ip_addr));
 
 	mainSpectrumBuffer = osPoolCAlloc(spectrumBufferPool_id);
+	spectrumSnapshotInit(&mainSpectrumSnapshot, mainSpectrumBuffer);
 	mainSoundBuffer = osPoolCAlloc(soundBufferPool_id);
 	mainSoundBuffer->iterator = 0;
-	mainSoundBuffer->frequency = AUDIO_RECORDER_DEFAULT_FREQUENCY;
+	mainSoundBuffer->filled = 0;
+	mainSoundBuffer->frequency = defaultConfig.audioSamplingFrequency;
 	mainSoundBuffer->size = MAIN_SOUND_BUFFER_MAX_BUFFER_SIZE;
 	for (uint32_t i = 0; i < mainSoundBuffer->size; i++) {
 		mainSoundBuffer->soundBuffer[i] = 0;
@@ -197,11 +246,18 @@ void initTask(void const * argument) {
 	httpConfigTaskHandle = osThreadCreate(osThread(httpConfigThread), NULL);
 	if (httpConfigTaskHandle == NULL)
 		printNullHandle("HTTP task");
+	webSocketTaskHandle = osThreadCreate(osThread(webSocketThread), NULL);
+	if (webSocketTaskHandle == NULL)
+		printNullHandle("WebSocket task");
+	configStorageTaskHandle = osThreadCreate(osThread(configStorageThread),
+	NULL);
+	if (configStorageTaskHandle == NULL)
+		printNullHandle("Storage task");
 
 	logMsg("Preparing audio recording");
 	if (audioRecorderInit(AUDIO_RECORDER_INPUT_MICROPHONE,
 	AUDIO_RECORDER_VOLUME_0DB,
-	AUDIO_RECORDER_DEFAULT_FREQUENCY) != AUDIO_RECORDER_OK) {
+	defaultConfig.audioSamplingFrequency) != AUDIO_RECORDER_OK) {
 		logErr("Audio rec init");
 	}
 
@@ -215,6 +271,60 @@ void initTask(void const * argument) {
 	osThreadTerminate(initTaskHandle);
 }
 
+/**
+ * @brief Low priority task which displays the log records (logging functions only put
+ * the records to the queue, so they do not draw in real-time tasks and interrupts)
+ * and sends them to the syslog collector
+ */
+void loggerTask(void const * argument) {
+	StmConfig loggerConfig;
+	uint32_t configVersion = 0;
+	osStatus status;
+
+	while (1) {
+		logProcess();
+
+		// the sink is initialized by the init task together with the configuration
+		if (syslogSinkIsReady()) {
+			if (configSnapshotGetVersion(&configSnapshot) != configVersion)
+				configVersion = configSnapshotRead(&configSnapshot,
+						&loggerConfig);
+
+			// sending errors are only counted (logging them would make new records)
+			while (syslogSinkCollect(loggerConfig.syslogIp,
+					loggerConfig.syslogPort)) {
+				status = osMutexWait(ethernetInterfaceMutex_id, osWaitForever);
+				if (status == osOK) {
+					syslogSinkSend(loggerConfig.syslogIp,
+							loggerConfig.syslogPort);
+					osMutexRelease(ethernetInterfaceMutex_id);
+				} else
+					break;
+			}
+		}
+		osDelay(LOGGER_TASK_DELAY_TIME);
+	}
+}
+
+/**
+ * @brief Low priority task which writes the published configuration versions to the flash log
+ * and erases its standby sector in advance. The flash operations stall the CPU, so they are not
+ * done by the HTTP task which answers the clients.
+ */
+void configStorageTask(void const* argument) {
+	StmConfig storedConfig;
+	uint32_t storedVersion = configSnapshotGetVersion(&configSnapshot);
+
+	while (1) {
+		if (configSnapshotGetVersion(&configSnapshot) != storedVersion) {
+			storedVersion = configSnapshotRead(&configSnapshot, &storedConfig);
+			configStorageSave(&storedConfig);
+		}
+		configStorageProcess();
+		osDelay(CONFIG_STORAGE_TASK_DELAY_TIME);
+	}
+}
+
 /**
  * @brief DHCP initialization task
  */
@@ -260,7 +370,11 @@ void ethernetTask(void const * argument) {
 void audioRecorder_FullBufferFilled(void) {
 	SoundMailStr *soundSamples;
 	osStatus mailStatus;
-	
+
+	// the first buffer after the sampling rate change holds samples of both rates
+	if (audioRecorderIsRateBoundary())
+		return;
+
 	// allocating memory for sound mail
 	soundSamples = osMailAlloc(dmaAudioMail_q_id, 0);
 	
@@ -270,7 +384,7 @@ void audioRecorder_FullBufferFilled(void) {
 	}
 	else
 	{
-		audioRecordingSoundMailFill(soundSamples, dmaAudioBuffer, AUDIO_BUFFER_SIZE, configStr->audioSamplingFrequency);
+		audioRecordingSoundMailFill(soundSamples, dmaAudioBuffer, AUDIO_BUFFER_SIZE, audioRecorderGetSamplingFrequency());
 
 		// sending mail to queue
 		mailStatus = osMailPut(dmaAudioMail_q_id, soundSamples);
@@ -282,21 +396,40 @@ void audioRecorder_FullBufferFilled(void) {
 }
 
 /**
- * @brief Asynchronous task which gets audio mails from queue and fills the mainSoundBuffer
+ * @brief Asynchronous task which gets audio mails from queue, updates the level meter
+ * and fills the mainSoundBuffer
  */
 void samplingTask(void const * argument) {
+	StmConfig samplingConfig;
+	uint32_t configVersion;
+
+	configVersion = configSnapshotRead(&configSnapshot, &samplingConfig);
+
 	while (1) {
 		// waiting for new mail
 		osEvent event = osMailGet(dmaAudioMail_q_id, osWaitForever);
 		if (event.status == osEventMail) {
 			SoundMailStr *receivedSound = (SoundMailStr *) event.value.p;
 
+			// taking the new Leq period only if the configuration was changed
+			if (configSnapshotGetVersion(&configSnapshot) != configVersion) {
+				configVersion = configSnapshotRead(&configSnapshot,
+						&samplingConfig);
+				levelMeterSetLeqPeriod(samplingConfig.leqPeriod);
+			}
+
+			// metering every DMA buffer (also when FFT frames are skipped)
+			levelMeterProcess(receivedSound->soundBuffer,
+					receivedSound->soundBufferSize, receivedSound->frequency);
+
 			// waiting for access to mailSoundBuffer
 			osStatus status = osMutexWait(mainSoundBufferMutex_id,
 			osWaitForever);
 			if (status == osOK) {
 				// filling cyclic buffer
 				audioRecordingUpdateSoundBuffer(mainSoundBuffer, receivedSound);
+				pipelineStatsRecordAge(PIPELINE_STAGE_CAPTURE,
+						receivedSound->timestamp);
 
 				// releasing mutex
 				status = osMutexRelease(mainSoundBufferMutex_id);
@@ -324,6 +457,7 @@ void soundProcessingTask(void const * argument) {
 	arm_cfft_instance_f32* cfftInstance;
 	osStatus status;
 	osEvent event;
+	uint64_t stageStart;
 
 	// allocating memory for temporary spectrum buffer
 	temporarySpectrumBufferStr = osPoolCAlloc(spectrumBufferPool_id);
@@ -339,6 +473,16 @@ void soundProcessingTask(void const * argument) {
 			status = osMutexWait(mainSoundBufferMutex_id, osWaitForever);
 			if (status == osOK) {
 
+				// spectrum is not computed until the buffer holds only samples of the current rate
+				if (mainSoundBuffer->filled < mainSoundBuffer->size) {
+					status = osMutexRelease(mainSoundBufferMutex_id);
+					if (status != osOK) {
+						logErrVal("Sampling mutex (sound processing) release",
+								status);
+					}
+					continue;
+				}
+
 				// getting FFT instance
 				soundProcessingGetCfftInstance(cfftInstance,
 						mainSoundBuffer->size / 2);
@@ -347,8 +491,11 @@ void soundProcessingTask(void const * argument) {
 					float32_t temporaryAudioBuffer[MAIN_SOUND_BUFFER_MAX_BUFFER_SIZE];
 
 					// spectrum buffer initialization and sound buffer copying
+					stageStart = timeBaseGetCycles();
 					soundProcessingAmplitudeInit(temporarySpectrumBufferStr,
 							mainSoundBuffer, temporaryAudioBuffer);
+					stageStart = pipelineStatsRecordSince(PIPELINE_STAGE_COPY,
+							stageStart);
 
 					// get length
 					uint32_t length = mainSoundBuffer->size;
@@ -360,11 +507,58 @@ void soundProcessingTask(void const * argument) {
 								status);
 					}
 
-					soundProcessingProcessWindow(configStr->windowType, temporaryAudioBuffer, length);
+					const StmConfigVersionStr* config = configSnapshotAcquire(
+							&configSnapshot);
+					WindowType windowType = config->config.windowType;
+					SpectrumScaleType scale = config->config.spectrumScale;
+					configSnapshotRelease(config);
+
+					stageStart = timeBaseGetCycles();
+					soundProcessingProcessWindow(windowType, temporaryAudioBuffer, length);
+					stageStart = pipelineStatsRecordSince(PIPELINE_STAGE_WINDOW,
+							stageStart);
 
 					// calculating spectrum
-					soundProcessingGetAmplitudeInstance(cfftInstance,
+					soundProcessingTransform(cfftInstance, temporaryAudioBuffer);
+					stageStart = pipelineStatsRecordSince(PIPELINE_STAGE_FFT,
+							stageStart);
+					// squared magnitudes are used by the analysis stages (no square root per bin)
+					soundProcessingGetPower(cfftInstance,
 							temporarySpectrumBufferStr, temporaryAudioBuffer);
+					stageStart = pipelineStatsRecordSince(
+							PIPELINE_STAGE_MAGNITUDE, stageStart);
+
+					// finding peaks and harmonics (published with the spectrum)
+					peakAnalysisProcess(
+							temporarySpectrumBufferStr->amplitudeVector,
+							temporarySpectrumBufferStr->vectorSize,
+							temporarySpectrumBufferStr->frequencyResolution,
+							windowType, &temporarySpectrumBufferStr->analysis);
+					stageStart = pipelineStatsRecordSince(
+							PIPELINE_STAGE_ANALYSIS, stageStart);
+
+					// 1/3-octave and octave band levels (published with the spectrum)
+					bandAnalysisProcess(
+							temporarySpectrumBufferStr->amplitudeVector,
+							temporarySpectrumBufferStr->vectorSize,
+							temporarySpectrumBufferStr->frequencyResolution,
+							&temporarySpectrumBufferStr->bands);
+					stageStart = pipelineStatsRecordSince(PIPELINE_STAGE_BANDS,
+							stageStart);
+
+					// mel filterbank energies and MFCCs (published with the spectrum)
+					mfccAnalysisProcess(
+							temporarySpectrumBufferStr->amplitudeVector,
+							temporarySpectrumBufferStr->vectorSize,
+							temporarySpectrumBufferStr->frequencyResolution,
+							&temporarySpectrumBufferStr->features);
+					stageStart = pipelineStatsRecordSince(
+							PIPELINE_STAGE_FEATURES, stageStart);
+
+					// published bins in the configured scale
+					soundProcessingApplyScale(temporarySpectrumBufferStr, scale);
+					stageStart = pipelineStatsRecordSince(PIPELINE_STAGE_SCALE,
+							stageStart);
 
 					// waiting for access to main spectrum buffer
 					status = osMutexWait(mainSpectrumBufferMutex_id,
@@ -372,14 +566,23 @@ void soundProcessingTask(void const * argument) {
 					if (status == osOK) {
 
 						// copying spectrum from temporary buffer to main buffer
-						soundProcessingCopyAmplitudeInstance(
-								temporarySpectrumBufferStr, mainSpectrumBuffer);
+						spectrumSnapshotPublish(&mainSpectrumSnapshot,
+								temporarySpectrumBufferStr);
+						pipelineStatsRecordSince(PIPELINE_STAGE_PUBLISH,
+								stageStart);
+						pipelineStatsRecordAge(PIPELINE_STAGE_CAPTURE_TO_PUBLISH,
+								temporarySpectrumBufferStr->timestamp);
 
 						// releasing main spectrum buffer mutex
 						status = osMutexRelease(mainSpectrumBufferMutex_id);
 						if (status != osOK) {
 							logErrVal("Shared amp mutex released", status);
 						}
+
+						// notifying WebSocket task (it never blocks processing)
+						if (webSocketTaskHandle != NULL)
+							osSignalSet(webSocketTaskHandle,
+							WEBSOCKET_FRAME_READY_SIGNAL);
 					} else {
 						logErrVal("Shared amp mutex wait", status);
 					}
@@ -404,16 +607,42 @@ void soundProcessingTask(void const * argument) {
 
 #ifdef LCD_PRINTER_SUPPORT
 void lcdTask(void const * argument) {
+	StmConfig lcdConfig;
+	uint32_t configVersion = 0;
+	uint32_t lcdView = LCD_VIEW_UNDEFINED;
+	uint8_t printed;
+
 	while (1) {
-		osDelay(LCD_TASK_DELAY_TIME);
-		osStatus status = osMutexWait(mainSpectrumBufferMutex_id, osWaitForever);
-		if (status == osOK) {
-			lcdAmpPrinterPrint(&mainSpectrumBuffer);
-			status = osMutexRelease(mainSpectrumBufferMutex_id);
-			if (status != osOK) {
-				logErrVal("lcdFrequencyMutex release", status);
+		// DMA2D is taken for the whole frame (the logger task clears its layer with it)
+		lcdFrameBufferLockDma2d();
+
+		// the view is changed only if the configuration was changed
+		if (configSnapshotGetVersion(&configSnapshot) != configVersion) {
+			configVersion = configSnapshotRead(&configSnapshot, &lcdConfig);
+			if (lcdConfig.lcdView != lcdView) {
+				lcdView = lcdConfig.lcdView;
+				if (lcdView == LCD_VIEW_WATERFALL)
+					lcdWaterfallInit();
+				else
+					lcdAmpPrinterInit();
 			}
 		}
+
+		// the new spectrum is drawn in the hidden framebuffer and shown at the vertical blanking
+		// (the spectrum is copied without taking mainSpectrumBufferMutex)
+		if (lcdView == LCD_VIEW_WATERFALL)
+			printed = lcdWaterfallPrint(&mainSpectrumSnapshot,
+					lcdFrameBufferGetBackIndex());
+		else
+			printed = lcdAmpPrinterPrint(&mainSpectrumSnapshot,
+					lcdFrameBufferGetBackIndex());
+		lcdFrameBufferUnlockDma2d();
+
+		if (printed) {
+			if (!lcdFrameBufferSwap())
+				logErr("LCD swap timeout");
+		} else
+			osDelay(LCD_TASK_DELAY_TIME);
 	}
 }
 #endif
@@ -423,8 +652,18 @@ void lcdTask(void const * argument) {
  */
 void streamingTask(void const * argument) {
 	struct netconn *udpStreamingSocket = NULL;
+	struct netbuf *udpStreamingBuffer = NULL;
+	UdpConnectionStr udpConnection;
+	StmConfig streamingConfig;
+	uint32_t configVersion;
 	err_t status;
 	err_t netErr;
+	uint64_t sendStart;
+	uint32_t sentBytes;
+
+	udpConnection.connected = 0;
+	configVersion = configSnapshotRead(&configSnapshot, &streamingConfig);
+	udpStreamingStatsInit(&udpStreamingStats);
 
 	// creating UDP socket
 	udpStreamingSocket = netconn_new(NETCONN_UDP);
@@ -433,6 +672,11 @@ void streamingTask(void const * argument) {
 	else
 		udpStreamingSocket->recv_timeout = 1;
 
+	// allocating netbuf reused for every datagram
+	udpStreamingBuffer = netbuf_new();
+	if (udpStreamingBuffer == NULL)
+		printNullHandle("UDP netbuf");
+
 	// binding socket to ethernet interface on UDP_STREAMING_PORT
 	status = netconn_bind(udpStreamingSocket, &ethernetInterfaceHandler.ip_addr,
 	UDP_STREAMING_PORT);
@@ -443,7 +687,12 @@ void streamingTask(void const * argument) {
 		// setting signal to start sound processing
 		status = osSignalSet(soundProcessingTaskHandle,
 		START_SOUND_PROCESSING_SIGNAL);
-		osDelay(configStr->amplitudeSamplingDelay);
+		osDelay(streamingConfig.amplitudeSamplingDelay);
+
+		// taking the new configuration only if it was changed
+		if (configSnapshotGetVersion(&configSnapshot) != configVersion)
+			configVersion = configSnapshotRead(&configSnapshot,
+					&streamingConfig);
 
 		// waiting for acces to ethernet interface
 		osStatus status = osMutexWait(ethernetInterfaceMutex_id, osWaitForever);
@@ -454,19 +703,33 @@ void streamingTask(void const * argument) {
 			osWaitForever);
 			if (status == osOK) {
 
-				// "connecting" to UDP
-				int ipTab[4];
-				ip_addr_t addr;
-				sscanf(configStr->clientIp, "%d.%d.%d.%d", &ipTab[0], &ipTab[1],
-						&ipTab[2], &ipTab[3]);
-				IP_ADDR4(&addr, ipTab[0], ipTab[1], ipTab[2], ipTab[3]);
-				netErr = netconn_connect(udpStreamingSocket, &addr,
-						configStr->clientPort);
+				// "connecting" to UDP (only if the address was changed)
+				netErr = udpConnectIfChanged(udpStreamingSocket, &udpConnection,
+						streamingConfig.clientIp, streamingConfig.clientPort);
 				if (netErr)
 					logErrVal("UDP connect", netErr);
 
-				// sending main spectrum buffer by UDP
-				netErr = sendSpectrum(mainSpectrumBuffer, udpStreamingSocket);
+				// sending main spectrum buffer (or only its band levels or features) by UDP
+				sendStart = timeBaseGetCycles();
+				if (streamingConfig.streamContent == STREAM_CONTENT_BANDS) {
+					netErr = sendBands(mainSpectrumBuffer, udpStreamingSocket,
+							udpStreamingBuffer);
+					sentBytes = sizeof(BandLevelsStr);
+				} else if (streamingConfig.streamContent
+						== STREAM_CONTENT_MFCC) {
+					netErr = sendFeatures(mainSpectrumBuffer,
+							udpStreamingSocket, udpStreamingBuffer);
+					sentBytes = sizeof(MfccFeaturesStr);
+				} else {
+					netErr = sendSpectrum(mainSpectrumBuffer,
+							udpStreamingSocket, udpStreamingBuffer);
+					sentBytes = ETHERNET_AMP_BUFFER_SIZE * sizeof(float32_t);
+				}
+				pipelineStatsRecordSince(PIPELINE_STAGE_SEND, sendStart);
+				if (netErr == ERR_OK)
+					pipelineStatsRecordAge(PIPELINE_STAGE_CAPTURE_TO_SEND,
+							mainSpectrumBuffer->timestamp);
+				udpStreamingStatsUpdate(&udpStreamingStats, netErr, sentBytes);
 				if (netErr)
 					logErrVal("UDP write", netErr);
 
@@ -491,6 +754,7 @@ void streamingTask(void const * argument) {
  */
 void httpConfigTask(void const* argument) {
 	struct netconn *httpServer = NULL;
+	HttpRequestStr request;
 
 	// creating TCP server
 	httpServer = netconn_new(NETCONN_TCP);
@@ -515,107 +779,58 @@ void httpConfigTask(void const* argument) {
 		//logMsg("HTTP task");
 
 		// waiting for acces to ethernet interface
+		struct netconn *newClient = NULL;
 		osStatus status = osMutexWait(ethernetInterfaceMutex_id, osWaitForever);
 		if (status == osOK) {
-			struct netconn *newClient = NULL;
-
 			// accepting incoming client
 			netStatus = netconn_accept(httpServer, &newClient);
-			if (netStatus == ERR_OK) {
-				// if there is a client
-
-				struct netbuf* recvBuf;
-				newClient->recv_timeout = HTTP_RECEIVE_TIMEOUT;
-
-				// receiving data from client
-				err_t netStatus = netconn_recv(newClient, &recvBuf);
-				if (netStatus == ERR_OK) {
-					char data[512];
-					getDataFromBuffer(data, recvBuf);
-
-					// encoding HTTP request type
-					uint16_t requestType = getRequestType(data);
-
-					switch (requestType) {
-					case GET_REQUEST: {
-						logMsg("GET request");
-						if (isConfigRequest(data)) {
-							// if it is GET config request
-							logMsg("Config request");
-							sendConfiguration(configStr, newClient,
-									"\r\nConnection: Closed");
-						} else if (isSystemRequest(data)) {
-							// if it is GET config request
-							logMsg("System request");
-
-							char systemDetails[512];
-							getTaskUsageDetails(systemDetails);
-							sendHttpResponse(newClient, "200 OK",
-									"\r\nConnection: Closed", systemDetails);
-						} else {
-							sendHttpResponse(newClient, "404 Not Found",
-									"\r\nContent-Type: text/html",
-									"<h1>404 Not Found</h1>");
-							logErr("Not supported request");
-						}
-						break;
-					}
-					case PUT_REQUEST: {
-						logMsg("PUT request");
-						if (isConfigRequest(data)) {
-							logMsg("Config request");
-
-							//sendHttpResponse(newClient, "200 OK", "", "");
-							netbuf_delete(recvBuf);
-
-							// receiving JSON data
-							err_t netStatus = netconn_recv(newClient, &recvBuf);
-							if (netStatus == ERR_OK) {
-								StmConfig tempConfig;
-								char data[512];
-
-								getDataFromBuffer(data, recvBuf);
-
-								// parsing JSON data to config structure
-								parseJSON(data, &tempConfig);
-								makeChanges(&tempConfig, configStr);
-
-								sendConfiguration(configStr, newClient,
-										"\r\nConnection: Closed");
-							} else {
-								logErr("No PUT data");
-							}
-						} else {
-							sendHttpResponse(newClient, "404 Not Found",
-									"\r\nContent-Type: text/html",
-									"<h1>404 Not Found</h1>");
-							logErr("Not supported request");
-						}
-						break;
-					}
-					default: {
-						sendHttpResponse(newClient, "501 Not Implemented",
-								"\r\nContent-Type: text/html",
-								"<h1>501 Not Implemented</h1>");
-						logErr("Not implemented method");
-						break;
-					}
-					}
 
-					// deleting socket buffer
-					netbuf_delete(recvBuf);
-				} else
-					logErrVal("TCP no data", netStatus);
+			// releasing ethernet interface mutex (the request and response go without it,
+			// lwIP calls are serialized by the stack itself)
+			status = osMutexRelease(ethernetInterfaceMutex_id);
+			if (netStatus != ERR_OK)
+				continue;
+		} else {
+			continue;
+		}
 
-				// closing connection
-				netStatus = netconn_close(newClient);
+		// if there is a client, receiving request (slow client does not block the other tasks)
+		newClient->recv_timeout = HTTP_RECEIVE_TIMEOUT;
+		newClient->send_timeout = HTTP_SEND_TIMEOUT;
+		HttpParseStatus parseStatus = httpServerReceiveRequest(&request,
+				newClient);
 
-				// free client memory
-				netStatus = netconn_delete(newClient);
-			}
+		// sending response (client which does not read is dropped after the send timeout)
+		if (parseStatus == HTTP_PARSE_INCOMPLETE
+				|| !httpServerRespond(&request, newClient)) {
+			// closing connection
+			netStatus = netconn_close(newClient);
+
+			// free client memory
+			netStatus = netconn_delete(newClient);
+		}
+	}
+}
+
+/**
+ * @brief Spectrum push to WebSocket clients (wakes up after every calculated spectrum)
+ */
+void webSocketTask(void const* argument) {
+	osEvent event;
+
+	while (1) {
+		// waiting for new spectrum (or poll time)
+		event = osSignalWait(WEBSOCKET_FRAME_READY_SIGNAL, WEBSOCKET_POLL_TIME);
+
+		// waiting for acces to ethernet interface
+		osStatus status = osMutexWait(ethernetInterfaceMutex_id, osWaitForever);
+		if (status == osOK) {
+			webSocketServerProcess(event.status == osEventSignal);
 
 			// releasing ethernet interface mutex
 			status = osMutexRelease(ethernetInterfaceMutex_id);
+			if (status != osOK)
+				logErrVal("WebSocket eth mut release", status);
 		}
 	}
 }
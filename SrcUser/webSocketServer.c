@@ -0,0 +1,469 @@
+/*
+ * webSocketServer.c
+ *
+ *  Created on: 18 paz 2026
+ */
+
+#include "webSocketServer.h"
+
+/**
+ * @var osMessageQId webSocketClient_q_id
+ * @brief Queue of the connections upgraded by the HTTP task
+ */
+extern osMessageQId webSocketClient_q_id;
+
+/**
+ * @var SpectrumSnapshotStr mainSpectrumSnapshot
+ * @brief Lock-free access to the last calculated spectrum
+ */
+extern SpectrumSnapshotStr mainSpectrumSnapshot;
+
+/**
+ * @var WebSocketClientStr webSocketClients[]
+ * @brief Connected clients (used only by the WebSocket task)
+ */
+static WebSocketClientStr webSocketClients[WEBSOCKET_MAX_CLIENTS];
+
+/**
+ * @var WebSocketSpectrumFrameStr spectrumFrame
+ * @brief Spectrum frame shared by all clients (lwIP copies it to the send buffers)
+ */
+static WebSocketSpectrumFrameStr spectrumFrame;
+
+/**
+ * @var uint32_t passedClients
+ * @brief Number of clients passed by the HTTP task (written only by the HTTP task)
+ */
+static volatile uint32_t passedClients = 0;
+
+/**
+ * @var uint32_t adoptedClients
+ * @brief Number of passed clients taken over (or rejected) by the WebSocket task (written only
+ * by the WebSocket task). The difference to \ref passedClients is the number of clients waiting
+ * in the queue; each counter has one writer, so no read-modify-write races between the tasks.
+ */
+static volatile uint32_t adoptedClients = 0;
+
+/**
+ * @var char base64Alphabet[]
+ * @brief Base64 encoding alphabet
+ */
+static const char base64Alphabet[] =
+		"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/**
+ * @brief Rotates 32 bit word left
+ */
+#define SHA1_ROTATE(value, bits) (((value) << (bits)) | ((value) >> (32 - (bits))))
+
+/**
+ * @brief Processes one 64 byte block of SHA-1
+ * @param state: hash state (5 words)
+ * @param block: 64 byte block
+ */
+static void sha1ProcessBlock(uint32_t* state, const uint8_t* block) {
+	uint32_t w[80];
+	uint32_t a, b, c, d, e, f, k, temp;
+	uint32_t i;
+
+	for (i = 0; i < 16; i++)
+		w[i] = ((uint32_t) block[4 * i] << 24)
+				| ((uint32_t) block[4 * i + 1] << 16)
+				| ((uint32_t) block[4 * i + 2] << 8) | block[4 * i + 3];
+	for (i = 16; i < 80; i++)
+		w[i] = SHA1_ROTATE(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+	a = state[0];
+	b = state[1];
+	c = state[2];
+	d = state[3];
+	e = state[4];
+
+	for (i = 0; i < 80; i++) {
+		if (i < 20) {
+			f = (b & c) | (~b & d);
+			k = 0x5A827999;
+		} else if (i < 40) {
+			f = b ^ c ^ d;
+			k = 0x6ED9EBA1;
+		} else if (i < 60) {
+			f = (b & c) | (b & d) | (c & d);
+			k = 0x8F1BBCDC;
+		} else {
+			f = b ^ c ^ d;
+			k = 0xCA62C1D6;
+		}
+		temp = SHA1_ROTATE(a, 5) + f + e + k + w[i];
+		e = d;
+		d = c;
+		c = SHA1_ROTATE(b, 30);
+		b = a;
+		a = temp;
+	}
+
+	state[0] += a;
+	state[1] += b;
+	state[2] += c;
+	state[3] += d;
+	state[4] += e;
+}
+
+/**
+ * @brief Calculates SHA-1 of the data
+ * @param data: input data
+ * @param length: data length
+ * @param digest: output (20 bytes)
+ */
+static void sha1(const uint8_t* data, uint32_t length, uint8_t* digest) {
+	uint32_t state[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476,
+			0xC3D2E1F0 };
+	uint8_t block[64];
+	uint32_t processed = 0;
+	uint32_t rest;
+	uint32_t i;
+
+	while (length - processed >= 64) {
+		sha1ProcessBlock(state, &data[processed]);
+		processed += 64;
+	}
+
+	// padding: 0x80, zeros and message length in bits (big endian)
+	rest = length - processed;
+	memset(block, 0, sizeof(block));
+	memcpy(block, &data[processed], rest);
+	block[rest] = 0x80;
+	if (rest >= 56) {
+		sha1ProcessBlock(state, block);
+		memset(block, 0, sizeof(block));
+	}
+	for (i = 0; i < 4; i++)
+		block[63 - i] = (uint8_t) ((length * 8) >> (8 * i));
+	block[59] = (uint8_t) (length >> 29);
+	sha1ProcessBlock(state, block);
+
+	for (i = 0; i < 20; i++)
+		digest[i] = (uint8_t) (state[i / 4] >> (24 - 8 * (i % 4)));
+}
+
+/**
+ * @brief Encodes data using base64
+ * @param data: input data
+ * @param length: data length
+ * @param output: output text (4 * ((length + 2) / 3) + 1 bytes)
+ */
+static void base64Encode(const uint8_t* data, uint32_t length, char* output) {
+	uint32_t i;
+	uint32_t value;
+
+	for (i = 0; i < length; i += 3) {
+		value = (uint32_t) data[i] << 16;
+		if (i + 1 < length)
+			value |= (uint32_t) data[i + 1] << 8;
+		if (i + 2 < length)
+			value |= data[i + 2];
+
+		*output++ = base64Alphabet[(value >> 18) & 0x3F];
+		*output++ = base64Alphabet[(value >> 12) & 0x3F];
+		*output++ = i + 1 < length ? base64Alphabet[(value >> 6) & 0x3F] : '=';
+		*output++ = i + 2 < length ? base64Alphabet[value & 0x3F] : '=';
+	}
+	*output = '\0';
+}
+
+/**
+ * @brief Calculates the Sec-WebSocket-Accept value: base64(SHA-1(key + GUID))
+ * @param key: Sec-WebSocket-Key sent by the client
+ * @param accept: output text (\ref WEBSOCKET_ACCEPT_KEY_LENGTH + 1 bytes)
+ */
+void webSocketComputeAccept(const char* key, char* accept) {
+	char text[HTTP_REQUEST_MAX_WEBSOCKET_KEY_LENGTH + sizeof(WEBSOCKET_GUID)];
+	uint8_t digest[20];
+
+	strcpy(text, key);
+	strcat(text, WEBSOCKET_GUID);
+	sha1((const uint8_t*) text, strlen(text), digest);
+	base64Encode(digest, sizeof(digest), accept);
+}
+
+/**
+ * @brief Checks if the next client can be accepted (called by the HTTP task)
+ * @retval returns 1 if there is a free slot
+ */
+uint8_t webSocketServerHasFreeSlot() {
+	uint32_t connected = 0;
+	uint32_t i;
+
+	for (i = 0; i < WEBSOCKET_MAX_CLIENTS; i++) {
+		if (webSocketClients[i].conn != NULL)
+			connected++;
+	}
+	// the slot is taken before the client is counted as adopted (counted twice at most)
+	return connected + (passedClients - adoptedClients) < WEBSOCKET_MAX_CLIENTS;
+}
+
+/**
+ * @brief Passes the upgraded connection to the WebSocket task (called by the HTTP task)
+ * @param client: pointer to \ref netconn structure (after 101 Switching Protocols response)
+ * @retval returns 1 if the connection was taken over
+ */
+uint8_t webSocketServerAddClient(struct netconn* client) {
+	if (webSocketClient_q_id == NULL) {
+		printNullHandle("WebSocket client queue");
+		return 0;
+	}
+
+	if (osMessagePut(webSocketClient_q_id, (uint32_t) (uintptr_t) client, 0) != osOK)
+		return 0;
+	passedClients++;
+	return 1;
+}
+
+/**
+ * @brief Closes the connection and frees the slot
+ * @param client: pointer to \ref WebSocketClientStr structure
+ */
+static void removeClient(WebSocketClientStr* client) {
+	logMsgVal("WebSocket client removed, dropped frames: ",
+			client->droppedFrames);
+	netconn_close(client->conn);
+	netconn_delete(client->conn);
+	client->conn = NULL;
+}
+
+/**
+ * @brief Adopts the connections passed by the HTTP task
+ */
+static void adoptNewClients() {
+	osEvent event;
+	struct netconn* conn;
+	uint32_t i;
+
+	for (;;) {
+		event = osMessageGet(webSocketClient_q_id, 0);
+		if (event.status != osEventMessage)
+			return;
+		conn = (struct netconn*) (uintptr_t) event.value.v;
+
+		for (i = 0; i < WEBSOCKET_MAX_CLIENTS; i++) {
+			if (webSocketClients[i].conn == NULL)
+				break;
+		}
+		if (i == WEBSOCKET_MAX_CLIENTS) {
+			logErr("No free WebSocket slot");
+			netconn_close(conn);
+			netconn_delete(conn);
+			adoptedClients++;
+			continue;
+		}
+
+		netconn_set_recvtimeout(conn, WEBSOCKET_RECEIVE_TIMEOUT);
+		webSocketClients[i].conn = conn;
+		webSocketClients[i].lastFrameNumber = 0;
+		webSocketClients[i].sentFrames = 0;
+		webSocketClients[i].droppedFrames = 0;
+		webSocketClients[i].pendingOffset = 0;
+		webSocketClients[i].pendingLength = 0;
+		adoptedClients++;
+		logMsg("WebSocket client connected");
+	}
+}
+
+/**
+ * @brief Writes the frame without blocking. The part which did not fit into the send buffer
+ * is kept in the client and sent by \ref flushPendingFrame before any other frame.
+ * @param client: pointer to \ref WebSocketClientStr structure
+ * @param data: frame (header and payload)
+ * @param length: frame length
+ * @param keepUnsent: 1 - keep the frame also if nothing was written (control frames),
+ * 0 - drop it (the next spectrum frame is newer anyway)
+ * @retval returns 1 if the frame was written or kept, 0 if it was dropped or the client was removed
+ */
+static uint8_t writeFrame(WebSocketClientStr* client, const void* data,
+		uint32_t length, uint8_t keepUnsent) {
+	size_t written = 0;
+	err_t netStatus;
+
+	if (client->pendingLength == 0) {
+		netStatus = netconn_write_partly(client->conn, data, length,
+				NETCONN_COPY | NETCONN_DONTBLOCK, &written);
+		if (netStatus != ERR_OK && netStatus != ERR_WOULDBLOCK
+				&& netStatus != ERR_MEM) {
+			logErrVal("WebSocket write error ", netStatus);
+			removeClient(client);
+			return 0;
+		}
+		if (netStatus != ERR_OK)
+			written = 0;
+		if (written == length)
+			return 1;
+		if (written == 0 && !keepUnsent)
+			return 0;
+	} else if (!keepUnsent) {
+		return 0;
+	}
+
+	if (client->pendingLength + length - written > sizeof(client->pending))
+		return 0;
+	memcpy(&client->pending[client->pendingLength],
+			(const uint8_t*) data + written, length - written);
+	client->pendingLength += length - written;
+	return 1;
+}
+
+/**
+ * @brief Sends the rest of the frame which did not fit into the send buffer before
+ * @param client: pointer to \ref WebSocketClientStr structure
+ */
+static void flushPendingFrame(WebSocketClientStr* client) {
+	size_t written = 0;
+	err_t netStatus;
+
+	if (client->pendingLength == 0)
+		return;
+
+	netStatus = netconn_write_partly(client->conn,
+			&client->pending[client->pendingOffset],
+			client->pendingLength - client->pendingOffset,
+			NETCONN_COPY | NETCONN_DONTBLOCK, &written);
+	if (netStatus == ERR_WOULDBLOCK || netStatus == ERR_MEM)
+		return;
+	if (netStatus != ERR_OK) {
+		logErrVal("WebSocket write error ", netStatus);
+		removeClient(client);
+		return;
+	}
+
+	client->pendingOffset += written;
+	if (client->pendingOffset == client->pendingLength) {
+		client->pendingOffset = 0;
+		client->pendingLength = 0;
+	}
+}
+
+/**
+ * @brief Sends the spectrum frame to the client. If the previous frames are still
+ * in the send buffer the frame is dropped (the client always gets the newest spectrum).
+ * @param client: pointer to \ref WebSocketClientStr structure
+ * @param length: frame length
+ */
+static void sendSpectrumFrame(WebSocketClientStr* client, uint32_t length) {
+#if LWIP_TCPIP_CORE_LOCKING
+	struct tcp_pcb* pcb;
+#endif
+	uint8_t congested;
+
+	if (client->lastFrameNumber == spectrumFrame.info.frameNumber)
+		return;
+
+#if LWIP_TCPIP_CORE_LOCKING
+	// the pcb is owned by the tcpip thread (it is freed there when the connection breaks)
+	LOCK_TCPIP_CORE();
+	pcb = client->conn->pcb.tcp;
+	congested = pcb == NULL || client->pendingLength != 0
+			|| tcp_sndqueuelen(pcb) > TCP_SND_QUEUELEN / 2;
+	UNLOCK_TCPIP_CORE();
+#else
+	// LOCK_TCPIP_CORE does nothing here, so the pcb must not be read from this task;
+	// the full send buffer is then seen only by the non-blocking write (rest kept pending)
+	congested = client->pendingLength != 0;
+#endif
+
+	if (congested || !writeFrame(client, &spectrumFrame, length, 0)) {
+		if (client->conn != NULL)
+			client->droppedFrames++;
+		return;
+	}
+	client->lastFrameNumber = spectrumFrame.info.frameNumber;
+	client->sentFrames++;
+}
+
+/**
+ * @brief Receives the control frames sent by the client (ping, close). Data frames are ignored.
+ * @param client: pointer to \ref WebSocketClientStr structure
+ */
+static void pollClient(WebSocketClientStr* client) {
+	struct netbuf* recvBuf;
+	uint8_t frame[WEBSOCKET_CONTROL_FRAME_MAX_SIZE];
+	uint8_t response[2 + WEBSOCKET_CONTROL_FRAME_MAX_SIZE];
+	uint32_t length;
+	uint32_t payloadLength;
+	uint32_t i;
+	uint8_t opcode;
+	err_t netStatus;
+
+	netStatus = netconn_recv(client->conn, &recvBuf);
+	if (netStatus == ERR_TIMEOUT)
+		return;
+	if (netStatus != ERR_OK) {
+		removeClient(client);
+		return;
+	}
+
+	length = netbuf_copy(recvBuf, frame, sizeof(frame));
+	netbuf_delete(recvBuf);
+
+	// client frames are always masked (2 bytes header + 4 bytes mask for control frames)
+	if (length < 6)
+		return;
+	opcode = frame[0] & 0x0F;
+	payloadLength = frame[1] & 0x7F;
+	if (payloadLength > 125 || length < 6 + payloadLength)
+		payloadLength = 0;
+
+	if (opcode == WEBSOCKET_OPCODE_PING) {
+		response[0] = 0x80 | WEBSOCKET_OPCODE_PONG;
+		response[1] = payloadLength;
+		for (i = 0; i < payloadLength; i++)
+			response[2 + i] = frame[6 + i] ^ frame[2 + (i & 3)];
+		if (!writeFrame(client, response, 2 + payloadLength, 1)
+				&& client->conn != NULL)
+			logErr("WebSocket pong dropped");
+	} else if (opcode == WEBSOCKET_OPCODE_CLOSE) {
+		// the close response must not block the task (the client may not read any more);
+		// it is skipped if a frame is half sent, the pending rest is dropped with the client
+		if (client->pendingLength == 0) {
+			response[0] = 0x80 | WEBSOCKET_OPCODE_CLOSE;
+			response[1] = 0;
+			writeFrame(client, response, 2, 0);
+		}
+		if (client->conn != NULL)
+			removeClient(client);
+	}
+}
+
+/**
+ * @brief Serves the WebSocket clients: adopts new connections, pushes the newest spectrum
+ * and answers control frames (called periodically by the WebSocket task)
+ * @param frameReady: 1 if a new spectrum was published
+ */
+void webSocketServerProcess(uint8_t frameReady) {
+	SpectrumSnapshotInfoStr info;
+	uint32_t length = 0;
+	uint32_t i;
+
+	adoptNewClients();
+
+	if (frameReady
+			&& spectrumSnapshotRead(&mainSpectrumSnapshot, spectrumFrame.bins, 0,
+					WEBSOCKET_SPECTRUM_BINS, 1, &info)) {
+		spectrumFrame.info = info;
+		length = sizeof(spectrumFrame.header) + sizeof(SpectrumSnapshotInfoStr)
+				+ info.count * sizeof(float32_t);
+
+		// FIN + binary frame, 16 bit payload length (server frames are not masked)
+		spectrumFrame.header[0] = 0x80 | WEBSOCKET_OPCODE_BINARY;
+		spectrumFrame.header[1] = 126;
+		spectrumFrame.header[2] = (uint8_t) ((length - 4) >> 8);
+		spectrumFrame.header[3] = (uint8_t) (length - 4);
+	}
+
+	for (i = 0; i < WEBSOCKET_MAX_CLIENTS; i++) {
+		if (webSocketClients[i].conn == NULL)
+			continue;
+		flushPendingFrame(&webSocketClients[i]);
+		if (webSocketClients[i].conn != NULL && length > 0)
+			sendSpectrumFrame(&webSocketClients[i], length);
+		if (webSocketClients[i].conn != NULL)
+			pollClient(&webSocketClients[i]);
+	}
+}
@@ -0,0 +1,273 @@
+/*
+ * configStorageSim.c
+ *
+ *  Created on: 18 paz 2026
+ *
+ * Host simulation of the configuration log with power loss fuzzing. The two log sectors
+ * are mapped at their flash address, the flash driver is simulated (programming only clears
+ * bits, erase sets them) and the power is cut at a random word of a random program or erase
+ * operation. An interrupted word gets random bits, an interrupted erase leaves random words.
+ * After every cut the device "reboots" and the loaded configuration must be the last saved
+ * one or the one which was being saved. The storage task order is kept: save the new
+ * version, then pre-erase the standby sector.
+ *
+ * Usage (from the repository root):
+ *   EXTRA_SOURCES="SrcUser/jsonSchemaParser.c" \
+ *   Tools/hostTests/hostTest.sh Tools/hostTests/configStorageSim.c [power cuts] [seed]
+ */
+
+#include "../../SrcUser/configStorage.c"
+#include "../../SrcUser/jsonConfiguration.c"
+#include "stdio.h"
+#include "stdlib.h"
+#include "setjmp.h"
+#include "sys/mman.h"
+
+/**
+ * @brief Simulated flash operation which is interrupted by the power cut
+ */
+typedef enum {
+	SIM_NONE, SIM_SAVE, SIM_ERASE
+} SimOperationType;
+
+static jmp_buf powerCut;
+static SimOperationType operation;
+static StmConfig committed;
+static StmConfig pending;
+static uint8_t hasCommitted;
+static uint32_t saves;
+static uint32_t cuts;
+static uint32_t wordsToPowerCut;
+static uint32_t failureRate;
+static uint32_t programmedWords;
+static uint32_t erasedSectors;
+
+void logMsg(char* msg) {
+}
+
+void logErr(char* msg) {
+}
+
+void logMsgVal(char* msg, int val) {
+}
+
+void logErrVal(char* msg, int val) {
+}
+
+/* makeChanges() dependencies (not used by the simulation) */
+uint8_t audioRecorderSwitchSamplingFrequency(uint32_t frequency) {
+	return 0;
+}
+
+uint8_t audioRecorderSetSamplingFrequency(uint32_t frequency) {
+	return 0;
+}
+
+void levelMeterSetLeqPeriod(uint32_t period) {
+}
+
+/* stmConfigToString() dependencies (not used by the simulation) */
+void jsonWriterInit(JsonWriterStr* writer, char* buffer, uint32_t size) {
+}
+
+void jsonWriterSchemaObject(JsonWriterStr* writer,
+		const JsonSchemaFieldStr* schema, uint32_t fieldCount,
+		const void* source) {
+}
+
+uint8_t jsonWriterFinish(JsonWriterStr* writer) {
+	return 0;
+}
+
+/**
+ * @brief Counts down to the power cut (one step per programmed word or 64 erased bytes)
+ * @retval returns 1 if the power is cut now
+ */
+static uint8_t isPowerCut() {
+	if (wordsToPowerCut == 0)
+		return 0;
+	return --wordsToPowerCut == 0;
+}
+
+uint8_t flashDriverEraseSector(uint32_t sector) {
+	uint32_t* word = (uint32_t*) (uintptr_t) (CONFIG_STORAGE_FIRST_ADDRESS
+			+ (sector - CONFIG_STORAGE_FIRST_SECTOR) * CONFIG_STORAGE_SECTOR_SIZE);
+	uint32_t i;
+
+	for (i = 0; i < CONFIG_STORAGE_SECTOR_SIZE / sizeof(uint32_t); i++) {
+		if (i % 16 == 0 && isPowerCut()) {
+			// the erase is not done in address order, every word may be erased or not
+			for (i = 0; i < CONFIG_STORAGE_SECTOR_SIZE / sizeof(uint32_t); i++) {
+				if (rand() % 2)
+					word[i] |= (uint32_t) rand() | ((uint32_t) rand() << 16);
+			}
+			longjmp(powerCut, 1);
+		}
+	}
+	memset(word, 0xFF, CONFIG_STORAGE_SECTOR_SIZE);
+	erasedSectors++;
+	return 1;
+}
+
+uint8_t flashDriverProgram(uint32_t address, const uint32_t* data,
+		uint32_t words) {
+	uint32_t* destination = (uint32_t*) (uintptr_t) address;
+	uint32_t i;
+
+	for (i = 0; i < words; i++) {
+		if (isPowerCut()) {
+			destination[i] &= data[i]
+					| (uint32_t) rand() | ((uint32_t) rand() << 16);
+			longjmp(powerCut, 1);
+		}
+		// failed programming of one word (verification error)
+		if (failureRate != 0 && rand() % failureRate == 0) {
+			destination[i] &= (uint32_t) rand();
+			return 0;
+		}
+		destination[i] &= data[i];
+		programmedWords++;
+	}
+	return 1;
+}
+
+/**
+ * @brief Sets the default configuration (used when nothing is stored)
+ */
+static void setDefaults(StmConfig* config) {
+	memset(config, 0, sizeof(StmConfig));
+	config->amplitudeSamplingDelay = 10;
+	config->audioSamplingFrequency = 44100;
+	config->clientPort = 53426;
+	strcpy(config->clientIp, "192.168.1.10");
+	config->windowType = RECTANGLE;
+	config->lcdView = LCD_VIEW_SPECTRUM;
+	strcpy(config->syslogIp, "0.0.0.0");
+	config->syslogPort = 514;
+	config->streamContent = STREAM_CONTENT_SPECTRUM;
+	config->leqPeriod = 1000;
+	config->spectrumScale = SPECTRUM_SCALE_LINEAR;
+}
+
+/**
+ * @brief Prepares random configuration accepted by PUT /config
+ */
+static void setRandomConfig(StmConfig* config, uint32_t number) {
+	setDefaults(config);
+	config->amplitudeSamplingDelay = 1 + rand() % 255;
+	config->audioSamplingFrequency = samplingFrequencies[rand()
+			% (sizeof(samplingFrequencies) / sizeof(samplingFrequencies[0]))].value;
+	config->clientPort = 1 + number % 65535;
+	sprintf(config->clientIp, "10.%u.%u.%u", rand() % 256, rand() % 256,
+			rand() % 256);
+	config->windowType = RECTANGLE + rand() % 3;
+	config->lcdView = LCD_VIEW_SPECTRUM + rand() % 2;
+	config->streamContent = STREAM_CONTENT_SPECTRUM + rand() % 3;
+	config->leqPeriod = LEVEL_METER_MIN_LEQ_PERIOD + rand() % 100000;
+	config->spectrumScale = SPECTRUM_SCALE_LINEAR + rand() % 3;
+}
+
+/**
+ * @brief Checks that a record with valid CRC and invalid fields is loaded field by field
+ * @retval returns 1 if the invalid fields kept the default values
+ */
+static uint8_t checkValidation() {
+	ConfigStorageRecordStr record;
+	StmConfig stored;
+	StmConfig loaded;
+	StmConfig defaults;
+
+	memset((void*) CONFIG_STORAGE_FIRST_ADDRESS, 0xFF,
+			CONFIG_STORAGE_SECTOR_COUNT * CONFIG_STORAGE_SECTOR_SIZE);
+	setDefaults(&defaults);
+	setRandomConfig(&stored, 1);
+	stored.spectrumScale = 7;
+	stored.leqPeriod = 0;
+	stored.audioSamplingFrequency = 12345;
+	memset(stored.syslogIp, '1', sizeof(stored.syslogIp));
+
+	memset(&record, 0, sizeof(ConfigStorageRecordStr));
+	record.magic = CONFIG_STORAGE_MAGIC;
+	record.sequence = 1;
+	record.format = CONFIG_STORAGE_FORMAT;
+	record.length = sizeof(StmConfig);
+	memcpy(record.payload, &stored, sizeof(StmConfig));
+	record.crc = crc32((const uint8_t*) &record,
+			offsetof(ConfigStorageRecordStr, crc));
+	memcpy((void*) CONFIG_STORAGE_FIRST_ADDRESS, &record, sizeof(record));
+
+	loaded = defaults;
+	if (!configStorageLoad(&loaded))
+		return 0;
+	return loaded.spectrumScale == defaults.spectrumScale
+			&& loaded.leqPeriod == defaults.leqPeriod
+			&& loaded.audioSamplingFrequency == defaults.audioSamplingFrequency
+			&& strcmp(loaded.syslogIp, defaults.syslogIp) == 0
+			&& loaded.clientPort == stored.clientPort
+			&& strcmp(loaded.clientIp, stored.clientIp) == 0;
+}
+
+int main(int argc, char** argv) {
+	uint32_t powerCuts = argc > 1 ? strtoul(argv[1], NULL, 0) : 2000;
+	uint32_t seed = argc > 2 ? strtoul(argv[2], NULL, 0) : 1;
+	StmConfig loaded;
+	uint8_t loadedStored;
+
+	srand(seed);
+	if (mmap((void*) CONFIG_STORAGE_FIRST_ADDRESS,
+			CONFIG_STORAGE_SECTOR_COUNT * CONFIG_STORAGE_SECTOR_SIZE,
+			PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE,
+			-1, 0) != (void*) CONFIG_STORAGE_FIRST_ADDRESS) {
+		printf("flash address is not available\n");
+		return 1;
+	}
+
+	if (!checkValidation()) {
+		printf("invalid stored fields were loaded\n");
+		return 1;
+	}
+
+	// random content of the new device
+	memset((void*) CONFIG_STORAGE_FIRST_ADDRESS, 0xA5,
+			CONFIG_STORAGE_SECTOR_COUNT * CONFIG_STORAGE_SECTOR_SIZE);
+
+	setjmp(powerCut);
+	while (cuts < powerCuts) {
+		// reboot: the interrupted save may be loaded, otherwise the last saved configuration
+		setDefaults(&loaded);
+		loadedStored = configStorageLoad(&loaded);
+		if (loadedStored && operation == SIM_SAVE
+				&& memcmp(&loaded, &pending, sizeof(StmConfig)) == 0) {
+			committed = pending;
+			hasCommitted = 1;
+		} else if (loadedStored != hasCommitted
+				|| (hasCommitted
+						&& memcmp(&loaded, &committed, sizeof(StmConfig)) != 0)) {
+			printf("wrong configuration loaded after %u saves (cut %u)\n", saves,
+					cuts);
+			return 1;
+		}
+
+		// the next power cut after a random number of flash words (some runs with worn flash)
+		wordsToPowerCut = 1 + rand() % 200000;
+		failureRate = rand() % 4 == 0 ? 40 : 5000;
+		cuts++;
+
+		for (;;) {
+			setRandomConfig(&pending, saves);
+			operation = SIM_SAVE;
+			if (configStorageSave(&pending)) {
+				committed = pending;
+				hasCommitted = 1;
+			}
+			saves++;
+			operation = SIM_ERASE;
+			configStorageProcess();
+			operation = SIM_NONE;
+		}
+	}
+
+	printf("OK: %u power cuts, %u saves, %u programmed words, %u erased sectors\n",
+			cuts, saves, programmedWords, erasedSectors);
+	return 0;
+}
@@ -0,0 +1,39 @@
+#!/bin/sh
+#
+# hostTest.sh
+#
+#  Created on: 18 paz 2026
+#
+# Builds a host test (the firmware module is included by the test source, the RTOS, lwIP
+# and log functions it calls are stubbed by the test) and runs it.
+#
+# Usage (from the repository root):
+#   Tools/hostTests/hostTest.sh Tools/hostTests/webSocketSendTest.c [test arguments]
+
+set -e
+
+SOURCE=$1
+shift
+OUTPUT=${TMPDIR:-/tmp}/$(basename "$SOURCE" .c)
+
+INCLUDES=""
+for dir in Inc IncUser Utilities/Fonts Utilities/CPU cJSON; do
+	INCLUDES="$INCLUDES -I$dir"
+done
+# the vendor headers are not written for a 64 bit host, their warnings are not ours
+for dir in Drivers/BSP/STM32746G-Discovery \
+		Drivers/CMSIS/Device/ST/STM32F7xx/Include Drivers/CMSIS/Include \
+		Drivers/STM32F7xx_HAL_Driver/Inc Drivers/STM32F7xx_HAL_Driver/Inc/Legacy \
+		Middlewares/Third_Party/FreeRTOS/Source/CMSIS_RTOS \
+		Middlewares/Third_Party/FreeRTOS/Source/include \
+		Middlewares/Third_Party/FreeRTOS/Source/portable/GCC/ARM_CM7/r0p1 \
+		Middlewares/Third_Party/LwIP/src/include \
+		Middlewares/Third_Party/LwIP/src/include/lwip \
+		Middlewares/Third_Party/LwIP/system; do
+	INCLUDES="$INCLUDES -isystem $dir"
+done
+
+gcc -std=gnu99 -O2 -Wall -DSTM32F746xx -DUSE_HAL_DRIVER -DARM_MATH_CM7 \
+		-D__FPU_PRESENT=1 '-D__packed=__attribute__((__packed__))' \
+		'-D__weak=__attribute__((weak))' $INCLUDES -o "$OUTPUT" "$SOURCE" $EXTRA_SOURCES -lm
+"$OUTPUT" "$@"
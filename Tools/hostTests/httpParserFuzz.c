@@ -0,0 +1,288 @@
+/*
+ * httpParserFuzz.c
+ *
+ *  Created on: 18 paz 2026
+ *
+ * Host fuzz test and benchmark of the incremental HTTP request parser. Every request of the
+ * corpus (and its random mutations) is parsed once in one piece and then many times split
+ * into random netbufs with random pbuf chains, the way lwIP delivers TCP segments. The
+ * parser state after the split parse must be the same as after the parse in one piece.
+ * The corpus requests also have the expected results (e.g. 431 for the too long
+ * Content-Length value). The benchmark parses a typical browser request.
+ *
+ * Usage (from the repository root):
+ *   Tools/hostTests/hostTest.sh Tools/hostTests/httpParserFuzz.c [iterations] [seed]
+ * Add EXTRA_SOURCES="-fsanitize=address,undefined" to check the memory accesses.
+ */
+
+#include "../../SrcUser/httpRequestParser.c"
+#include "stdio.h"
+#include "stdlib.h"
+#include "time.h"
+
+#define FUZZ_MAX_REQUEST_SIZE 4096
+#define FUZZ_MAX_SEGMENTS 64
+#define BENCHMARK_REQUESTS 200000
+
+/**
+ * @brief Request of the corpus with the expected parse result
+ */
+typedef struct {
+	const char* text;
+	HttpParseStatus status;
+	HttpParseError error;
+} FuzzRequestStr;
+
+static char longValue[HTTP_REQUEST_MAX_HEADER_VALUE_LENGTH + 16];
+static char buffers[2][FUZZ_MAX_REQUEST_SIZE];
+
+static const char browserRequest[] =
+		"GET /spectrum?from=10&to=200&decimation=2 HTTP/1.1\r\n"
+		"Host: 192.168.1.100\r\n"
+		"Connection: keep-alive\r\n"
+		"User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0 Safari/537.36\r\n"
+		"Accept: application/json,text/plain,*/*\r\n"
+		"Referer: http://192.168.1.100/\r\n"
+		"Accept-Encoding: gzip, deflate\r\n"
+		"Accept-Language: pl-PL,pl;q=0.9,en-US;q=0.8,en;q=0.7\r\n"
+		"\r\n";
+
+/**
+ * @brief lwIP netbuf functions working on the test pbuf chains
+ */
+void netbuf_first(struct netbuf* buf) {
+	buf->ptr = buf->p;
+}
+
+s8_t netbuf_next(struct netbuf* buf) {
+	if (buf->ptr->next == NULL)
+		return -1;
+	buf->ptr = buf->ptr->next;
+	return buf->ptr->next == NULL ? 1 : 0;
+}
+
+err_t netbuf_data(struct netbuf* buf, void** dataptr, u16_t* len) {
+	*dataptr = buf->ptr->payload;
+	*len = buf->ptr->len;
+	return ERR_OK;
+}
+
+/**
+ * @brief Parses the request in one piece
+ */
+static HttpParseStatus parseWhole(HttpRequestStr* request, const char* data,
+		uint32_t length) {
+	memset(request, 0, sizeof(HttpRequestStr));
+	httpRequestParserInit(request);
+	return httpRequestParserFeed(request, data, length);
+}
+
+/**
+ * @brief Parses the request split into random netbufs (each one with random pbuf chain)
+ */
+static HttpParseStatus parseSplit(HttpRequestStr* request, const char* data,
+		uint32_t length) {
+	HttpParseStatus status = HTTP_PARSE_INCOMPLETE;
+	struct pbuf segments[FUZZ_MAX_SEGMENTS];
+	struct netbuf buf;
+	uint32_t position = 0;
+	uint32_t count, i;
+
+	memset(request, 0, sizeof(HttpRequestStr));
+	httpRequestParserInit(request);
+	while (status == HTTP_PARSE_INCOMPLETE && position < length) {
+		count = 1 + rand() % 4;
+		for (i = 0; i < count && position < length; i++) {
+			// mostly short segments, sometimes a full TCP segment
+			uint32_t segmentLength =
+					rand() % 8 == 0 ? 1460 : 1 + rand() % 16;
+			if (segmentLength > length - position)
+				segmentLength = length - position;
+			segments[i].payload = (void*) &data[position];
+			segments[i].len = segmentLength;
+			segments[i].next = NULL;
+			if (i > 0)
+				segments[i - 1].next = &segments[i];
+			position += segmentLength;
+		}
+		buf.p = &segments[0];
+		status = httpRequestParserFeedNetbuf(request, &buf);
+	}
+	return status;
+}
+
+/**
+ * @brief Compares the split parse with the parse in one piece
+ * @retval returns 0 if the results differ
+ */
+static uint8_t checkSplits(const char* data, uint32_t length,
+		uint32_t splits) {
+	static HttpRequestStr whole;
+	static HttpRequestStr split;
+	HttpParseStatus wholeStatus = parseWhole(&whole, data, length);
+	uint32_t i;
+
+	for (i = 0; i < splits; i++) {
+		if (parseSplit(&split, data, length) != wholeStatus
+				|| memcmp(&whole, &split, sizeof(HttpRequestStr)) != 0) {
+			printf("split parse differs (state %u/%u, error %u/%u):\n%.*s\n",
+					split.state, whole.state, split.error, whole.error,
+					(int) length, data);
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/**
+ * @brief Changes, inserts or removes random bytes of the request
+ * @retval returns the new length
+ */
+static uint32_t mutate(char* data, uint32_t length) {
+	static const char special[] = { '\r', '\n', ' ', ':', '?', '\t', '0', '\0' };
+	uint32_t changes = 1 + rand() % 4;
+	uint32_t position;
+
+	while (changes-- > 0 && length > 1) {
+		position = rand() % length;
+		switch (rand() % 3) {
+		case 0:
+			data[position] =
+					rand() % 2 ?
+							special[rand() % sizeof(special)] : (char) rand();
+			break;
+		case 1:
+			if (length < FUZZ_MAX_REQUEST_SIZE) {
+				memmove(&data[position + 1], &data[position], length - position);
+				data[position] = special[rand() % sizeof(special)];
+				length++;
+			}
+			break;
+		default:
+			memmove(&data[position], &data[position + 1], length - position - 1);
+			length--;
+			break;
+		}
+	}
+	return length;
+}
+
+/**
+ * @brief Prepares the corpus requests which are built at runtime
+ */
+static void prepareCorpus(FuzzRequestStr* corpus, uint32_t* count) {
+	static char longContentLength[256];
+	static char longUserAgent[256];
+	static char longBody[HTTP_REQUEST_MAX_BODY_SIZE + 128];
+	static char tooLargeHeader[HTTP_REQUEST_MAX_HEADER_SIZE + 128];
+	uint32_t i;
+
+	// "1" followed by zeros, a truncated copy would be a valid number
+	memset(longValue, '0', sizeof(longValue) - 1);
+	longValue[0] = '1';
+	sprintf(longContentLength, "PUT /config HTTP/1.1\r\nContent-Length: %s\r\n\r\n",
+			longValue);
+	corpus[*count].text = longContentLength;
+	corpus[*count].status = HTTP_PARSE_ERROR;
+	corpus[(*count)++].error = HTTP_PARSE_ERROR_HEADER_TOO_LARGE;
+
+	for (i = 0; i < sizeof(longValue) - 1; i++)
+		longValue[i] = 'a' + i % 26;
+	sprintf(longUserAgent, "GET / HTTP/1.1\r\nUser-Agent: %s\r\n\r\n", longValue);
+	corpus[*count].text = longUserAgent;
+	corpus[*count].status = HTTP_PARSE_DONE;
+	corpus[(*count)++].error = HTTP_PARSE_ERROR_NONE;
+
+	sprintf(longBody, "PUT /config HTTP/1.1\r\nContent-Length: %u\r\n\r\n",
+	HTTP_REQUEST_MAX_BODY_SIZE + 1);
+	memset(&longBody[strlen(longBody)], 'x', HTTP_REQUEST_MAX_BODY_SIZE + 1);
+	corpus[*count].text = longBody;
+	corpus[*count].status = HTTP_PARSE_ERROR;
+	corpus[(*count)++].error = HTTP_PARSE_ERROR_BODY_TOO_LARGE;
+
+	strcpy(tooLargeHeader, "GET / HTTP/1.1\r\n");
+	while (strlen(tooLargeHeader) < HTTP_REQUEST_MAX_HEADER_SIZE)
+		strcat(tooLargeHeader, "X-Padding: 0123456789\r\n");
+	strcat(tooLargeHeader, "\r\n");
+	corpus[*count].text = tooLargeHeader;
+	corpus[*count].status = HTTP_PARSE_ERROR;
+	corpus[(*count)++].error = HTTP_PARSE_ERROR_HEADER_TOO_LARGE;
+}
+
+static FuzzRequestStr corpus[32] = {
+	{ browserRequest, HTTP_PARSE_DONE, HTTP_PARSE_ERROR_NONE },
+	{ "GET / HTTP/1.1\r\n\r\n", HTTP_PARSE_DONE, HTTP_PARSE_ERROR_NONE },
+	{ "GET /config HTTP/1.0\n\n", HTTP_PARSE_DONE, HTTP_PARSE_ERROR_NONE },
+	{ "PUT /config HTTP/1.1\r\nContent-Type: application/json\r\n"
+			"Content-Length: 46\r\n\r\n"
+			"{\"audioSamplingFrequency\":44100,\"lcdView\":1}\r\n",
+			HTTP_PARSE_DONE, HTTP_PARSE_ERROR_NONE },
+	{ "GET /ws HTTP/1.1\r\nHost: stm\r\nUpgrade: websocket\r\n"
+			"Connection: Upgrade\r\nSec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+			"Sec-WebSocket-Version: 13\r\n\r\n", HTTP_PARSE_DONE,
+			HTTP_PARSE_ERROR_NONE },
+	{ "PUT /config HTTP/1.1\r\nContent-Length: 12x\r\n\r\n", HTTP_PARSE_ERROR,
+			HTTP_PARSE_ERROR_BAD_REQUEST },
+	{ "GET /0123456789012345678901234567890123456789 HTTP/1.1\r\n\r\n",
+			HTTP_PARSE_ERROR, HTTP_PARSE_ERROR_URI_TOO_LONG },
+	{ " / HTTP/1.1\r\n\r\n", HTTP_PARSE_ERROR, HTTP_PARSE_ERROR_BAD_REQUEST },
+	{ "GET / HTTP/1.1\r\nHost: stm\r\n", HTTP_PARSE_INCOMPLETE,
+			HTTP_PARSE_ERROR_NONE },
+	{ "PUT /config HTTP/1.1\r\nContent-Length: 10\r\n\r\n{\"a\"",
+			HTTP_PARSE_INCOMPLETE, HTTP_PARSE_ERROR_NONE },
+};
+
+int main(int argc, char** argv) {
+	uint32_t iterations = argc > 1 ? strtoul(argv[1], NULL, 0) : 20000;
+	uint32_t seed = argc > 2 ? strtoul(argv[2], NULL, 0) : 1;
+	static HttpRequestStr request;
+	struct timespec start, end;
+	uint32_t count = 10;
+	uint32_t length, i;
+	double nanoseconds;
+
+	srand(seed);
+	prepareCorpus(corpus, &count);
+
+	for (i = 0; i < count; i++) {
+		length = strlen(corpus[i].text);
+		if (parseWhole(&request, corpus[i].text, length) != corpus[i].status
+				|| request.error != corpus[i].error) {
+			printf("unexpected result (state %u, error %u):\n%s\n",
+					request.state, request.error, corpus[i].text);
+			return 1;
+		}
+		if (!checkSplits(corpus[i].text, length, 1000))
+			return 1;
+	}
+
+	for (i = 0; i < iterations; i++) {
+		const char* text = corpus[rand() % count].text;
+		length = strlen(text);
+		if (length > FUZZ_MAX_REQUEST_SIZE)
+			length = FUZZ_MAX_REQUEST_SIZE;
+		memcpy(buffers[0], text, length);
+		length = mutate(buffers[0], length);
+		// the parser must not read the data behind the given length
+		memcpy(buffers[1], buffers[0], length);
+		if (!checkSplits(buffers[1], length, 20))
+			return 1;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < BENCHMARK_REQUESTS; i++) {
+		httpRequestParserInit(&request);
+		if (httpRequestParserFeed(&request, browserRequest,
+				sizeof(browserRequest) - 1) != HTTP_PARSE_DONE)
+			return 1;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	nanoseconds = (end.tv_sec - start.tv_sec) * 1e9
+			+ (end.tv_nsec - start.tv_nsec);
+
+	printf("OK: %u corpus requests, %u mutated requests\n", count, iterations);
+	printf("benchmark: %u byte request parsed in %.0f ns (%.1f MB/s)\n",
+			(uint32_t) sizeof(browserRequest) - 1, nanoseconds / BENCHMARK_REQUESTS,
+			(sizeof(browserRequest) - 1) * BENCHMARK_REQUESTS * 1e3 / nanoseconds);
+	return 0;
+}
@@ -0,0 +1,170 @@
+/*
+ * jsonParserBench.c
+ *
+ *  Created on: 18 paz 2026
+ *
+ * Host benchmark of the PUT /config body parsing: the schema parser used by parseJSON
+ * against the cJSON path it replaced (cJSON_Parse, cJSON_GetObjectItem for every field and
+ * cJSON_Delete, as in the removed parseJSON). Both parse the same bodies, the results are
+ * compared and the heap allocations of cJSON are counted.
+ *
+ * Usage (from the repository root):
+ *   EXTRA_SOURCES="SrcUser/jsonSchemaParser.c cJSON/cJSON.c" \
+ *   Tools/hostTests/hostTest.sh Tools/hostTests/jsonParserBench.c [iterations]
+ */
+
+#include "../../SrcUser/jsonConfiguration.c"
+#include "cJSON.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "time.h"
+
+static uint32_t allocations;
+
+/**
+ * @brief Bodies of PUT /config (the first one has the 5 fields known to the cJSON path)
+ */
+static const char* bodies[] = {
+		"{\"UdpEndpointIP\":\"192.168.1.10\",\"AmplitudeSamplingDelay\":10,"
+				"\"SamplingFrequency\":44100,\"UdpEndpointPort\":53426,"
+				"\"WindowType\":\"HANN\"}",
+		"{\"UdpEndpointIP\":\"192.168.1.10\",\"AmplitudeSamplingDelay\":10,"
+				"\"SamplingFrequency\":44100,\"UdpEndpointPort\":53426,"
+				"\"WindowType\":\"FLAT_TOP\",\"LcdView\":\"WATERFALL\","
+				"\"SyslogIP\":\"192.168.1.20\",\"SyslogPort\":514,"
+				"\"StreamContent\":\"BANDS\",\"LeqPeriod\":1000,"
+				"\"SpectrumScale\":\"DB\"}" };
+
+void logMsg(char* msg) {
+}
+
+void logErr(char* msg) {
+}
+
+void logMsgVal(char* msg, int val) {
+}
+
+void logErrVal(char* msg, int val) {
+}
+
+/* makeChanges() dependencies (not used by the benchmark) */
+uint8_t audioRecorderSwitchSamplingFrequency(uint32_t frequency) {
+	return 0;
+}
+
+uint8_t audioRecorderSetSamplingFrequency(uint32_t frequency) {
+	return 0;
+}
+
+void levelMeterSetLeqPeriod(uint32_t period) {
+}
+
+/* stmConfigToString() dependencies (not used by the benchmark) */
+void jsonWriterInit(JsonWriterStr* writer, char* buffer, uint32_t size) {
+}
+
+void jsonWriterSchemaObject(JsonWriterStr* writer,
+		const JsonSchemaFieldStr* schema, uint32_t fieldCount,
+		const void* source) {
+}
+
+uint8_t jsonWriterFinish(JsonWriterStr* writer) {
+	return 0;
+}
+
+static void* countingMalloc(size_t size) {
+	allocations++;
+	return malloc(size);
+}
+
+/**
+ * @brief The removed cJSON implementation of parseJSON (only the fields it knew)
+ */
+static uint8_t parseCjson(char* jsonData, StmConfig* config) {
+	cJSON* parser;
+	cJSON* item;
+
+	memset(config, 0, sizeof(StmConfig));
+	parser = cJSON_Parse(jsonData);
+	if (!parser)
+		return 0;
+
+	if ((item = cJSON_GetObjectItem(parser, "UdpEndpointIP")) != NULL)
+		strcpy(config->clientIp, item->valuestring);
+	if ((item = cJSON_GetObjectItem(parser, "AmplitudeSamplingDelay")) != NULL)
+		config->amplitudeSamplingDelay = item->valueint;
+	if ((item = cJSON_GetObjectItem(parser, "SamplingFrequency")) != NULL)
+		config->audioSamplingFrequency = item->valueint;
+	if ((item = cJSON_GetObjectItem(parser, "UdpEndpointPort")) != NULL)
+		config->clientPort = item->valueint;
+	if ((item = cJSON_GetObjectItem(parser, "WindowType")) != NULL) {
+		if (strcmp(item->valuestring, "RECTANGLE") == 0)
+			config->windowType = RECTANGLE;
+		else if (strcmp(item->valuestring, "HANN") == 0)
+			config->windowType = HANN;
+		else if (strcmp(item->valuestring, "FLAT_TOP") == 0)
+			config->windowType = FLAT_TOP;
+	}
+
+	cJSON_Delete(parser);
+	return 1;
+}
+
+/**
+ * @brief Gets the time elapsed from \p start
+ * @retval time [ns]
+ */
+static double elapsedNs(struct timespec* start) {
+	struct timespec end;
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	return (end.tv_sec - start->tv_sec) * 1e9 + (end.tv_nsec - start->tv_nsec);
+}
+
+int main(int argc, char** argv) {
+	uint32_t iterations = argc > 1 ? strtoul(argv[1], NULL, 0) : 200000;
+	cJSON_Hooks hooks = { countingMalloc, free };
+	static char body[512];
+	JsonSchemaResultStr result;
+	StmConfig schemaConfig;
+	StmConfig cjsonConfig;
+	struct timespec start;
+	double schemaNs, cjsonNs;
+	uint32_t bodyIndex, i;
+
+	cJSON_InitHooks(&hooks);
+	for (bodyIndex = 0; bodyIndex < sizeof(bodies) / sizeof(bodies[0]);
+			bodyIndex++) {
+		strcpy(body, bodies[bodyIndex]);
+
+		// both paths have to give the same values of the fields known to cJSON path
+		if (!parseJSON(body, &schemaConfig, &result)
+				|| !parseCjson(body, &cjsonConfig)
+				|| strcmp(schemaConfig.clientIp, cjsonConfig.clientIp) != 0
+				|| schemaConfig.amplitudeSamplingDelay
+						!= cjsonConfig.amplitudeSamplingDelay
+				|| schemaConfig.audioSamplingFrequency
+						!= cjsonConfig.audioSamplingFrequency
+				|| schemaConfig.clientPort != cjsonConfig.clientPort
+				|| schemaConfig.windowType != cjsonConfig.windowType) {
+			printf("parsers differ on body %u\n", bodyIndex);
+			return 1;
+		}
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (i = 0; i < iterations; i++)
+			parseJSON(body, &schemaConfig, &result);
+		schemaNs = elapsedNs(&start) / iterations;
+
+		allocations = 0;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for (i = 0; i < iterations; i++)
+			parseCjson(body, &cjsonConfig);
+		cjsonNs = elapsedNs(&start) / iterations;
+
+		printf("body %u (%u bytes): schema parser %.0f ns, cJSON %.0f ns "
+				"(%u allocations per parse)\n", bodyIndex, (uint32_t) strlen(body),
+				schemaNs, cjsonNs, allocations / iterations);
+	}
+	return 0;
+}
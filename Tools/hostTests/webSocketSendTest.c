@@ -0,0 +1,273 @@
+/*
+ * webSocketSendTest.c
+ *
+ *  Created on: 18 paz 2026
+ *
+ * Host test of the WebSocket send path. The stubbed netconn_write_partly accepts a random
+ * part of every write (like the non-blocking lwIP write with a small send buffer) and the
+ * client pings at random moments. The bytes "sent" to the client are then parsed as
+ * WebSocket frames: every spectrum frame and pong must arrive complete and not interleaved.
+ * At the end the client sends close, which has to remove it without a blocking write.
+ *
+ * Usage (from the repository root):
+ *   Tools/hostTests/hostTest.sh Tools/hostTests/webSocketSendTest.c [passes] [seed]
+ */
+
+#include "../../SrcUser/webSocketServer.c"
+#include "stdio.h"
+#include "stdlib.h"
+#include "sys/mman.h"
+
+#define TEST_STREAM_SIZE (64 * 1024 * 1024)
+
+osMessageQId webSocketClient_q_id = (osMessageQId) 1;
+SpectrumSnapshotStr mainSpectrumSnapshot;
+sys_mutex_t lock_tcpip_core;
+
+static struct netconn* testConn;
+static struct tcp_pcb testPcb;
+static uint8_t* stream;
+static uint32_t streamLength;
+static uint32_t frameNumber;
+static uint32_t pingsSent;
+static struct netbuf pingBuf;
+static uint8_t connectionPending;
+static uint32_t coreLocked;
+static uint32_t lockedWrites;
+static uint32_t blockingWrites;
+static uint8_t closeSent;
+static uint8_t clientRemoved;
+
+void sys_mutex_lock(sys_mutex_t* mutex) {
+	coreLocked++;
+}
+
+void sys_mutex_unlock(sys_mutex_t* mutex) {
+	coreLocked--;
+}
+
+osStatus osMessagePut(osMessageQId queue_id, uint32_t info, uint32_t millisec) {
+	connectionPending = 1;
+	return osOK;
+}
+
+osEvent osMessageGet(osMessageQId queue_id, uint32_t millisec) {
+	osEvent event;
+
+	event.status = connectionPending ? osEventMessage : osOK;
+	event.value.v = (uint32_t) (uintptr_t) testConn;
+	connectionPending = 0;
+	return event;
+}
+
+uint8_t spectrumSnapshotRead(SpectrumSnapshotStr* snapshot,
+		float32_t* destination, uint32_t from, uint32_t to,
+		uint32_t decimation, SpectrumSnapshotInfoStr* info) {
+	uint32_t i;
+
+	memset(info, 0, sizeof(SpectrumSnapshotInfoStr));
+	info->frameNumber = ++frameNumber;
+	info->count = 1 + rand() % (to - from);
+	for (i = 0; i < info->count; i++)
+		destination[i] = (float32_t) (frameNumber + i);
+	return 1;
+}
+
+err_t netconn_write_partly(struct netconn* conn, const void* dataptr,
+		size_t size, u8_t apiflags, size_t* bytes_written) {
+	size_t accepted;
+
+	if ((apiflags & NETCONN_DONTBLOCK) && bytes_written == NULL)
+		return ERR_VAL;
+	if (coreLocked)
+		lockedWrites++;
+	if (!(apiflags & NETCONN_DONTBLOCK))
+		blockingWrites++;
+
+	accepted = size;
+	if (apiflags & NETCONN_DONTBLOCK) {
+		switch (rand() % 4) {
+		case 0:
+			return ERR_WOULDBLOCK;
+		case 1:
+			accepted = rand() % size;
+			break;
+		default:
+			break;
+		}
+		*bytes_written = accepted;
+	}
+	if (streamLength + accepted > TEST_STREAM_SIZE) {
+		printf("stream buffer overflow\n");
+		exit(1);
+	}
+	memcpy(&stream[streamLength], dataptr, accepted);
+	streamLength += accepted;
+	return ERR_OK;
+}
+
+err_t netconn_recv(struct netconn* conn, struct netbuf** new_buf) {
+	if (rand() % 8 != 0)
+		return ERR_TIMEOUT;
+	*new_buf = &pingBuf;
+	return ERR_OK;
+}
+
+u16_t pbuf_copy_partial(struct pbuf* buf, void* dataptr, u16_t len,
+		u16_t offset) {
+	// masked ping with 4 byte payload (the ping counter) or masked close without payload
+	uint8_t* frame = (uint8_t*) dataptr;
+	uint32_t i;
+
+	if (closeSent) {
+		frame[0] = 0x80 | WEBSOCKET_OPCODE_CLOSE;
+		frame[1] = 0x80;
+		for (i = 0; i < 4; i++)
+			frame[2 + i] = (uint8_t) rand();
+		return 6;
+	}
+	frame[0] = 0x80 | WEBSOCKET_OPCODE_PING;
+	frame[1] = 0x80 | 4;
+	for (i = 0; i < 4; i++) {
+		frame[2 + i] = (uint8_t) rand();
+		frame[6 + i] = (uint8_t) (pingsSent >> (8 * i)) ^ frame[2 + i];
+	}
+	pingsSent++;
+	return 10;
+}
+
+void netbuf_delete(struct netbuf* buf) {
+}
+
+err_t netconn_close(struct netconn* conn) {
+	return ERR_OK;
+}
+
+err_t netconn_delete(struct netconn* conn) {
+	if (!closeSent) {
+		printf("client removed\n");
+		exit(1);
+	}
+	clientRemoved = 1;
+	return ERR_OK;
+}
+
+void logMsg(char* msg) {
+}
+
+void logErr(char* msg) {
+	printf("%s\n", msg);
+}
+
+void logMsgVal(char* msg, int val) {
+}
+
+void logErrVal(char* msg, int val) {
+	printf("%s%d\n", msg, val);
+}
+
+void printNullHandle(char* taskName) {
+}
+
+/**
+ * @brief Parses the bytes received by the client
+ * @retval returns 0 if the stream is broken
+ */
+static uint8_t checkStream(uint32_t* spectrumFrames, uint32_t* pongs) {
+	uint32_t position = 0;
+	uint32_t lastFrameNumber = 0;
+	uint32_t payloadLength;
+	uint32_t i;
+	SpectrumSnapshotInfoStr info;
+	float32_t bin;
+
+	*spectrumFrames = 0;
+	*pongs = 0;
+	while (position < streamLength) {
+		if (streamLength - position < 2)
+			return 0;
+		if (stream[position] == (0x80 | WEBSOCKET_OPCODE_BINARY)) {
+			if (stream[position + 1] != 126)
+				return 0;
+			payloadLength = (stream[position + 2] << 8) | stream[position + 3];
+			if (position + 4 + payloadLength > streamLength
+					|| payloadLength < sizeof(info))
+				return 0;
+			memcpy(&info, &stream[position + 4], sizeof(info));
+			if (info.frameNumber <= lastFrameNumber
+					|| payloadLength != sizeof(info) + info.count * sizeof(float32_t))
+				return 0;
+			for (i = 0; i < info.count; i++) {
+				memcpy(&bin, &stream[position + 4 + sizeof(info) + i * 4], 4);
+				if (bin != (float32_t) (info.frameNumber + i))
+					return 0;
+			}
+			lastFrameNumber = info.frameNumber;
+			(*spectrumFrames)++;
+			position += 4 + payloadLength;
+		} else if (stream[position] == (0x80 | WEBSOCKET_OPCODE_PONG)) {
+			if (stream[position + 1] != 4 || position + 6 > streamLength)
+				return 0;
+			for (i = 0; i < 4; i++) {
+				if (stream[position + 2 + i] != (uint8_t) (*pongs >> (8 * i)))
+					return 0;
+			}
+			(*pongs)++;
+			position += 6;
+		} else {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+int main(int argc, char** argv) {
+	uint32_t passes = argc > 1 ? strtoul(argv[1], NULL, 0) : 100000;
+	uint32_t seed = argc > 2 ? strtoul(argv[2], NULL, 0) : 1;
+	uint32_t spectrumFrames, pongs;
+	uint32_t i;
+
+	srand(seed);
+	stream = malloc(TEST_STREAM_SIZE);
+	// the connection is passed through the message queue as 32 bit value
+	testConn = mmap(NULL, sizeof(struct netconn), PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+	testConn->type = NETCONN_TCP;
+	testConn->pcb.tcp = &testPcb;
+
+	webSocketServerAddClient(testConn);
+	for (i = 0; i < passes; i++) {
+		testPcb.snd_queuelen = rand() % 8 == 0 ? TCP_SND_QUEUELEN : 0;
+		webSocketServerProcess(rand() % 2);
+	}
+	// let the last pending frame go
+	for (i = 0; i < 64 && webSocketClients[0].pendingLength != 0; i++)
+		flushPendingFrame(&webSocketClients[0]);
+
+	if (!checkStream(&spectrumFrames, &pongs)) {
+		printf("broken stream\n");
+		return 1;
+	}
+	if (lockedWrites != 0) {
+		printf("netconn written with the core lock held\n");
+		return 1;
+	}
+	if (spectrumFrames != webSocketClients[0].sentFrames || pongs != pingsSent) {
+		printf("missing frames: spectrum %u/%u, pong %u/%u\n", spectrumFrames,
+				webSocketClients[0].sentFrames, pongs, pingsSent);
+		return 1;
+	}
+
+	// the client closes the connection
+	closeSent = 1;
+	for (i = 0; i < 1000 && !clientRemoved; i++)
+		webSocketServerProcess(0);
+	if (!clientRemoved || blockingWrites != 0) {
+		printf("close not handled without blocking\n");
+		return 1;
+	}
+	printf("OK: %u bytes, %u spectrum frames (%u dropped), %u pongs\n",
+			streamLength, spectrumFrames, webSocketClients[0].droppedFrames,
+			pongs);
+	return 0;
+}
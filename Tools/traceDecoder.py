@@ -0,0 +1,209 @@
+#!/usr/bin/env python3
+#
+# traceDecoder.py
+#
+#  Created on: 18 paz 2026
+#
+# Converts the binary event trace downloaded from GET /trace to Chrome trace event JSON
+# (it can be opened in chrome://tracing or https://ui.perfetto.dev).
+#
+# Usage:
+#   curl -o trace.bin http://<device ip>/trace
+#   python3 traceDecoder.py trace.bin trace.json
+
+import json
+import struct
+import sys
+
+TRACE_RECORDER_MAGIC = 0x544D5453
+TRACE_RECORDER_FORMAT = 1
+
+HEADER = struct.Struct("<IHHIIII")
+OBJECT = struct.Struct("<IHBB16s")
+EVENT = struct.Struct("<IBBHI")
+
+# TraceEventType
+TASK_SWITCHED_IN = 1
+TASK_SWITCHED_OUT = 2
+ISR_ENTER = 3
+ISR_EXIT = 4
+QUEUE_SEND = 5
+QUEUE_SEND_FAILED = 6
+QUEUE_RECEIVE = 7
+QUEUE_RECEIVE_FAILED = 8
+QUEUE_BLOCK_SEND = 9
+QUEUE_BLOCK_RECEIVE = 10
+
+# TraceObjectKind
+OBJECT_TASK = 0
+OBJECT_QUEUE = 1
+
+# FreeRTOS queue types (ucQueueType)
+QUEUE_TYPE_NAMES = {0: "queue", 1: "mutex", 2: "counting semaphore",
+                    3: "binary semaphore", 4: "recursive mutex"}
+MUTEX_TYPES = (1, 4)
+
+# exception numbers of the handlers which write the trace (IRQ number + 16)
+EXCEPTION_NAMES = {15: "SysTick", 41: "TIM1_UP_TIM10", 42: "TIM1_TRG_COM_TIM11",
+                   77: "ETH", 86: "AUDIO_IN_DMA", 104: "LTDC"}
+
+TASKS_PID = 1
+INTERRUPTS_PID = 2
+
+
+def readTrace(data):
+    """Splits the download to header, named objects and events."""
+    magic, fmt, eventSize, cpuFrequency, objectCount, eventCount, lostEvents = \
+        HEADER.unpack_from(data, 0)
+    if magic != TRACE_RECORDER_MAGIC or fmt != TRACE_RECORDER_FORMAT:
+        raise ValueError("not a trace (magic %08X, format %d)" % (magic, fmt))
+    if eventSize != EVENT.size:
+        raise ValueError("unknown event size %d" % eventSize)
+
+    offset = HEADER.size
+    objects = []
+    for _ in range(objectCount):
+        address, objectId, kind, _, name = OBJECT.unpack_from(data, offset)
+        objects.append((kind, address, objectId, name.split(b"\0")[0].decode("latin-1")))
+        offset += OBJECT.size
+
+    events = []
+    for _ in range(eventCount):
+        events.append(EVENT.unpack_from(data, offset))
+        offset += EVENT.size
+
+    return cpuFrequency, lostEvents, objects, events
+
+
+def unwrapTimestamps(events):
+    """Converts 32-bit cycle counter values to continuous values. Events written by nested
+    interrupts may be a few cycles older than the previous one, so the difference is signed."""
+    cycles = 0
+    previous = None
+    for timestamp, eventType, _, eventId, address in events:
+        if previous is not None:
+            delta = (timestamp - previous) & 0xFFFFFFFF
+            if delta >= 0x80000000:
+                delta -= 0x100000000
+            cycles += delta
+        previous = timestamp
+        yield cycles, eventType, eventId, address
+
+
+def convert(data):
+    cpuFrequency, lostEvents, objects, events = readTrace(data)
+    taskNames = {}
+    queueNames = {}
+    for kind, address, objectId, name in objects:
+        if kind == OBJECT_TASK:
+            taskNames[objectId] = name
+        elif kind == OBJECT_QUEUE:
+            queueNames[address] = name
+
+    def toUs(cycles):
+        return cycles * 1e6 / cpuFrequency
+
+    def queueName(address, queueType):
+        name = queueNames.get(address)
+        if name:
+            return name
+        return "%s 0x%08X" % (QUEUE_TYPE_NAMES.get(queueType, "queue"), address)
+
+    output = []
+    runningTask = None
+    taskStart = {}
+    isrStack = []
+    isrStart = {}
+    waits = {}
+    waitId = 0
+
+    for cycles, eventType, eventId, address in unwrapTimestamps(events):
+        ts = toUs(cycles)
+
+        if eventType == TASK_SWITCHED_IN:
+            runningTask = eventId
+            taskStart[eventId] = ts
+        elif eventType == TASK_SWITCHED_OUT:
+            if eventId in taskStart:
+                start = taskStart.pop(eventId)
+                output.append({"name": taskNames.get(eventId, "task %d" % eventId),
+                               "ph": "X", "pid": TASKS_PID, "tid": eventId,
+                               "ts": start, "dur": ts - start})
+            runningTask = None
+        elif eventType == ISR_ENTER:
+            isrStack.append(eventId)
+            isrStart.setdefault(eventId, []).append(ts)
+        elif eventType == ISR_EXIT:
+            if isrStack and isrStack[-1] == eventId:
+                isrStack.pop()
+            if isrStart.get(eventId):
+                start = isrStart[eventId].pop()
+                output.append({"name": EXCEPTION_NAMES.get(eventId, "IRQ %d" % (eventId - 16)),
+                               "ph": "X", "pid": INTERRUPTS_PID, "tid": eventId,
+                               "ts": start, "dur": ts - start})
+        else:
+            # queue operations are shown on the interrupt or task which made them
+            if isrStack:
+                pid, tid = INTERRUPTS_PID, isrStack[-1]
+            elif runningTask is not None:
+                pid, tid = TASKS_PID, runningTask
+            else:
+                continue
+            name = queueName(address, eventId)
+            isMutex = eventId in MUTEX_TYPES
+
+            if eventType in (QUEUE_BLOCK_SEND, QUEUE_BLOCK_RECEIVE):
+                waitId += 1
+                waits[(tid, address)] = waitId
+                output.append({"name": "wait " + name, "cat": "wait", "ph": "b",
+                               "id": waitId, "pid": pid, "tid": tid, "ts": ts})
+                continue
+
+            if (tid, address) in waits:
+                output.append({"name": "wait " + name, "cat": "wait", "ph": "e",
+                               "id": waits.pop((tid, address)), "pid": pid, "tid": tid,
+                               "ts": ts})
+
+            operation = {QUEUE_SEND: "give" if isMutex else "send",
+                         QUEUE_SEND_FAILED: "give failed" if isMutex else "send failed",
+                         QUEUE_RECEIVE: "take" if isMutex else "receive",
+                         QUEUE_RECEIVE_FAILED: "take timeout" if isMutex else "receive timeout"
+                         }.get(eventType)
+            if operation is None:
+                continue
+            output.append({"name": "%s %s" % (operation, name), "cat": "queue", "ph": "i",
+                           "s": "t", "pid": pid, "tid": tid, "ts": ts})
+
+    output.append({"name": "process_name", "ph": "M", "pid": TASKS_PID,
+                   "args": {"name": "Tasks"}})
+    output.append({"name": "process_name", "ph": "M", "pid": INTERRUPTS_PID,
+                   "args": {"name": "Interrupts"}})
+    for number, name in taskNames.items():
+        output.append({"name": "thread_name", "ph": "M", "pid": TASKS_PID, "tid": number,
+                       "args": {"name": name}})
+    for number, name in EXCEPTION_NAMES.items():
+        output.append({"name": "thread_name", "ph": "M", "pid": INTERRUPTS_PID,
+                       "tid": number, "args": {"name": name}})
+
+    return {"traceEvents": output, "displayTimeUnit": "ns",
+            "otherData": {"cpuFrequency": cpuFrequency, "events": len(events),
+                          "lostEvents": lostEvents}}
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.stderr.write("usage: %s trace.bin trace.json\n" % sys.argv[0])
+        return 1
+
+    with open(sys.argv[1], "rb") as source:
+        trace = convert(source.read())
+    with open(sys.argv[2], "w") as destination:
+        json.dump(trace, destination)
+
+    other = trace["otherData"]
+    print("%d events (%d lost) -> %s" % (other["events"], other["lostEvents"], sys.argv[2]))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())